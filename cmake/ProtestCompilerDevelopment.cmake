@@ -38,7 +38,7 @@ set(IMPLICIT_INCLUDES
   "${PROTEST_ROOT_PATH}/modules/t3/src"
   "${PROTEST_ROOT_PATH}/modules/core/src"
   "${PROTEST_ROOT_PATH}/modules/coro/src"
-  "${PROTEST_ROOT_PATH}/modules/coro/arch/posix/src"
+  "${PROTEST_ROOT_PATH}/modules/coro/arch/${PROTEST_CORO_ARCH}/src"
   "${PROTEST_ROOT_PATH}/modules/log/src"
   "${PROTEST_ROOT_PATH}/modules/time/src"
   "${PROTEST_ROOT_PATH}/modules/meta/src"
@@ -0,0 +1,10 @@
+# Build options shared by the library build and the test and benchmark
+# applications. Include this file before adding the modules.
+
+# posix:  context switch via ucontext (portable)
+# native: hand-written context switch for x86-64 and AArch64 (no syscalls)
+set(PROTEST_CORO_ARCH "posix" CACHE STRING "Port of the coro module")
+set_property(CACHE PROTEST_CORO_ARCH PROPERTY STRINGS posix native)
+
+# collects scheduler and runner statistics (see coro/statistics.h)
+option(PROTEST_INSTRUMENTATION "Enable the scheduler instrumentation" OFF)
@@ -26,6 +26,8 @@
 #include "protest/core/context.h"
 #include "protest/core/version.h"
 
+#include <cstring>
+
 using namespace protest;
 using namespace protest::core;
 using namespace protest::time;
@@ -45,6 +47,13 @@ Runner::Runner(core::Context& context, const char* name) :
   assert(strlen(name) > 0);
 }
 
+Runner::Runner(core::RunnerGroup& group, const char* name) :
+  RunnerRaw(group, name)
+{
+  assert(strlen(name) <= 4);
+  assert(strlen(name) > 0);
+}
+
 // ---------------------------------------------------------------------------
 protest::log::StreamWrapper
 protest::logger()
@@ -141,6 +150,21 @@ protest::createStopwatch()
 }
 
 // ---------------------------------------------------------------------------
+namespace
+{
+
+int
+nextRandom()
+{
+  // every group has its own random sequence, so the groups do not depend on
+  // each other
+  auto* group = protest::core::RunnerGroup::getCurrentGroup();
+  // NOLINTNEXTLINE
+  return (group != nullptr) ? group->random() : rand();
+}
+
+} // namespace
+
 protest::time::Duration
 protest::random(Duration durationFrom, Duration durationTo)
 {
@@ -151,7 +175,7 @@ protest::random(Duration durationFrom, Duration durationTo)
   // NOLINTNEXTLINE
   static_assert(sizeof(decltype(rand())) == 4U);
   // NOLINTNEXTLINE
-  auto randomDuration = Nanoseconds((((long long) rand() << 32) | rand()) % (diff.nanoseconds() + 1));
+  auto randomDuration = Nanoseconds((((long long) nextRandom() << 32) | nextRandom()) % (diff.nanoseconds() + 1));
   // clang-format on
   return durationFrom + randomDuration;
 }
@@ -169,7 +193,7 @@ protest::coinFlip(float probability)
   PROTEST_ASSERT(probability <= 1.0);
   PROTEST_ASSERT(probability >= 0.0);
   // NOLINTNEXTLINE
-  return ((rand() % promilleFactor) <= probability * promilleFactor);
+  return ((nextRandom() % promilleFactor) <= probability * promilleFactor);
 }
 
 // ---------------------------------------------------------------------------
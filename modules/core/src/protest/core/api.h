@@ -25,10 +25,14 @@
 #pragma once
 
 #include "protest/core/runner_raw.h"
+#include "protest/core/context_pool.h"
+#include "protest/core/link.h"
+#include "protest/core/runner_group.h"
 #include "protest/core/stopwatch.h"
 #include "protest/core/timer.h"
 #include "protest/core/port.h"
 #include "protest/core/invariant.h"
+#include "protest/core/payload.h"
 #include "protest/core/signal.h"
 #include "protest/core/value.h"
 #include "protest/matcher/matcher.h"
@@ -44,15 +48,29 @@ version();
 // ---------------------------------------------------------------------------
 using Context = protest::core::Context;
 
+using ContextPool = protest::core::ContextPool;
+
+using RunnerGroup = protest::core::RunnerGroup;
+
+template <typename T>
+using Link = protest::core::Link<T>;
+
 template <typename T>
 using Signal = protest::core::Signal<T>;
 
+// see Signal::addFilter
+template <typename T>
+using SignalFilter = protest::core::SignalFilterRaw<T>;
+
 template <typename T>
 using SamplePort = protest::core::SamplePort<T>;
 
 template <typename T>
 using QueuePort = protest::core::QueuePort<T>;
 
+template <typename T>
+using Payload = protest::core::Payload<T>;
+
 using Logger = protest::log::Logger;
 
 // ---------------------------------------------------------------------------
@@ -64,6 +82,8 @@ class Runner : public core::RunnerRaw
 public:
   explicit Runner(core::Context& context, const char* name = "none");
 
+  explicit Runner(core::RunnerGroup& group, const char* name = "none");
+
   Runner(const Runner&) = delete;
 
   Runner&
@@ -171,9 +191,15 @@ core::Stopwatch
 createStopwatch();
 
 // ---------------------------------------------------------------------------
+
+using Period = core::Period;
+
 /**
  * @brief Create a Timer
  * 
+ * Pass a Period instead of a timeout to create a periodic timer, e.g.
+ * createTimer(callback, Period(1_ms)).
+ * 
  * @tparam Callback
  *  The type of the callback (auto deducted)
  * 
@@ -187,6 +213,10 @@ core::Timer<Callback>
 createTimer(Callback callback); */
 
 // ---------------------------------------------------------------------------
+using QueueOptions = core::QueueOptions;
+
+using Overflow = core::QueueOptions::Overflow;
+
 /**
  * @brief Create a Port
  * 
@@ -203,6 +233,16 @@ template <typename T>
 core::AnyPortCreator<T>
 createPort(core::Signal<T>& signal);
 
+/**
+ * @brief Create a Port
+ * 
+ * Like createPort(signal) but a queue port gets the capacity and the
+ * overflow policy of `options`.
+ */
+template <typename T>
+core::AnyPortCreator<T>
+createPort(core::Signal<T>& signal, core::QueueOptions options);
+
 // ---------------------------------------------------------------------------
 /**
  * @brief Create a Invariant
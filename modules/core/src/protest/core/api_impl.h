@@ -67,6 +67,18 @@ createTimer(Callback callback,
   return core::Timer<Callback>(runner, callback, timeout, callContext);
 }
 
+template <typename Callback>
+core::Timer<Callback>
+createTimer(Callback callback,
+            core::Period period,
+            protest::meta::CallContext& callContext =
+                protest::meta::CallContext::defaultContext())
+{
+  auto context = core::Context::getCurrentContext();
+  auto runner = context->getCurrentVirtual();
+  return core::Timer<Callback>(runner, callback, period, callContext);
+}
+
 // ---------------------------------------------------------------------------
 template <typename T>
 core::AnyPortCreator<T>
@@ -77,6 +89,15 @@ createPort(protest::core::Signal<T>& signal)
   return core::AnyPortCreator<T>(signal, runner);
 }
 
+template <typename T>
+core::AnyPortCreator<T>
+createPort(protest::core::Signal<T>& signal, core::QueueOptions options)
+{
+  auto context = core::Context::getCurrentContext();
+  auto runner = context->getCurrentVirtual();
+  return core::AnyPortCreator<T>(signal, runner, options);
+}
+
 // ---------------------------------------------------------------------------
 template <typename Expr>
 core::Invariant
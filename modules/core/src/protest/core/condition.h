@@ -177,7 +177,7 @@ template <typename Expr>
 void
 ExprCondition<Expr>::conditionEnable()
 {
-  mExpr.conditionEnable(getOwner(), this);
+  mExpr.conditionEnable(getOwner(), this, nullptr);
 }
 
 template <typename Expr>
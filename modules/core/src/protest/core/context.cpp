@@ -23,9 +23,21 @@
  */
 
 #include "protest/core/context.h"
+#include "protest/core/link_raw.h"
+#include "protest/core/runner_group.h"
 #include "protest/core/runner_raw.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 
 using namespace protest::core;
 using namespace protest::coro;
@@ -33,16 +45,69 @@ using namespace protest::meta;
 
 // ---------------------------------------------------------------------------
 // NOLINTNEXTLINE
-Context* Context::currentContext = nullptr;
+thread_local Context* Context::currentContext = nullptr;
+
+namespace
+{
+
+// the async log is written before the process terminates, e.g. because of
+// a PROTEST_ASSERT nobody caught
+// NOLINTNEXTLINE
+std::atomic<protest::log::AsyncOutput*> terminatingLog(nullptr);
+// NOLINTNEXTLINE
+std::terminate_handler previousTerminate = nullptr;
+
+void
+flushOnTerminate()
+{
+  auto* asyncLog = terminatingLog.exchange(nullptr);
+  if (asyncLog != nullptr)
+  {
+    asyncLog->waitUntilWritten();
+  }
+  else
+  {
+  }
+
+  if (previousTerminate != nullptr)
+  {
+    previousTerminate();
+  }
+  else
+  {
+  }
+  std::abort();
+}
+
+} // namespace
 
 // ---------------------------------------------------------------------------
 Context::Context(protest::meta::CallContext& context) :
   mCallContext(context),
   mCurrentVirtual(nullptr),
+  mLookahead(time::Duration::infinity()),
+  mNumberOfSentMessages(0),
+  mIsParallel(false),
+  mStackMode(StackMode::fixed),
+  mInvariantCoalescing(false),
+  mSyncLog(nullptr),
   mDocManager(*this)
 {
 }
 
+Context::~Context()
+{
+  finishTrace();
+  finishAsyncLog();
+  if (currentContext == this)
+  {
+    currentContext = nullptr;
+  }
+  else
+  {
+  }
+}
+
 // ---------------------------------------------------------------------------
 Context*
 Context::getCurrentContext()
@@ -62,8 +127,17 @@ Context::getCurrentLogger()
 RunnerRaw*
 Context::getCurrent()
 {
+  coro::Scheduler* scheduler = this;
+  auto* group = RunnerGroup::getCurrentGroup();
+  if (group != nullptr)
+  {
+    scheduler = group;
+  }
+  else
+  {
+  }
   auto* current =
-      (dynamic_cast<protest::core::RunnerRaw*>(coro::Scheduler::getCurrent()));
+      (dynamic_cast<protest::core::RunnerRaw*>(scheduler->getCurrent()));
   PROTEST_ASSERT(current);
   return current;
 }
@@ -80,13 +154,74 @@ void
 Context::initialize(int argc, const char** argv)
 {
   mJsonParser.parse(std::string(argv[0]) + ".json");
+  mStatisticsFileName = std::string(argv[0]) + ".statistics.json";
+  mStackFileName = std::string(argv[0]) + ".stacks";
   currentContext = this;
   mTestManager.initialize();
+
+  const std::string stackModeArgument = "--stack-mode=";
+  const std::string asyncLogArgument = "--async-log=";
+  const std::string traceArgument = "--trace=";
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string argument = argv[i];
+    const std::string mode = argument.substr(
+        std::min(argument.size(), stackModeArgument.size()));
+    if (argument == "--coalesce-invariants")
+    {
+      setInvariantCoalescing(true);
+    }
+    else if (argument == "--async-log")
+    {
+      setAsyncLog();
+    }
+    else if (argument.rfind(asyncLogArgument, 0) == 0)
+    {
+      setAsyncLog(argument.substr(asyncLogArgument.size()));
+    }
+    else if (argument.rfind(traceArgument, 0) == 0)
+    {
+      setTrace(argument.substr(traceArgument.size()));
+    }
+    else if (argument.rfind(stackModeArgument, 0) != 0)
+    {
+      // not for the context
+    }
+    else if (mode == "measure")
+    {
+      setStackMode(StackMode::measure);
+    }
+    else if (mode == "adapt")
+    {
+      setStackMode(StackMode::adapt);
+    }
+    else if (mode == "fixed")
+    {
+      setStackMode(StackMode::fixed);
+    }
+    else
+    {
+      std::cerr << "invalid argument '" << argument
+                << "', expected --stack-mode=fixed|measure|adapt" << std::endl;
+      PROTEST_ASSERT(false);
+    }
+  }
+
+  if (mStackMode == StackMode::adapt)
+  {
+    // there is no file on the first run
+    std::ifstream file(mStackFileName);
+    readStackSizes(file);
+  }
+  else
+  {
+  }
 }
 
 int
 Context::run()
 {
+  currentContext = this;
   mDocManager.printPreamble();
 
   {
@@ -98,8 +233,16 @@ Context::run()
       ++iter;
     }
   }
+  mCurrent = nullptr;
 
-  Scheduler::run();
+  if (mGroups.isAvailable())
+  {
+    runParallel();
+  }
+  else
+  {
+    Scheduler::run();
+  }
 
   {
     auto iter = mRunners.begin();
@@ -114,6 +257,26 @@ Context::run()
   mCurrent = nullptr;
   mDocManager.printPostamble();
 
+  if (mStackMode == StackMode::adapt && !mStackFileName.empty())
+  {
+    std::ofstream file(mStackFileName);
+    writeStackSizes(file);
+  }
+  else
+  {
+  }
+
+  if (coro::isInstrumentationEnabled && !mStatisticsFileName.empty())
+  {
+    std::ofstream file(mStatisticsFileName);
+    writeStatistics(file);
+  }
+  else
+  {
+  }
+
+  finishTrace();
+  finishAsyncLog();
   return getExitValue();
 }
 
@@ -128,9 +291,12 @@ RunnerRaw*
 Context::getCurrentVirtual()
 {
   auto* runner = getCurrent();
-  if (mCurrentVirtual != nullptr)
+  auto* group = RunnerGroup::getCurrentGroup();
+  auto* currentVirtual =
+      (group != nullptr) ? group->mCurrentVirtual : mCurrentVirtual;
+  if (currentVirtual != nullptr)
   {
-    runner = mCurrentVirtual;
+    runner = currentVirtual;
   }
   return runner;
 }
@@ -138,7 +304,263 @@ Context::getCurrentVirtual()
 void
 Context::setCurrentVirtual(RunnerRaw* runner)
 {
-  mCurrentVirtual = runner;
+  auto* group = RunnerGroup::getCurrentGroup();
+  if (group != nullptr)
+  {
+    group->mCurrentVirtual = runner;
+  }
+  else
+  {
+    mCurrentVirtual = runner;
+  }
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::addGroup(RunnerGroup* group)
+{
+  mGroups.prepend(*group);
+}
+
+size_t
+Context::getNumberOfGroups()
+{
+  return mGroups.numberOfElements();
+}
+
+size_t
+Context::getCurrentGroupIndex()
+{
+  auto* group = RunnerGroup::getCurrentGroup();
+  return (group != nullptr) ? group->getIndex() : 0;
+}
+
+uint64_t
+Context::nextSequenceNumber()
+{
+  auto* group = RunnerGroup::getCurrentGroup();
+  return (group != nullptr) ? group->mNumberOfSentMessages++
+                            : mNumberOfSentMessages++;
+}
+
+bool
+Context::isParallel() const
+{
+  return mIsParallel;
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::addLink(LinkRaw* link)
+{
+  PROTEST_ASSERT(link->getLatency() > time::Duration::zero());
+  mLookahead = std::min(mLookahead, link->getLatency());
+}
+
+LinkReceiver&
+Context::getLinkReceiver(coro::Scheduler& scheduler)
+{
+  for (auto& receiver : mLinkReceivers)
+  {
+    if (&receiver->getScheduler() == &scheduler)
+    {
+      return *receiver;
+    }
+    else
+    {
+    }
+  }
+
+  if (&scheduler == this)
+  {
+    mLinkReceivers.emplace_back(new LinkReceiver(*this));
+  }
+  else
+  {
+    // NOLINTNEXTLINE
+    mLinkReceivers.emplace_back(
+        new LinkReceiver(static_cast<RunnerGroup&>(scheduler)));
+  }
+  return *mLinkReceivers.back();
+}
+
+protest::time::Duration
+Context::getLookahead() const
+{
+  return mLookahead;
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::runParallel()
+{
+  // the context itself is executed by the calling thread, every group by its
+  // own thread
+  std::vector<RunnerGroup*> groups(mGroups.numberOfElements(), nullptr);
+  for (auto iter = mGroups.begin(); iter != mGroups.end(); ++iter)
+  {
+    groups[iter->getIndex() - 1] = &*iter;
+  }
+  std::vector<coro::Scheduler*> schedulers {this};
+  schedulers.insert(schedulers.end(), groups.begin(), groups.end());
+
+  std::vector<std::ostringstream> outputs(schedulers.size());
+  std::ostream& output = log::Logger::getOutput();
+
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable finished;
+  size_t window = 0;
+  size_t numberOfRunningGroups = 0;
+  time::TimePoint windowEnd = time::TimePoint::startOfEpoche();
+  bool isDone = false;
+
+  auto worker = [&](RunnerGroup* group) {
+    currentContext = this;
+    RunnerGroup::currentGroup = group;
+    log::Logger::setOutput(outputs[group->getIndex()]);
+
+    size_t executedWindow = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      start.wait(lock, [&]() { return isDone || executedWindow != window; });
+      if (isDone)
+      {
+        break;
+      }
+      else
+      {
+      }
+
+      executedWindow = window;
+      const time::TimePoint end = windowEnd;
+      lock.unlock();
+      group->runUntil(end);
+      log::Logger::finishLine();
+      lock.lock();
+
+      numberOfRunningGroups--;
+      if (numberOfRunningGroups == 0)
+      {
+        finished.notify_one();
+      }
+      else
+      {
+      }
+    }
+
+    RunnerGroup::currentGroup = nullptr;
+    currentContext = nullptr;
+  };
+
+  mIsParallel = true;
+  std::vector<std::thread> threads;
+  threads.reserve(groups.size());
+  for (auto* group : groups)
+  {
+    threads.emplace_back(worker, group);
+  }
+
+  while (true)
+  {
+    // the next window starts at the earliest event of all groups
+    bool hasPendingEvents = false;
+    auto begin = time::TimePoint::endOfEpoche();
+    for (auto* scheduler : schedulers)
+    {
+      if (scheduler->hasPendingEvents())
+      {
+        hasPendingEvents = true;
+        begin = std::min(begin, scheduler->getNextEventTime());
+      }
+      else
+      {
+      }
+    }
+    for (auto& receiver : mLinkReceivers)
+    {
+      if (receiver->hasIncoming())
+      {
+        hasPendingEvents = true;
+        begin = std::min(begin, receiver->getEarliestIncoming());
+      }
+      else
+      {
+      }
+    }
+
+    if (!hasPendingEvents)
+    {
+      break;
+    }
+    else
+    {
+    }
+
+    // every message between the groups is delayed by at least the lookahead
+    // -> nothing a group does within the window can influence another group
+    //    in the same window
+    auto end = time::TimePoint::endOfEpoche();
+    if (mLookahead != time::Duration::infinity() &&
+        begin < time::TimePoint::endOfEpoche() - mLookahead)
+    {
+      end = begin + mLookahead;
+    }
+    else
+    {
+    }
+
+    for (auto* scheduler : schedulers)
+    {
+      scheduler->moveForwardTo(begin);
+    }
+    for (auto& receiver : mLinkReceivers)
+    {
+      receiver->acceptIncoming();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      windowEnd = end;
+      window++;
+      numberOfRunningGroups = groups.size();
+    }
+    start.notify_all();
+
+    log::Logger::setOutput(outputs[0]);
+    Scheduler::runUntil(end);
+    log::Logger::finishLine();
+    log::Logger::setOutput(output);
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      finished.wait(lock, [&]() { return numberOfRunningGroups == 0; });
+    }
+
+    // the output is written in the order of the groups
+    for (auto& groupOutput : outputs)
+    {
+      log::Logger::writeText(groupOutput.str());
+      groupOutput.str("");
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isDone = true;
+  }
+  start.notify_all();
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  mIsParallel = false;
+
+  for (auto* scheduler : schedulers)
+  {
+    scheduler->finish();
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -163,3 +585,304 @@ Context::getExitValue()
              ? 1
              : 0;
 }
+
+// ---------------------------------------------------------------------------
+void
+Context::setStackMode(StackMode mode)
+{
+  mStackMode = mode;
+  setStackPainting(mode != StackMode::fixed);
+  for (auto iter = mGroups.begin(); iter != mGroups.end(); ++iter)
+  {
+    iter->setStackPainting(mode != StackMode::fixed);
+  }
+}
+
+Context::StackMode
+Context::getStackMode() const
+{
+  return mStackMode;
+}
+
+size_t
+Context::getStackSize(const char* name)
+{
+  auto iter = mStackSizes.find(name);
+  // a right-sized stack is tight, it must not overflow into the heap
+  // silently
+  if (mStackMode == StackMode::adapt && iter != mStackSizes.end() &&
+      coro::StackAllocator::hasGuardPages())
+  {
+    return iter->second * stackSizeFactor;
+  }
+  else
+  {
+    return coro::CoroutineBase::defaultStackSize;
+  }
+}
+
+std::vector<Context::StackUsage>
+Context::getStackUsage()
+{
+  // the runners are stored in reverse order of their creation
+  std::vector<StackUsage> usage;
+  for (auto iter = mRunners.begin(); iter != mRunners.end(); ++iter)
+  {
+    auto entry = std::find_if(usage.begin(),
+                              usage.end(),
+                              [&](const StackUsage& other) {
+                                return other.mName == iter->getName();
+                              });
+    if (!iter->isStackPainted())
+    {
+      // e.g. stackless or created before the stack mode was set
+    }
+    else if (entry == usage.end())
+    {
+      usage.insert(usage.begin(),
+                   StackUsage {iter->getName(),
+                               iter->getStackUsage(),
+                               iter->getStackSize()});
+    }
+    else
+    {
+      entry->mPeak = std::max(entry->mPeak, iter->getStackUsage());
+      entry->mSize = std::max(entry->mSize, iter->getStackSize());
+    }
+  }
+  return usage;
+}
+
+void
+Context::writeStackSizes(std::ostream& output)
+{
+  // one line per runner name: <peak usage in bytes> <name>
+  for (const auto& usage : getStackUsage())
+  {
+    output << usage.mPeak << " " << usage.mName << "\n";
+  }
+}
+
+void
+Context::readStackSizes(std::istream& input)
+{
+  size_t peak = 0;
+  std::string name;
+  while (input >> peak && std::getline(input >> std::ws, name))
+  {
+    mStackSizes[name] = peak;
+  }
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::addQueueOverflow(QueueOverflow* overflow)
+{
+  std::lock_guard<std::mutex> lock(mQueueOverflowMutex);
+  mQueueOverflows.push_back(overflow);
+}
+
+void
+Context::removeQueueOverflow(QueueOverflow* overflow)
+{
+  std::lock_guard<std::mutex> lock(mQueueOverflowMutex);
+  mQueueOverflows.erase(
+      std::remove(mQueueOverflows.begin(), mQueueOverflows.end(), overflow),
+      mQueueOverflows.end());
+  if (overflow->mDropped + overflow->mBlocked > 0)
+  {
+    mRemovedQueueOverflows.push_back(*overflow);
+  }
+  else
+  {
+  }
+}
+
+std::vector<Context::QueueOverflow>
+Context::getQueueOverflows()
+{
+  std::lock_guard<std::mutex> lock(mQueueOverflowMutex);
+  std::vector<QueueOverflow> overflows;
+  auto add = [&](const QueueOverflow& overflow) {
+    auto entry = std::find_if(overflows.begin(),
+                              overflows.end(),
+                              [&](const QueueOverflow& other) {
+                                return other.mName == overflow.mName;
+                              });
+    if (overflow.mDropped + overflow.mBlocked == 0)
+    {
+    }
+    else if (entry == overflows.end())
+    {
+      overflows.push_back(overflow);
+    }
+    else
+    {
+      entry->mDropped += overflow.mDropped;
+      entry->mBlocked += overflow.mBlocked;
+    }
+  };
+  for (const auto& overflow : mRemovedQueueOverflows)
+  {
+    add(overflow);
+  }
+  for (const auto* overflow : mQueueOverflows)
+  {
+    add(*overflow);
+  }
+  return overflows;
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::setInvariantCoalescing(bool coalescing)
+{
+  mInvariantCoalescing = coalescing;
+}
+
+bool
+Context::isInvariantCoalescing() const
+{
+  return mInvariantCoalescing;
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::setAsyncLog(const std::string& fileName)
+{
+  finishAsyncLog();
+  mSyncLog = &log::Logger::getOutput();
+  std::ostream* target = mSyncLog;
+  if (!fileName.empty())
+  {
+    mLogFile.open(fileName);
+    target = &mLogFile;
+  }
+  else
+  {
+  }
+
+  if (fileName.empty() || mLogFile.is_open())
+  {
+    mAsyncLog = std::make_unique<log::AsyncOutput>(*target);
+    log::Logger::setOutput(mAsyncLog->getStream());
+    terminatingLog = mAsyncLog.get();
+    auto previous = std::set_terminate(flushOnTerminate);
+    if (previous != flushOnTerminate)
+    {
+      previousTerminate = previous;
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    std::cerr << "cannot open the log file '" << fileName
+              << "', the log is written synchronously" << std::endl;
+    mLogFile.close();
+  }
+}
+
+void
+Context::setTrace(const std::string& fileName)
+{
+  finishTrace();
+  mTraceFile.open(fileName, std::ios::binary);
+  mTrace = std::make_unique<log::TraceWriter>(mTraceFile);
+  log::Logger::setTrace(mTrace.get());
+}
+
+void
+Context::finishTrace()
+{
+  if (mTrace != nullptr)
+  {
+    log::Logger::setTrace(nullptr);
+    mTrace.reset();
+    mTraceFile.close();
+  }
+  else
+  {
+  }
+}
+
+void
+Context::finishAsyncLog()
+{
+  if (mAsyncLog != nullptr)
+  {
+    auto* asyncLog = mAsyncLog.get();
+    terminatingLog.compare_exchange_strong(asyncLog, nullptr);
+    // the remaining output is written before the file is closed
+    log::Logger::setOutput(*mSyncLog);
+    mAsyncLog.reset();
+    if (mLogFile.is_open())
+    {
+      mLogFile.close();
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+void
+Context::writeStatistics(std::ostream& output)
+{
+  std::vector<coro::Scheduler*> schedulers(mGroups.numberOfElements() + 1,
+                                           this);
+  for (auto iter = mGroups.begin(); iter != mGroups.end(); ++iter)
+  {
+    schedulers[iter->getIndex()] = &*iter;
+  }
+
+  output << "{\n  \"instrumentation\": "
+         << (coro::isInstrumentationEnabled ? "true" : "false") << ",\n";
+
+  output << "  \"schedulers\": [";
+  for (size_t i = 0; i < schedulers.size(); i++)
+  {
+    const auto& statistics = schedulers[i]->getStatistics();
+    output << (i == 0 ? "\n" : ",\n") << "    {\"group\": " << i
+           << ", \"switches\": " << statistics.mNumberOfSwitches
+           << ", \"yields\": " << statistics.mNumberOfYields
+           << ", \"sleeps\": " << statistics.mNumberOfSleeps
+           << ", \"wakeups\": " << statistics.mNumberOfWakeups
+           << ", \"maxRunQueueDepth\": " << statistics.mMaxRunQueueDepth
+           << ", \"maxSleepQueueDepth\": " << statistics.mMaxSleepQueueDepth
+           << "}";
+  }
+  output << "\n  ],\n";
+
+  // the runners are stored in reverse order of their creation
+  std::vector<RunnerRaw*> runners;
+  for (auto iter = mRunners.begin(); iter != mRunners.end(); ++iter)
+  {
+    runners.insert(runners.begin(), &*iter);
+  }
+
+  output << "  \"runners\": [";
+  for (size_t i = 0; i < runners.size(); i++)
+  {
+    auto group = static_cast<size_t>(
+        std::find(schedulers.begin(),
+                  schedulers.end(),
+                  &runners[i]->getScheduler()) -
+        schedulers.begin());
+    const auto& statistics = runners[i]->getStatistics();
+    output << (i == 0 ? "\n" : ",\n")
+           << "    {\"name\": " << json::quote(runners[i]->getName())
+           << ", \"group\": " << group
+           << ", \"switches\": " << statistics.mNumberOfSwitches
+           << ", \"yields\": " << statistics.mNumberOfYields
+           << ", \"sleeps\": " << statistics.mNumberOfSleeps
+           << ", \"wakeups\": " << statistics.mNumberOfWakeups
+           << ", \"wallTimeNs\": " << statistics.mWallTime.count() << "}";
+  }
+  output << "\n  ]\n}\n";
+}
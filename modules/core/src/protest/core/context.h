@@ -25,11 +25,24 @@
 #pragma once
 
 #include "protest/coro/scheduler.h"
+#include "protest/log/async_output.h"
 #include "protest/log/logger.h"
+#include "protest/log/trace_writer.h"
 #include "protest/meta/test_manager.h"
 #include "protest/meta/call_context.h"
 #include "protest/doc/doc_manager.h"
 #include "protest/json/json.h"
+#include "protest/utils/list.h"
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace protest
 {
@@ -37,6 +50,9 @@ namespace protest
 namespace core
 {
 
+class LinkRaw;
+class LinkReceiver;
+class RunnerGroup;
 class RunnerRaw;
 
 /**
@@ -44,15 +60,69 @@ class RunnerRaw;
  * 
  * Usally there will be one context per executable. Some top level protest
  * objects like runner or signals exists exactly once in a context.
+ * 
+ * The current context is stored per thread, so independent contexts can be
+ * executed on different threads (see ContextPool). The runners of one
+ * context can be distributed over several threads with groups (see
+ * RunnerGroup).
  */
 class Context : public coro::Scheduler
 {
 public:
+  // the stack of a runner is twice its peak usage of the last run (see
+  // StackMode::adapt)
+  static constexpr size_t stackSizeFactor = 2;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @enum StackMode
+   * 
+   * The mode can be selected with the command line argument
+   * `--stack-mode=fixed|measure|adapt` (see initialize). Other values are
+   * rejected.
+   */
+  enum class StackMode
+  {
+    // the stacks have the size the runners are created with
+    fixed,
+    // the stacks are painted and the peak usage per runner name is reported
+    // at the end of run
+    measure,
+    // like measure. Additionally the peak usage is written to
+    // `<executable>.stacks` and read by initialize of the next run. Runners
+    // created with the default stack size get a right-sized stack then.
+    adapt
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class StackUsage
+   */
+  struct StackUsage
+  {
+    std::string mName;
+    size_t mPeak;
+    size_t mSize;
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class QueueOverflow
+   * 
+   * Overflow counters of a queue port (see QueueOptions).
+   */
+  struct QueueOverflow
+  {
+    std::string mName;
+    uint64_t mDropped;
+    uint64_t mBlocked;
+  };
+
 // ---------------------------------------------------------------------------
   /**
    * @brief getCurrentContext
    * 
-   * returns the current context.
+   * returns the current context of the calling thread.
    * 
    * @return
    *  the current context
@@ -82,7 +152,7 @@ public:
   Context&
   operator=(Context&& other) noexcept = delete;
 
-  ~Context() = default;
+  ~Context();
 
 // ---------------------------------------------------------------------------
   void
@@ -91,11 +161,18 @@ public:
   /**
    * @brief initialize
    * 
-   * must be called at the start of the program in the main function.
+   * must be called at the start of the program in the main function, before
+   * the runners are created.
    */
   void
   initialize(int argc, const char** argv);
 
+  /**
+   * @brief run
+   * 
+   * executes all runners. If the context has groups, the groups are
+   * executed in parallel (see RunnerGroup).
+   */
   int
   run();
 
@@ -135,6 +212,63 @@ public:
   void
   setCurrentVirtual(RunnerRaw* runner);
 
+// ---------------------------------------------------------------------------
+  void
+  addGroup(RunnerGroup* group);
+
+  size_t
+  getNumberOfGroups();
+
+  /**
+   * @brief getCurrentGroupIndex
+   * 
+   * @return
+   *  the index of the group executed by the calling thread (zero for the
+   *  context itself)
+   */
+  size_t
+  getCurrentGroupIndex();
+
+  /**
+   * @brief nextSequenceNumber
+   * 
+   * @return
+   *  the number of messages sent by the current group so far
+   */
+  uint64_t
+  nextSequenceNumber();
+
+  /**
+   * @brief isParallel
+   * 
+   * @return
+   *  true while the groups are executed in parallel
+   */
+  bool
+  isParallel() const;
+
+// ---------------------------------------------------------------------------
+  void
+  addLink(LinkRaw* link);
+
+  /**
+   * @brief getLinkReceiver
+   * 
+   * returns the receiver of the links ending in `scheduler` (the context
+   * itself or one of its groups). The receiver is created on demand.
+   */
+  LinkReceiver&
+  getLinkReceiver(coro::Scheduler& scheduler);
+
+  /**
+   * @brief getLookahead
+   * 
+   * @return
+   *  the smallest latency of all links (infinity if there is no link)
+   */
+  time::Duration
+  getLookahead() const;
+
 // ---------------------------------------------------------------------------
   /**
    * @brief getTestManager
@@ -153,13 +287,164 @@ public:
   int
   getExitValue();
 
+// ---------------------------------------------------------------------------
+  /**
+   * @brief setStackMode
+   * 
+   * must be set before the runners are created. The persisted sizes of
+   * StackMode::adapt are read by initialize.
+   */
+  void
+  setStackMode(StackMode mode);
+
+  StackMode
+  getStackMode() const;
+
+  /**
+   * @brief getStackSize
+   * 
+   * @return
+   *  the size of the stack of a runner created with the default stack size.
+   *  In StackMode::adapt it is derived from the peak usage of the runners
+   *  with the same name in the last run, as long as the stacks get a guard
+   *  page (see coro::StackAllocator::hasGuardPages).
+   */
+  size_t
+  getStackSize(const char* name);
+
+  /**
+   * @brief getStackUsage
+   * 
+   * @return
+   *  the peak usage and the size of the stacks per runner name (maximum of
+   *  all runners with that name) in the order of creation. Empty if the
+   *  stacks are not painted.
+   */
+  std::vector<StackUsage>
+  getStackUsage();
+
+  void
+  writeStackSizes(std::ostream& output);
+
+  void
+  readStackSizes(std::istream& input);
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief addQueueOverflow
+   * 
+   * registers the counters of a queue port. They are owned and updated by
+   * the port. When the port is removed its counts are kept.
+   */
+  void
+  addQueueOverflow(QueueOverflow* overflow);
+
+  void
+  removeQueueOverflow(QueueOverflow* overflow);
+
+  /**
+   * @brief getQueueOverflows
+   * 
+   * @return
+   *  the counters summed up per port name, only ports which dropped or
+   *  blocked a value
+   */
+  std::vector<QueueOverflow>
+  getQueueOverflows();
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief setInvariantCoalescing
+   * 
+   * by default an invariant is checked on every change of its expression.
+   * With coalescing a change only marks it as pending. The pending
+   * invariants of a runner are checked once per time step, before the
+   * runner resumes and before the time advances (see InvariantCheck). A
+   * violation which is undone within the same time step is not reported
+   * then. Affects invariants started afterwards. Can be enabled with
+   * `--coalesce-invariants` (see initialize).
+   */
+  void
+  setInvariantCoalescing(bool coalescing);
+
+  bool
+  isInvariantCoalescing() const;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief setAsyncLog
+   * 
+   * the log output of the calling thread is written by a background thread
+   * (see log::AsyncOutput), either to the current output or to the file if
+   * a name is given. The runners do not wait for the terminal or a pipe
+   * then. The output is complete at the end of run, and also if the process
+   * terminates because of an uncaught exception. If the file cannot be
+   * opened, the log stays synchronous. Can be enabled with
+   * `--async-log[=<file>]` (see initialize).
+   */
+  void
+  setAsyncLog(const std::string& fileName = std::string());
+
+  /**
+   * @brief setTrace
+   * 
+   * the loggers of the calling thread write a binary trace to the file
+   * instead of the text output (see log::TraceWriter). The output of
+   * parallel groups is added to the trace as text. The trace is complete
+   * at the end of run. It can be rendered to text with
+   * tools/protest-render-trace. Can be enabled with `--trace=<file>` (see
+   * initialize).
+   */
+  void
+  setTrace(const std::string& fileName);
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief writeStatistics
+   * 
+   * writes the statistics of the schedulers (the context and its groups)
+   * and of all runners as JSON. They are only collected if the
+   * instrumentation is enabled (see coro/statistics.h). In this case they
+   * are written to `<executable>.statistics.json` at the end of run().
+   */
+  void
+  writeStatistics(std::ostream& output);
+
 private:
-  static Context* currentContext;
+  static thread_local Context* currentContext;
+
+  void
+  runParallel();
+
+  void
+  finishAsyncLog();
+
+  void
+  finishTrace();
 
   meta::TestManager mTestManager;
   protest::List<RunnerRaw> mRunners;
   meta::CallContext& mCallContext;
   RunnerRaw* mCurrentVirtual;
+  protest::List<RunnerGroup> mGroups;
+  std::vector<std::unique_ptr<LinkReceiver>> mLinkReceivers;
+  time::Duration mLookahead;
+  uint64_t mNumberOfSentMessages;
+  bool mIsParallel;
+  std::string mStatisticsFileName;
+  StackMode mStackMode;
+  std::string mStackFileName;
+  std::map<std::string, size_t> mStackSizes;
+  // the ports of parallel groups are created on the threads of the groups
+  std::mutex mQueueOverflowMutex;
+  std::vector<QueueOverflow*> mQueueOverflows;
+  std::vector<QueueOverflow> mRemovedQueueOverflows;
+  bool mInvariantCoalescing;
+  std::ostream* mSyncLog;
+  std::ofstream mLogFile;
+  std::unique_ptr<log::AsyncOutput> mAsyncLog;
+  std::ofstream mTraceFile;
+  std::unique_ptr<log::TraceWriter> mTrace;
   // TODO (jreinking) should not use doc manager directly. Use listener pattern
   // instead
   protest::doc::DocManager mDocManager;
@@ -0,0 +1,177 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/core/context_pool.h"
+#include "protest/log/logger.h"
+#include "protest/utils/debug.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace protest::core;
+
+// ---------------------------------------------------------------------------
+ContextPool::ContextPool(size_t numberOfWorkers) :
+  mNumberOfWorkers(numberOfWorkers)
+{
+  if (mNumberOfWorkers == 0)
+  {
+    mNumberOfWorkers = std::thread::hardware_concurrency();
+  }
+  else
+  {
+  }
+
+  if (mNumberOfWorkers == 0)
+  {
+    // hardware_concurrency is only a hint and may be zero
+    mNumberOfWorkers = 1;
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+int
+ContextPool::run(size_t numberOfContexts, const Main& main)
+{
+  mResults.clear();
+  mResults.resize(numberOfContexts,
+                  Result {0, std::string(), nullptr, false});
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::atomic<size_t> nextIndex(0);
+
+  auto worker = [&]() {
+    while (true)
+    {
+      const size_t index = nextIndex.fetch_add(1);
+      if (index >= numberOfContexts)
+      {
+        break;
+      }
+      else
+      {
+      }
+
+      // every context writes into its own buffer
+      std::ostringstream output;
+      log::Logger::setOutput(output);
+      int exitValue = 0;
+      std::exception_ptr exception;
+      try
+      {
+        exitValue = main(index);
+      }
+      catch (...)
+      {
+        // the calling thread would wait for the context forever
+        exception = std::current_exception();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      mResults[index].mExitValue = exitValue;
+      mResults[index].mOutput = output.str();
+      mResults[index].mException = exception;
+      mResults[index].mIsDone = true;
+      done.notify_one();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  const size_t numberOfThreads = std::min(mNumberOfWorkers, numberOfContexts);
+  workers.reserve(numberOfThreads);
+  for (size_t i = 0; i < numberOfThreads; i++)
+  {
+    workers.emplace_back(worker);
+  }
+
+  // write the output in the order of the indices as soon as it is complete
+  int exitValue = 0;
+  std::exception_ptr exception;
+  for (size_t index = 0; index < numberOfContexts; index++)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return mResults[index].mIsDone; });
+    log::Logger::getOutput() << mResults[index].mOutput;
+    if (exception == nullptr)
+    {
+      exception = mResults[index].mException;
+    }
+    else
+    {
+    }
+
+    if (exitValue == 0)
+    {
+      exitValue = mResults[index].mExitValue;
+    }
+    else
+    {
+    }
+  }
+  log::Logger::getOutput().flush();
+
+  for (auto& thread : workers)
+  {
+    thread.join();
+  }
+
+  if (exception != nullptr)
+  {
+    std::rethrow_exception(exception);
+  }
+  else
+  {
+  }
+  return exitValue;
+}
+
+// ---------------------------------------------------------------------------
+size_t
+ContextPool::getNumberOfWorkers() const
+{
+  return mNumberOfWorkers;
+}
+
+int
+ContextPool::getExitValue(size_t index) const
+{
+  PROTEST_ASSERT(index < mResults.size());
+  return mResults[index].mExitValue;
+}
+
+const std::string&
+ContextPool::getOutput(size_t index) const
+{
+  PROTEST_ASSERT(index < mResults.size());
+  return mResults[index].mOutput;
+}
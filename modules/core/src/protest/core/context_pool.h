@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <cstddef>
+
+namespace protest
+{
+
+namespace core
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class ContextPool
+ * 
+ * Executes independent contexts on a pool of worker threads, e.g. to run a
+ * parameter sweep of one test script on all cores.
+ * 
+ * For every index the pool calls `main(index)` on one of the workers. The
+ * function creates, initializes and runs its own Context (with its own
+ * runners and simulated clock) and returns the exit value of
+ * Context::run(). The log output of every context is captured and written
+ * to the output of the calling thread in the order of the indices, so the
+ * output does not depend on the scheduling of the workers.
+ * 
+ * The results of the assertions and checks are stored in the call contexts
+ * generated by the protest compiler, which exist once per process. They are
+ * therefore accumulated over all contexts. Also random() and coinFlip()
+ * share one random sequence per process.
+ */
+class ContextPool
+{
+public:
+  using Main = std::function<int(size_t index)>;
+
+  /**
+   * @param numberOfWorkers
+   *  number of worker threads. If zero the number of hardware threads is
+   *  used.
+   */
+  explicit ContextPool(size_t numberOfWorkers = 0);
+
+  ContextPool(const ContextPool&) = delete;
+
+  ContextPool(ContextPool&&) noexcept = delete;
+
+  ContextPool&
+  operator=(const ContextPool&) = delete;
+
+  ContextPool&
+  operator=(ContextPool&&) noexcept = delete;
+
+  ~ContextPool() = default;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief run
+   * 
+   * Runs `main` for the indices 0 to numberOfContexts - 1 and blocks until
+   * all of them are finished.
+   * 
+   * If `main` throws, the other contexts are still run and their output is
+   * written. The exception of the first throwing context (by index) is
+   * rethrown afterwards.
+   * 
+   * @return
+   *  zero if all contexts returned zero, otherwise the exit value of the
+   *  first failing context (by index)
+   */
+  int
+  run(size_t numberOfContexts, const Main& main);
+
+// ---------------------------------------------------------------------------
+  size_t
+  getNumberOfWorkers() const;
+
+  int
+  getExitValue(size_t index) const;
+
+  const std::string&
+  getOutput(size_t index) const;
+
+private:
+  /**
+   * @class Result
+   */
+  struct Result
+  {
+    int mExitValue;
+    std::string mOutput;
+    std::exception_ptr mException;
+    bool mIsDone;
+  };
+
+  size_t mNumberOfWorkers;
+  std::vector<Result> mResults;
+};
+
+} // namespace core
+
+} // namespace protest
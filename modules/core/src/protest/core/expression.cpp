@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/core/expression.h"
+
+using namespace protest::core;
+
+// ---------------------------------------------------------------------------
+ExprNode::ExprNode() :
+  mParent(nullptr),
+  mIsEnabled(false),
+  mIsVolatile(false),
+  mIsDirty(true)
+{
+}
+
+// ---------------------------------------------------------------------------
+void
+ExprNode::enable(ExprNode* parent)
+{
+  mParent = parent;
+  mIsEnabled = true;
+  mIsVolatile = false;
+  mIsDirty = true;
+}
+
+void
+ExprNode::disable()
+{
+  mParent = nullptr;
+  mIsEnabled = false;
+  mIsVolatile = false;
+  mIsDirty = true;
+}
+
+bool
+ExprNode::isDirty() const
+{
+  return mIsDirty;
+}
+
+void
+ExprNode::clean()
+{
+  mIsDirty = !mIsEnabled || mIsVolatile;
+}
+
+// ---------------------------------------------------------------------------
+void
+ExprNode::invalidate(ExprNode* node)
+{
+  // ancestors of a dirty node are dirty as well unless a short-circuit
+  // skipped the node, in which case their result does not depend on it
+  while (node != nullptr && !node->mIsDirty)
+  {
+    node->mIsDirty = true;
+    node = node->mParent;
+  }
+}
+
+void
+ExprNode::invalidateAlways(ExprNode* node)
+{
+  while (node != nullptr && !node->mIsVolatile)
+  {
+    node->mIsVolatile = true;
+    node->mIsDirty = true;
+    node = node->mParent;
+  }
+}
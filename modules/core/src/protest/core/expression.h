@@ -173,6 +173,69 @@ struct ConvertableToCopyExprTag : ExprTag
 {
 };
 
+// ---------------------------------------------------------------------------
+/**
+ * @class ExprNode
+ *
+ * Dirty flag of an inner node of an expression tree. While the expression
+ * is enabled, a leaf marks its parent node and all ancestors dirty when its
+ * value changes. Clean nodes return their cached result, so only the paths
+ * from changed leaves to the root are evaluated again. A disabled node has
+ * no leaves reporting to it and is therefore always dirty, as is a node with
+ * a leaf whose value follows the virtual time (see invalidateAlways()).
+ */
+class ExprNode
+{
+public:
+  explicit ExprNode();
+
+  ExprNode(const ExprNode&) = default;
+
+  ExprNode(ExprNode&&) noexcept = delete;
+
+  ExprNode&
+  operator=(const ExprNode&) = delete;
+
+  ExprNode&
+  operator=(ExprNode&&) noexcept = delete;
+
+  ~ExprNode() = default;
+
+// ---------------------------------------------------------------------------
+  void
+  enable(ExprNode* parent);
+
+  void
+  disable();
+
+  bool
+  isDirty() const;
+
+  void
+  clean();
+
+  /**
+   * Marks @p node and all its ancestors dirty. @p node is null if the leaf
+   * is the root of the expression.
+   */
+  static void
+  invalidate(ExprNode* node);
+
+  /**
+   * Keeps @p node and all its ancestors dirty until they are disabled. For
+   * leaves whose value changes with the time before they notify, e.g. the
+   * comparisons of a Stopwatch.
+   */
+  static void
+  invalidateAlways(ExprNode* node);
+
+private:
+  ExprNode* mParent;
+  bool mIsEnabled;
+  bool mIsVolatile;
+  bool mIsDirty;
+};
+
 // ---------------------------------------------------------------------------
 /**
  * @class Copy
@@ -211,7 +274,7 @@ public:
 
 private:
   void
-  conditionEnable(RunnerRaw* runner, Condition* condition);
+  conditionEnable(RunnerRaw* runner, Condition* condition, ExprNode* parent);
 
   void
   conditionDisable();
@@ -235,7 +298,9 @@ Copy<T>::getValue()
 // ---------------------------------------------------------------------------
 template <typename T>
 void
-Copy<T>::conditionEnable(RunnerRaw* runner, Condition* condition)
+Copy<T>::conditionEnable(RunnerRaw* runner,
+                         Condition* condition,
+                         ExprNode* /* parent */)
 {
 }
 
@@ -265,6 +330,9 @@ struct BinaryResult
                                                                                \
     static Type                                                                \
     apply(LhsType lhs, RhsType rhs);                                           \
+                                                                               \
+    static Type                                                                \
+    evaluate(Lhs& lhs, Rhs& rhs);                                              \
   };                                                                           \
                                                                                \
   template <typename Lhs, typename Rhs>                                        \
@@ -272,6 +340,13 @@ struct BinaryResult
   BinaryResult<Lhs, Rhs, oprcls>::apply(LhsType lhs, RhsType rhs)              \
   {                                                                            \
     return lhs opr rhs;                                                        \
+  }                                                                            \
+                                                                               \
+  template <typename Lhs, typename Rhs>                                        \
+  typename BinaryResult<Lhs, Rhs, oprcls>::Type                                \
+  BinaryResult<Lhs, Rhs, oprcls>::evaluate(Lhs& lhs, Rhs& rhs)                 \
+  {                                                                            \
+    return lhs.getValue() opr rhs.getValue();                                  \
   }
 
 BINARY_OPERATOR_INFO(Plus, +);
@@ -287,6 +362,9 @@ BINARY_OPERATOR_INFO(LessOrEquals, <=);
 BINARY_OPERATOR_INFO(And, &&);
 BINARY_OPERATOR_INFO(Or, ||);
 
+// evaluate() applies the built-in operator to the operands directly, so
+// And and Or do not evaluate the right operand if the left one decides.
+
 // ---------------------------------------------------------------------------
 /**
  * @class BinaryExpression
@@ -328,20 +406,24 @@ public:
 
 private:
   void
-  conditionEnable(RunnerRaw* runner, Condition* condition);
+  conditionEnable(RunnerRaw* runner, Condition* condition, ExprNode* parent);
 
   void
   conditionDisable();
 
   Lhs mLhs;
   Rhs mRhs;
+  ExprNode mNode;
+  Type mResult;
 };
 
 // ---------------------------------------------------------------------------
 template <typename Operation, typename Lhs, typename Rhs>
 BinaryExpression<Operation, Lhs, Rhs>::BinaryExpression(Lhs lhs, Rhs rhs) :
   mLhs(lhs),
-  mRhs(rhs)
+  mRhs(rhs),
+  mNode(),
+  mResult()
 {
 }
 
@@ -349,8 +431,15 @@ template <typename Operation, typename Lhs, typename Rhs>
 typename BinaryExpression<Operation, Lhs, Rhs>::Type
 BinaryExpression<Operation, Lhs, Rhs>::getValue()
 {
-  return BinaryResult<Lhs, Rhs, Operation>::apply(mLhs.getValue(),
-                                                  mRhs.getValue());
+  if (mNode.isDirty())
+  {
+    mResult = BinaryResult<Lhs, Rhs, Operation>::evaluate(mLhs, mRhs);
+    mNode.clean();
+  }
+  else
+  {
+  }
+  return mResult;
 }
 
 template <typename Operation, typename Lhs, typename Rhs>
@@ -363,10 +452,12 @@ BinaryExpression<Operation, Lhs, Rhs>::operator Type()
 template <typename Operation, typename Lhs, typename Rhs>
 void
 BinaryExpression<Operation, Lhs, Rhs>::conditionEnable(RunnerRaw* runner,
-                                                       Condition* condition)
+                                                       Condition* condition,
+                                                       ExprNode* parent)
 {
-  mLhs.conditionEnable(runner, condition);
-  mRhs.conditionEnable(runner, condition);
+  mNode.enable(parent);
+  mLhs.conditionEnable(runner, condition, &mNode);
+  mRhs.conditionEnable(runner, condition, &mNode);
 }
 
 template <typename Operation, typename Lhs, typename Rhs>
@@ -375,6 +466,7 @@ BinaryExpression<Operation, Lhs, Rhs>::conditionDisable()
 {
   mLhs.conditionDisable();
   mRhs.conditionDisable();
+  mNode.disable();
 }
 
 // ---------------------------------------------------------------------------
@@ -545,18 +637,22 @@ public:
 
 private:
   void
-  conditionEnable(RunnerRaw* runner, Condition* condition);
+  conditionEnable(RunnerRaw* runner, Condition* condition, ExprNode* parent);
 
   void
   conditionDisable();
 
   Operand mOperand;
+  ExprNode mNode;
+  Type mResult;
 };
 
 // ---------------------------------------------------------------------------
 template <typename Operation, typename Operand>
 UnaryExpression<Operation, Operand>::UnaryExpression(Operand operand) :
-  mOperand(operand)
+  mOperand(operand),
+  mNode(),
+  mResult()
 {
 }
 
@@ -564,7 +660,15 @@ template <typename Operation, typename Operand>
 typename UnaryExpression<Operation, Operand>::Type
 UnaryExpression<Operation, Operand>::getValue()
 {
-  return UnaryResult<Operand, Operation>::apply(mOperand.getValue());
+  if (mNode.isDirty())
+  {
+    mResult = UnaryResult<Operand, Operation>::apply(mOperand.getValue());
+    mNode.clean();
+  }
+  else
+  {
+  }
+  return mResult;
 }
 
 template <typename Operation, typename Operand>
@@ -577,9 +681,11 @@ UnaryExpression<Operation, Operand>::operator Type()
 template <typename Operation, typename Operand>
 void
 UnaryExpression<Operation, Operand>::conditionEnable(RunnerRaw* runner,
-                                                     Condition* condition)
+                                                     Condition* condition,
+                                                     ExprNode* parent)
 {
-  mOperand.conditionEnable(runner, condition);
+  mNode.enable(parent);
+  mOperand.conditionEnable(runner, condition, &mNode);
 }
 
 template <typename Operation, typename Operand>
@@ -587,6 +693,7 @@ void
 UnaryExpression<Operation, Operand>::conditionDisable()
 {
   mOperand.conditionDisable();
+  mNode.disable();
 }
 
 // ---------------------------------------------------------------------------
@@ -41,6 +41,14 @@ Invariant::~Invariant()
   {
   }
 
+  if (mIsPending)
+  {
+    checkNow();
+  }
+  else
+  {
+  }
+
   delete mCondition;
   mCondition = nullptr;
 }
@@ -48,6 +56,7 @@ Invariant::~Invariant()
 void
 Invariant::start()
 {
+  mIsCoalescing = mCondition->getOwner()->getContext().isInvariantCoalescing();
   mCondition->enable();
   // after starting the inv it might already not hold before any
   // other action will occure. E.g. :
@@ -60,7 +69,7 @@ Invariant::start()
   // the job of (stopwatch != 0_ms) will be executed when the condition
   // changed it's value. This is the case when stopwatch is greater then
   // 0. This is a initial check which prevents the fault explained here.
-  notify();
+  check();
 }
 
 void
@@ -73,14 +82,17 @@ Invariant::stop()
   // otherwise fail. This call to notify will make sure that
   // this case will not occur since the inv will be checked
   // any way.
-  notify();
+  checkNow();
 }
 
 // ---------------------------------------------------------------------------
 Invariant::Invariant(const Invariant& /* invariant */) :
   mCondition(nullptr),
   mHolds(false),
-  mContext(nullptr)
+  mContext(nullptr),
+  mIsCoalescing(false),
+  mIsPending(false),
+  mNext(nullptr)
 {
   // must exists but will never be called because of RVO
   // could be '= default' as well
@@ -88,13 +100,50 @@ Invariant::Invariant(const Invariant& /* invariant */) :
 }
 
 bool
-Invariant::holds() const
+Invariant::holds()
 {
+  if (mIsPending)
+  {
+    checkNow();
+  }
+  else
+  {
+  }
   return mHolds;
 }
 
 void
 Invariant::notify()
+{
+  if (!mIsCoalescing)
+  {
+    check();
+  }
+  else if (mHolds && !mIsPending)
+  {
+    mCondition->getOwner()->getInvariantCheck().add(*this);
+  }
+  else
+  {
+    // already pending or reported
+  }
+}
+
+void
+Invariant::checkNow()
+{
+  if (mIsPending)
+  {
+    mCondition->getOwner()->getInvariantCheck().remove(*this);
+  }
+  else
+  {
+  }
+  check();
+}
+
+void
+Invariant::check()
 {
   assert(mCondition);
   if (mHolds && !mCondition->isFulfilled())
@@ -116,3 +165,50 @@ Invariant::notify()
   {
   }
 }
+
+// ---------------------------------------------------------------------------
+InvariantCheck::InvariantCheck(RunnerRaw* runner) : mRunner(runner)
+{
+}
+
+void
+InvariantCheck::add(Invariant& invariant)
+{
+  PROTEST_ASSERT(!invariant.mIsPending);
+  invariant.mIsPending = true;
+  mPending.append(invariant);
+  if (!mJob.isArmed())
+  {
+    mJob.setDue(mRunner->now(), this);
+    mRunner->add(mJob);
+  }
+  else
+  {
+  }
+}
+
+void
+InvariantCheck::remove(Invariant& invariant)
+{
+  PROTEST_ASSERT(invariant.mIsPending);
+  invariant.mIsPending = false;
+  mPending.remove(invariant);
+  if (!mPending.isAvailable() && mJob.isArmed())
+  {
+    mRunner->remove(mJob);
+  }
+  else
+  {
+  }
+}
+
+void
+InvariantCheck::notify(RunnerRaw* /* runner */)
+{
+  while (mPending.isAvailable())
+  {
+    Invariant& invariant = mPending.removeFirst();
+    invariant.mIsPending = false;
+    invariant.check();
+  }
+}
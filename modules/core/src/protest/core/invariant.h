@@ -25,7 +25,9 @@
 #pragma once
 
 #include "protest/core/condition.h"
+#include "protest/core/job.h"
 #include "protest/meta.h"
+#include "protest/utils/list.h"
 
 namespace protest
 {
@@ -40,6 +42,9 @@ namespace core
 class Invariant : public Condition::Listener
 {
 public:
+  friend class List<Invariant>;
+  friend class InvariantCheck;
+
   template <typename Expr>
   explicit Invariant(RunnerRaw* runner, Expr expr);
 
@@ -63,8 +68,13 @@ public:
   void
   stop();
 
+  /**
+   * @brief holds
+   * 
+   * a pending check (see Context::setInvariantCoalescing) is done first.
+   */
   bool
-  holds() const;
+  holds();
 
 private:
   Invariant(const Invariant&);
@@ -72,9 +82,61 @@ private:
   void
   notify() override;
 
+  void
+  check();
+
+  void
+  checkNow();
+
   Condition* mCondition;
   meta::Invariant* mContext;
   bool mHolds;
+  bool mIsCoalescing;
+  bool mIsPending;
+  Invariant* mNext;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class InvariantCheck
+ * 
+ * Checks the pending invariants of one runner if invariant coalescing is
+ * enabled (see Context::setInvariantCoalescing). The first invariant that
+ * becomes pending arms a job which is due at the current time. The runner
+ * executes it as soon as it resumes, so it is checked before the runner
+ * continues and before the time advances.
+ */
+class InvariantCheck : public Job::Listener
+{
+public:
+  explicit InvariantCheck(RunnerRaw* runner);
+
+  InvariantCheck(const InvariantCheck&) = delete;
+
+  InvariantCheck(InvariantCheck&&) noexcept = delete;
+
+  InvariantCheck&
+  operator=(const InvariantCheck&) = delete;
+
+  InvariantCheck&
+  operator=(InvariantCheck&&) noexcept = delete;
+
+  ~InvariantCheck() = default;
+
+// ---------------------------------------------------------------------------
+  void
+  add(Invariant& invariant);
+
+  void
+  remove(Invariant& invariant);
+
+  void
+  notify(RunnerRaw* runner) override;
+
+private:
+  RunnerRaw* mRunner;
+  Job mJob;
+  List<Invariant> mPending;
 };
 
 // ---------------------------------------------------------------------------
@@ -82,7 +144,10 @@ template <typename Expr>
 Invariant::Invariant(RunnerRaw* runner, Expr expr) :
   mCondition(new ExprCondition<Expr>(runner, expr, this)),
   mContext(nullptr),
-  mHolds(true)
+  mHolds(true),
+  mIsCoalescing(false),
+  mIsPending(false),
+  mNext(nullptr)
 {
   mContext->markAsCreated();
 }
@@ -91,7 +156,10 @@ template <typename Expr>
 Invariant::Invariant(RunnerRaw* runner, Expr expr, meta::Invariant* context) :
   mCondition(new ExprCondition<Expr>(runner, expr, this)),
   mContext(context),
-  mHolds(true)
+  mHolds(true),
+  mIsCoalescing(false),
+  mIsPending(false),
+  mNext(nullptr)
 {
   mContext->markAsCreated();
 }
@@ -33,6 +33,8 @@ Job::Job() :
   mArmed(false),
   mCondition(nullptr),
   mDue(time::TimePoint::endOfEpoche()),
+  mPeriod(time::Duration::zero()),
+  mExpirations(0U),
   mIndex(0U)
 {
 }
@@ -42,6 +44,7 @@ Job::execute(RunnerRaw* runner)
 {
   PROTEST_ASSERT(mArmed);
   mArmed = false;
+  mExpirations = 1U;
   mCondition->notify(runner);
 }
 
@@ -58,6 +61,45 @@ Job::isArmed() const
   return mArmed;
 }
 
+void
+Job::setPeriod(time::Duration period)
+{
+  PROTEST_ASSERT(period >= time::Duration::zero());
+  mPeriod = period;
+}
+
+bool
+Job::isPeriodic() const
+{
+  return mPeriod != time::Duration::zero();
+}
+
+void
+Job::reschedule(time::TimePoint now)
+{
+  PROTEST_ASSERT(mArmed);
+  PROTEST_ASSERT(isPeriodic());
+  PROTEST_ASSERT(isDue(now));
+  // the due is advanced by whole periods, so it does not drift when the
+  // job is executed late
+  const int64_t missed = (now - mDue).nanoseconds() / mPeriod.nanoseconds();
+  mExpirations = static_cast<size_t>(missed) + 1U;
+  mDue = mDue + mPeriod * (missed + 1);
+}
+
+void
+Job::notifyPeriodic(RunnerRaw* runner)
+{
+  PROTEST_ASSERT(mArmed);
+  mCondition->notify(runner);
+}
+
+size_t
+Job::getExpirations() const
+{
+  return mExpirations;
+}
+
 void
 Job::added()
 {
@@ -30,8 +30,8 @@
 namespace protest
 {
 
-template <typename T, size_t N>
-class Heap;
+template <typename T>
+class DynamicHeap;
 
 template <typename T>
 class List;
@@ -49,7 +49,7 @@ class Condition;
 class Job
 {
 public:
-  friend class Heap<Job, 100u>;// TODO magic number
+  friend class DynamicHeap<Job>;
 // ---------------------------------------------------------------------------
   /**
    * @class Listener
@@ -124,6 +124,26 @@ public:
   void
   notExecuted();
 
+  /**
+   * A periodic job stays armed when it is due. Its due is moved to the
+   * next multiple of the period after now, the listener can query how many
+   * periods expired since the last notification.
+   */
+  void
+  setPeriod(time::Duration period);
+
+  bool
+  isPeriodic() const;
+
+  void
+  reschedule(time::TimePoint now);
+
+  void
+  notifyPeriodic(RunnerRaw* runner);
+
+  size_t
+  getExpirations() const;
+
   bool
   isArmed() const;
 
@@ -137,6 +157,8 @@ private:
   bool mArmed;
   Listener* mCondition;
   time::TimePoint mDue;
+  time::Duration mPeriod;
+  size_t mExpirations;
   size_t mIndex;
 };
 
@@ -0,0 +1,139 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/core/link_raw.h"
+#include "protest/core/signal.h"
+
+#include <utility>
+
+namespace protest
+{
+
+namespace core
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class Link
+ * 
+ * A delayed connection to a signal. A value pushed to the link is pushed to
+ * the destination signal after the latency of the link by the receiver of
+ * the group the link ends in. Links are the only way runners of different
+ * groups may interact (see RunnerGroup), their smallest latency is the
+ * lookahead of the context.
+ */
+template <typename T>
+class Link : public LinkRaw
+{
+public:
+  /**
+   * @param context
+   *  the destination signal is used by runners of the context which are
+   *  not part of a group
+   * 
+   * @param latency
+   *  the latency of the link, must be greater than zero
+   */
+  explicit Link(Context& context,
+                Signal<T>& destination,
+                time::Duration latency);
+
+  /**
+   * @param group
+   *  the destination signal is used by runners of this group
+   */
+  explicit Link(RunnerGroup& group,
+                Signal<T>& destination,
+                time::Duration latency);
+
+  Link(const Link&) = delete;
+
+  Link(Link&&) noexcept = delete;
+
+  Link&
+  operator=(const Link&) = delete;
+
+  Link&
+  operator=(Link&&) noexcept = delete;
+
+  ~Link() override = default;
+
+// ---------------------------------------------------------------------------
+  void
+  push(T value);
+
+private:
+  void
+  deliverValue(void* value) override;
+
+  void
+  destroyValue(void* value) override;
+
+  Signal<T>& mDestination;
+};
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Link<T>::Link(Context& context, Signal<T>& destination, time::Duration latency) :
+  LinkRaw(context, latency),
+  mDestination(destination)
+{
+}
+
+template <typename T>
+Link<T>::Link(RunnerGroup& group,
+              Signal<T>& destination,
+              time::Duration latency) :
+  LinkRaw(group, latency),
+  mDestination(destination)
+{
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+void
+Link<T>::push(T value)
+{
+  pushValue(new T(std::move(value)));
+}
+
+template <typename T>
+void
+Link<T>::deliverValue(void* value)
+{
+  mDestination.push(*static_cast<T*>(value));
+}
+
+template <typename T>
+void
+Link<T>::destroyValue(void* value)
+{
+  delete static_cast<T*>(value);
+}
+
+} // namespace core
+
+} // namespace protest
@@ -0,0 +1,191 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/core/link_raw.h"
+#include "protest/core/context.h"
+#include "protest/core/runner_group.h"
+
+#include <algorithm>
+
+using namespace protest::core;
+
+namespace
+{
+
+bool
+isLater(const LinkRaw::Message& lhs, const LinkRaw::Message& rhs)
+{
+  if (lhs.mDue != rhs.mDue)
+  {
+    return lhs.mDue > rhs.mDue;
+  }
+  else if (lhs.mSource != rhs.mSource)
+  {
+    return lhs.mSource > rhs.mSource;
+  }
+  else
+  {
+    return lhs.mSequence > rhs.mSequence;
+  }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+LinkRaw::LinkRaw(Context& context, time::Duration latency) :
+  mContext(context),
+  mReceiver(context.getLinkReceiver(context)),
+  mLatency(latency)
+{
+  context.addLink(this);
+}
+
+LinkRaw::LinkRaw(RunnerGroup& group, time::Duration latency) :
+  mContext(group.getContext()),
+  mReceiver(group.getContext().getLinkReceiver(group)),
+  mLatency(latency)
+{
+  mContext.addLink(this);
+}
+
+// ---------------------------------------------------------------------------
+protest::time::Duration
+LinkRaw::getLatency() const
+{
+  return mLatency;
+}
+
+void
+LinkRaw::pushValue(void* value)
+{
+  auto* sender = mContext.getCurrent();
+  LinkRaw::Message message {sender->now() + mLatency,
+                            mContext.getCurrentGroupIndex(),
+                            mContext.nextSequenceNumber(),
+                            this,
+                            value};
+  mReceiver.send(message);
+}
+
+// ---------------------------------------------------------------------------
+LinkReceiver::LinkReceiver(Context& context) : RunnerRaw(context, "link")
+{
+}
+
+LinkReceiver::LinkReceiver(RunnerGroup& group) : RunnerRaw(group, "link")
+{
+}
+
+LinkReceiver::~LinkReceiver()
+{
+  for (auto& message : mIncoming)
+  {
+    message.mLink->destroyValue(message.mValue);
+  }
+  for (auto& message : mPending)
+  {
+    message.mLink->destroyValue(message.mValue);
+  }
+}
+
+// ---------------------------------------------------------------------------
+void
+LinkReceiver::send(const LinkRaw::Message& message)
+{
+  if (getContext().isParallel())
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mIncoming.push_back(message);
+  }
+  else
+  {
+    accept(message);
+  }
+}
+
+bool
+LinkReceiver::hasIncoming()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return !mIncoming.empty();
+}
+
+protest::time::TimePoint
+LinkReceiver::getEarliestIncoming()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  PROTEST_ASSERT(!mIncoming.empty());
+  auto earliest = mIncoming.front().mDue;
+  for (auto& message : mIncoming)
+  {
+    earliest = std::min(earliest, message.mDue);
+  }
+  return earliest;
+}
+
+void
+LinkReceiver::acceptIncoming()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  for (auto& message : mIncoming)
+  {
+    accept(message);
+  }
+  mIncoming.clear();
+}
+
+// ---------------------------------------------------------------------------
+void
+LinkReceiver::process()
+{
+  while (true)
+  {
+    if (mPending.empty())
+    {
+      waitInternal(time::Duration::infinity());
+    }
+    else if (mPending.front().mDue > now())
+    {
+      // might be woken up earlier by an earlier message
+      waitInternal(mPending.front().mDue - now());
+    }
+    else
+    {
+      std::pop_heap(mPending.begin(), mPending.end(), isLater);
+      const LinkRaw::Message message = mPending.back();
+      mPending.pop_back();
+      message.mLink->deliverValue(message.mValue);
+      message.mLink->destroyValue(message.mValue);
+    }
+  }
+}
+
+void
+LinkReceiver::accept(const LinkRaw::Message& message)
+{
+  PROTEST_ASSERT(message.mDue >= now());
+  mPending.push_back(message);
+  std::push_heap(mPending.begin(), mPending.end(), isLater);
+  wakeup();
+}
@@ -0,0 +1,177 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/core/runner_raw.h"
+#include "protest/time/duration.h"
+#include "protest/time/time_point.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace protest
+{
+
+namespace core
+{
+
+class Context;
+class LinkReceiver;
+class RunnerGroup;
+
+// ---------------------------------------------------------------------------
+/**
+ * @class LinkRaw
+ * 
+ * Type independent part of a Link.
+ */
+class LinkRaw
+{
+public:
+  friend class LinkReceiver;
+
+  /**
+   * @class Message
+   * 
+   * A value on its way through a link. Messages which are due at the same
+   * time are delivered ordered by the index of the sending group and the
+   * order in which they were sent by the group.
+   */
+  struct Message
+  {
+    time::TimePoint mDue;
+    size_t mSource;
+    uint64_t mSequence;
+    LinkRaw* mLink;
+    void* mValue;
+  };
+
+// ---------------------------------------------------------------------------
+  explicit LinkRaw(Context& context, time::Duration latency);
+
+  explicit LinkRaw(RunnerGroup& group, time::Duration latency);
+
+  LinkRaw(const LinkRaw&) = delete;
+
+  LinkRaw(LinkRaw&&) noexcept = delete;
+
+  LinkRaw&
+  operator=(const LinkRaw&) = delete;
+
+  LinkRaw&
+  operator=(LinkRaw&&) noexcept = delete;
+
+  virtual ~LinkRaw() = default;
+
+// ---------------------------------------------------------------------------
+  time::Duration
+  getLatency() const;
+
+protected:
+  /**
+   * @brief pushValue
+   * 
+   * sends the value to the receiving group. The link takes the ownership of
+   * the value.
+   */
+  void
+  pushValue(void* value);
+
+  virtual void
+  deliverValue(void* value) = 0;
+
+  virtual void
+  destroyValue(void* value) = 0;
+
+private:
+  Context& mContext;
+  LinkReceiver& mReceiver;
+  time::Duration mLatency;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class LinkReceiver
+ * 
+ * Runner which delivers the messages of all links ending in one group (or
+ * the context itself). There is at most one receiver per group, it is
+ * created by the context on demand.
+ */
+class LinkReceiver : public RunnerRaw
+{
+public:
+  explicit LinkReceiver(Context& context);
+
+  explicit LinkReceiver(RunnerGroup& group);
+
+  LinkReceiver(const LinkReceiver&) = delete;
+
+  LinkReceiver(LinkReceiver&&) noexcept = delete;
+
+  LinkReceiver&
+  operator=(const LinkReceiver&) = delete;
+
+  LinkReceiver&
+  operator=(LinkReceiver&&) noexcept = delete;
+
+  ~LinkReceiver() override;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief send
+   * 
+   * can be called from any group. While the context is executed in parallel
+   * the messages are buffered until acceptIncoming() is called between two
+   * windows.
+   */
+  void
+  send(const LinkRaw::Message& message);
+
+  bool
+  hasIncoming();
+
+  time::TimePoint
+  getEarliestIncoming();
+
+  void
+  acceptIncoming();
+
+// ---------------------------------------------------------------------------
+  void
+  process() override;
+
+private:
+  void
+  accept(const LinkRaw::Message& message);
+
+  std::mutex mMutex;
+  std::vector<LinkRaw::Message> mIncoming;
+  std::vector<LinkRaw::Message> mPending;
+};
+
+} // namespace core
+
+} // namespace protest
@@ -0,0 +1,293 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/log/operator.h"
+#include "protest/utils/debug.h"
+
+#include <atomic>
+#include <utility>
+
+namespace protest
+{
+
+namespace core
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class Payload
+ *
+ * Immutable, reference counted value for Signal<Payload<T>>. A push copies
+ * the value once into the payload, all sample and queue ports only copy the
+ * handle into their buffers. The value is released when the last handle is
+ * gone, e.g. when the last queue port popped it. The reference count is
+ * atomic, the handles may be copied and released by RunnerGroups running on
+ * different threads.
+ */
+template <typename T>
+class Payload
+{
+public:
+  explicit Payload();
+
+  explicit Payload(const T& value);
+
+  explicit Payload(T&& value);
+
+  Payload(const Payload& other);
+
+  Payload(Payload&& other) noexcept;
+
+  Payload&
+  operator=(const Payload& other);
+
+  Payload&
+  operator=(Payload&& other) noexcept;
+
+  ~Payload();
+
+// ---------------------------------------------------------------------------
+  const T&
+  get() const;
+
+  const T&
+  operator*() const;
+
+  const T*
+  operator->() const;
+
+  bool
+  isEmpty() const;
+
+private:
+  /**
+   * @class Shared
+   */
+  class Shared
+  {
+  public:
+    template <typename U>
+    explicit Shared(U&& value);
+
+    Shared(const Shared&) = delete;
+
+    Shared(Shared&&) noexcept = delete;
+
+    Shared&
+    operator=(const Shared&) = delete;
+
+    Shared&
+    operator=(Shared&&) noexcept = delete;
+
+    ~Shared() = default;
+
+    void
+    increment();
+
+    bool
+    decrement();
+
+    const T mValue;
+
+  private:
+    std::atomic<size_t> mCounter;
+  };
+
+  void
+  release();
+
+  Shared* mShared;
+};
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Payload<T>::Payload() : mShared(nullptr)
+{
+}
+
+template <typename T>
+Payload<T>::Payload(const T& value) : mShared(new Shared(value))
+{
+  mShared->increment();
+}
+
+template <typename T>
+Payload<T>::Payload(T&& value) : mShared(new Shared(std::move(value)))
+{
+  mShared->increment();
+}
+
+template <typename T>
+Payload<T>::Payload(const Payload& other) : mShared(other.mShared)
+{
+  if (mShared != nullptr)
+  {
+    mShared->increment();
+  }
+  else
+  {
+  }
+}
+
+template <typename T>
+Payload<T>::Payload(Payload&& other) noexcept : mShared(other.mShared)
+{
+  other.mShared = nullptr;
+}
+
+template <typename T>
+Payload<T>&
+Payload<T>::operator=(const Payload& other)
+{
+  if (other.mShared != nullptr)
+  {
+    other.mShared->increment();
+  }
+  else
+  {
+  }
+  release();
+  mShared = other.mShared;
+  return *this;
+}
+
+template <typename T>
+Payload<T>&
+Payload<T>::operator=(Payload&& other) noexcept
+{
+  if (this != &other)
+  {
+    release();
+    mShared = other.mShared;
+    other.mShared = nullptr;
+  }
+  else
+  {
+  }
+  return *this;
+}
+
+template <typename T>
+Payload<T>::~Payload()
+{
+  release();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+const T&
+Payload<T>::get() const
+{
+  PROTEST_ASSERT(mShared != nullptr);
+  return mShared->mValue;
+}
+
+template <typename T>
+const T&
+Payload<T>::operator*() const
+{
+  return get();
+}
+
+template <typename T>
+const T*
+Payload<T>::operator->() const
+{
+  return &get();
+}
+
+template <typename T>
+bool
+Payload<T>::isEmpty() const
+{
+  return mShared == nullptr;
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+void
+Payload<T>::release()
+{
+  if (mShared != nullptr && mShared->decrement())
+  {
+    delete mShared;
+  }
+  else
+  {
+  }
+  mShared = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <typename U>
+Payload<T>::Shared::Shared(U&& value) :
+  mValue(std::forward<U>(value)),
+  mCounter(0u)
+{
+}
+
+template <typename T>
+void
+Payload<T>::Shared::increment()
+{
+  // a new handle is always copied from an existing one, no ordering needed
+  mCounter.fetch_add(1u, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool
+Payload<T>::Shared::decrement()
+{
+  // the last handle must see all accesses of the other handles before the
+  // value is deleted
+  return mCounter.fetch_sub(1u, std::memory_order_acq_rel) == 1u;
+}
+
+// ---------------------------------------------------------------------------
+/**
+ * @brief toStringCustom
+ *
+ * Prints the shared value (found via ADL by protest::log).
+ */
+template <typename T>
+log::UniversalStream&
+toStringCustom(log::UniversalStream& stream, const Payload<T>& payload)
+{
+  if (payload.isEmpty())
+  {
+    stream.getPlain() << "<empty>";
+  }
+  else
+  {
+    stream << payload.get();
+  }
+  return stream;
+}
+
+} // namespace core
+
+} // namespace protest
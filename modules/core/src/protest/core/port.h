@@ -26,6 +26,8 @@
 
 #include "protest/core/runner_raw.h"
 
+#include <cstddef>
+
 namespace protest
 {
 
@@ -54,6 +56,58 @@ struct PortTag
 {
 };
 
+// ---------------------------------------------------------------------------
+/**
+ * @class QueueOptions
+ * 
+ * Capacity and overflow policy of a queue port, given at creation time:
+ * 
+ *   mPort = createPort(mSignal, QueueOptions(16u, Overflow::block));
+ * 
+ * A capacity of `unbounded` lets the queue grow, it never overflows then.
+ * The ports ignore the options of a sample port.
+ */
+class QueueOptions
+{
+public:
+  enum class Overflow
+  {
+    // the pushed value is discarded
+    dropNewest,
+    // the oldest value of the queue is discarded to make room
+    dropOldest,
+    // the pushing runner waits until the receiver popped a value
+    block
+  };
+
+  static constexpr size_t unbounded = 0u;
+
+  static constexpr size_t defaultCapacity = 100u;
+
+  constexpr explicit QueueOptions(size_t capacity = defaultCapacity,
+                                  Overflow overflow = Overflow::dropOldest) :
+    mCapacity(capacity),
+    mOverflow(overflow)
+  {
+  }
+
+  constexpr size_t
+  getCapacity() const
+  {
+    return mCapacity;
+  }
+
+  constexpr Overflow
+  getOverflow() const
+  {
+    return mOverflow;
+  }
+
+private:
+  size_t mCapacity;
+  Overflow mOverflow;
+};
+
 // ---------------------------------------------------------------------------
 /**
  * @class AnyPortCreator
@@ -69,7 +123,9 @@ public:
   friend class QueuePort<T>;
   friend class SamplePort<T>;
 
-  explicit AnyPortCreator(core::Signal<T>& signal, RunnerRaw* runner);
+  explicit AnyPortCreator(core::Signal<T>& signal,
+                          RunnerRaw* runner,
+                          QueueOptions options = QueueOptions());
 
   AnyPortCreator(const AnyPortCreator&) = default;
 
@@ -86,13 +142,17 @@ public:
 private:
   core::Signal<T>& mSignal;
   RunnerRaw* mRunner;
+  QueueOptions mOptions;
 };
 
 // ---------------------------------------------------------------------------
 template <typename T>
-AnyPortCreator<T>::AnyPortCreator(core::Signal<T>& signal, RunnerRaw* runner) :
+AnyPortCreator<T>::AnyPortCreator(core::Signal<T>& signal,
+                                  RunnerRaw* runner,
+                                  QueueOptions options) :
   mSignal(signal),
-  mRunner(runner)
+  mRunner(runner),
+  mOptions(options)
 {
 }
 
@@ -26,13 +26,19 @@
 
 #include "protest/core/signal.h"
 #include "protest/core/signal_raw.h"
+#include "protest/core/condition.h"
+#include "protest/core/context.h"
 #include "protest/core/expression.h"
 #include "protest/core/port.h"
-#include "protest/utils/ring_buffer.h"
+#include "protest/core/signal_filter.h"
+#include "protest/utils/dynamic_ring_buffer.h"
 #include "protest/utils/ref_counter.h"
 #include "protest/meta.h"
 #include "protest/utils/can_invoke.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace protest
 {
 
@@ -53,6 +59,11 @@ struct QueuePortTag : public PortTag
 // ---------------------------------------------------------------------------
 /**
  * @class QueuePort
+ * 
+ * Queues the values of a signal until they are popped. The capacity and
+ * what happens to a value pushed into a full queue are given by the
+ * QueueOptions of createPort. The overflows are counted per port and
+ * reported in the summary of the log.
  */
 template <typename T>
 class QueuePort : public QueuePortTag
@@ -104,7 +115,9 @@ public:
     getValue();
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -115,6 +128,7 @@ public:
 
     QueuePortInternal* mInternal;
     Condition* mCondition;
+    ExprNode* mNode;
   };
 
 // ---------------------------------------------------------------------------
@@ -151,7 +165,9 @@ public:
     getValue();
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -162,6 +178,7 @@ public:
 
     QueuePortInternal* mInternal;
     Condition* mCondition;
+    ExprNode* mNode;
   };
 
 // ---------------------------------------------------------------------------
@@ -185,6 +202,30 @@ public:
   pop(protest::meta::CallContext& context =
           protest::meta::CallContext::defaultContext());
 
+  /**
+   * @brief popAll
+   * 
+   * pops all queued values with a single log entry.
+   */
+  std::vector<T>
+  popAll(protest::meta::CallContext& context =
+             protest::meta::CallContext::defaultContext());
+
+  /**
+   * @brief drain
+   * 
+   * pops all queued values and passes them to `function` in order, without
+   * collecting them. Logs a single entry.
+   * 
+   * @return
+   *  the number of popped values
+   */
+  template <typename Function>
+  size_t
+  drain(Function function,
+        protest::meta::CallContext& context =
+            protest::meta::CallContext::defaultContext());
+
   template <typename Function>
   void
   setPrinterFunction(Function& printer);
@@ -205,6 +246,18 @@ public:
   void
   removeFilter(FilterRaw* filter);
 
+  /**
+   * @brief attachFilter
+   * 
+   * lets the port receive only the values accepted by a filter of its
+   * signal (see Signal::addFilter).
+   */
+  void
+  attachFilter(SignalFilterRaw<T>* filter);
+
+  void
+  detachFilter(SignalFilterRaw<T>* filter);
+
   Size
   size();
 
@@ -388,8 +441,9 @@ private:
   {
   public:
     friend class List<QueuePortInternal>;
+    friend class QueuePort<T>;
 
-    explicit QueuePortInternal();
+    explicit QueuePortInternal(QueueOptions options);
 
     QueuePortInternal(const QueuePortInternal&) = delete;
 
@@ -416,6 +470,54 @@ private:
     bool
     insertValue(T value);
 
+    /**
+     * @brief insertValues
+     * 
+     * inserts `values[first]` to `values[count - 1]` of the push with the
+     * number `push` (see Signal::pushBatch) and notifies the listeners
+     * once. Stops before a value which would have to wait for space
+     * (Overflow::block).
+     * 
+     * @return
+     *  the index of the first value which is not consumed
+     */
+    size_t
+    insertValues(const T* values, size_t count, size_t first, uint64_t push);
+
+    template <typename Function>
+    size_t
+    drain(Function& function);
+
+    /**
+     * @brief mustWait
+     * 
+     * @return
+     *  true if the port blocks the pushing runner (Overflow::block and full)
+     */
+    bool
+    mustWait();
+
+    /**
+     * @brief waitForSpace
+     * 
+     * suspends `runner` until the queue is not full anymore. Must not be
+     * called by the runner owning the port, it would never pop the queue.
+     */
+    void
+    waitForSpace(RunnerRaw* runner);
+
+    /**
+     * @brief hasSpace
+     * 
+     * @return
+     *  an expression which becomes true when the queue is not full anymore
+     */
+    auto
+    hasSpace();
+
+    void
+    countBlocked(RunnerRaw* runner);
+
     template <typename Function>
     void
     setPrinterFunction(Function& printer);
@@ -434,6 +536,21 @@ private:
     void
     removeFilter(FilterRaw* filter);
 
+    void
+    attachFilter(SignalFilterRaw<T>* filter);
+
+    void
+    detachFilter(SignalFilterRaw<T>* filter);
+
+    /**
+     * @brief passes
+     * 
+     * @return
+     *  true if all attached signal filters accept `values[index]`
+     */
+    bool
+    passes(const T* values, size_t count, size_t index, uint64_t push);
+
     bool
     isAvailable();
 
@@ -450,8 +567,22 @@ private:
     remove(Listener* listener);
 
   private:
-    // TODO size is fixed here
-    RingBuffer<T, 100u> mRingBuffer;
+    bool
+    accept(T& value);
+
+    // false if the value is dropped (Overflow::dropNewest)
+    bool
+    store(const T& value);
+
+    void
+    notifyListeners();
+
+    void
+    logPop(const char* text, meta::CallContext& context);
+
+    DynamicRingBuffer<T> mRingBuffer;
+    QueueOptions::Overflow mOverflow;
+    Context::QueueOverflow mOverflows;
     SignalRaw* mSignal;
     RunnerRaw* mRunner;
     QueuePortInternal* mNext;
@@ -459,6 +590,7 @@ private:
     List<Listener> mListeners;
     List<CallbackRaw> mCallbacks;
     List<FilterRaw> mFilters;
+    std::vector<SignalFilterRaw<T>*> mSignalFilters;
 
     void (*mPrinter)(std::ostream&, T&);
   };
@@ -474,7 +606,8 @@ private:
 template <typename T>
 QueuePort<T>::Size::Size(QueuePortInternal* port) :
   mInternal(port),
-  mCondition(nullptr)
+  mCondition(nullptr),
+  mNode(nullptr)
 {
   mInternal->increment();
 }
@@ -482,7 +615,8 @@ QueuePort<T>::Size::Size(QueuePortInternal* port) :
 template <typename T>
 QueuePort<T>::Size::Size(const Size& other) :
   mInternal(other.mInternal),
-  mCondition(other.mCondition)
+  mCondition(other.mCondition),
+  mNode(other.mNode)
 {
   mInternal->increment();
 }
@@ -517,10 +651,13 @@ QueuePort<T>::Size::getValue()
 // ---------------------------------------------------------------------------
 template <typename T>
 void
-QueuePort<T>::Size::conditionEnable(RunnerRaw* runner, Condition* condition)
+QueuePort<T>::Size::conditionEnable(RunnerRaw* runner,
+                                    Condition* condition,
+                                    ExprNode* parent)
 {
   assert(mInternal);
   mCondition = condition;
+  mNode = parent;
   mInternal->add(this);
 }
 
@@ -537,6 +674,7 @@ void
 QueuePort<T>::Size::notify()
 {
   assert(mCondition);
+  ExprNode::invalidate(mNode);
   mCondition->notifyListener();
 }
 
@@ -544,7 +682,8 @@ QueuePort<T>::Size::notify()
 template <typename T>
 QueuePort<T>::IsAvailable::IsAvailable(QueuePortInternal* port) :
   mInternal(port),
-  mCondition(nullptr)
+  mCondition(nullptr),
+  mNode(nullptr)
 {
   mInternal->increment();
 }
@@ -552,7 +691,8 @@ QueuePort<T>::IsAvailable::IsAvailable(QueuePortInternal* port) :
 template <typename T>
 QueuePort<T>::IsAvailable::IsAvailable(const IsAvailable& other) :
   mInternal(other.mInternal),
-  mCondition(other.mCondition)
+  mCondition(other.mCondition),
+  mNode(other.mNode)
 {
   mInternal->increment();
 }
@@ -588,10 +728,12 @@ QueuePort<T>::IsAvailable::getValue()
 template <typename T>
 void
 QueuePort<T>::IsAvailable::conditionEnable(RunnerRaw* /* runner */,
-                                           Condition* condition)
+                                           Condition* condition,
+                                           ExprNode* parent)
 {
   assert(mInternal);
   mCondition = condition;
+  mNode = parent;
   mInternal->add(this);
 }
 
@@ -608,6 +750,7 @@ void
 QueuePort<T>::IsAvailable::notify()
 {
   assert(mCondition);
+  ExprNode::invalidate(mNode);
   mCondition->notifyListener();
 }
 
@@ -622,7 +765,7 @@ QueuePort<T>&
 QueuePort<T>::operator=(const core::AnyPortCreator<T>& info)
 {
   assert(mInternal == nullptr);
-  mInternal = new QueuePortInternal();
+  mInternal = new QueuePortInternal(info.mOptions);
   mInternal->increment();
   assert(mInternal);
   mInternal->bindTo(info.mSignal, info.mRunner);
@@ -649,20 +792,36 @@ QueuePort<T>::pop(protest::meta::CallContext& context)
 {
   assert(mInternal);
   auto value = mInternal->getValue();
-  auto runner = mInternal->mRunner;
-  auto& logger = runner->getLogger();
-  logger.startLog("POP ",
-                  runner->getName(),
-                  context.getUnit().getFileName(),
-                  context.getLine(),
-                  runner->now());
-  logger.getStream().mOutput << "Pop value from '" << context.getObjectName()
-                             << "':\n";
+  auto& logger = mInternal->mRunner->getLogger();
+  mInternal->logPop("Pop value from '", context);
   logger.getStream() << value;
   logger.getStream().mOutput << "\n";
   return value;
 }
 
+template <typename T>
+std::vector<T>
+QueuePort<T>::popAll(protest::meta::CallContext& context)
+{
+  std::vector<T> values;
+  values.reserve(mInternal->size());
+  drain([&](T& value) { values.push_back(std::move(value)); }, context);
+  return values;
+}
+
+template <typename T>
+template <typename Function>
+size_t
+QueuePort<T>::drain(Function function, protest::meta::CallContext& context)
+{
+  assert(mInternal);
+  auto& logger = mInternal->mRunner->getLogger();
+  mInternal->logPop("Pop all values from '", context);
+  const size_t count = mInternal->drain(function);
+  logger.getStream().mOutput << count << " values\n";
+  return count;
+}
+
 template <typename T>
 template <typename Function>
 void
@@ -707,6 +866,22 @@ QueuePort<T>::removeFilter(FilterRaw* filter)
   return mInternal->removeFilter(filter);
 }
 
+template <typename T>
+void
+QueuePort<T>::attachFilter(SignalFilterRaw<T>* filter)
+{
+  assert(mInternal);
+  mInternal->attachFilter(filter);
+}
+
+template <typename T>
+void
+QueuePort<T>::detachFilter(SignalFilterRaw<T>* filter)
+{
+  assert(mInternal);
+  mInternal->detachFilter(filter);
+}
+
 template <typename T>
 typename QueuePort<T>::Size
 QueuePort<T>::size()
@@ -819,7 +994,10 @@ QueuePort<T>::Listener::Listener() :
 
 // ---------------------------------------------------------------------------
 template <typename T>
-QueuePort<T>::QueuePortInternal::QueuePortInternal() :
+QueuePort<T>::QueuePortInternal::QueuePortInternal(QueueOptions options) :
+  mRingBuffer(options.getCapacity()),
+  mOverflow(options.getOverflow()),
+  mOverflows {"", 0u, 0u},
   mSignal(nullptr),
   mNext(nullptr),
   mPrinter(nullptr)
@@ -830,6 +1008,7 @@ template <typename T>
 QueuePort<T>::QueuePortInternal::~QueuePortInternal()
 {
   mSignal->removeQueuePort(this);
+  mRunner->getContext().removeQueueOverflow(&mOverflows);
 
   // should not be deleted if someone has still a ref to this object
   // PROTEST_ASSERT(mListeners.numberOfElements() == 0);
@@ -863,6 +1042,17 @@ QueuePort<T>::QueuePortInternal::bindTo(core::Signal<T>& signal,
   mSignal = &signal;
   mSignal->bindQueuePort(this);
   mRunner = coroutine;
+  // <runner>: <signal> if the signal has a name
+  const char* signalName = mSignal->getSignalInfo().getObjectName();
+  mOverflows.mName = mRunner->getName();
+  if (signalName != nullptr && signalName[0] != '\0')
+  {
+    mOverflows.mName += std::string(": ") + signalName;
+  }
+  else
+  {
+  }
+  mRunner->getContext().addQueueOverflow(&mOverflows);
 }
 
 template <typename T>
@@ -877,7 +1067,10 @@ template <typename T>
 T
 QueuePort<T>::QueuePortInternal::getValue()
 {
-  return mRingBuffer.pop();
+  T value = mRingBuffer.pop();
+  // the size changed, also wakes up the runners waiting for space
+  notifyListeners();
+  return value;
 }
 
 template <typename T>
@@ -885,48 +1078,192 @@ bool
 QueuePort<T>::QueuePortInternal::insertValue(T value)
 {
   bool lostAElement = false;
-  bool accepted = true;
 
   auto& context = mRunner->getContext();
   context.setCurrentVirtual(mRunner);
 
-  auto filter = mFilters.begin();
-  while (filter != mFilters.end())
+  if (accept(value))
   {
-    if (!filter->handle(value))
+    lostAElement = mRingBuffer.isFull();
+    if (store(value))
     {
-      accepted = false;
+      notifyListeners();
+      auto callbacks = mCallbacks.begin();
+      while (callbacks != mCallbacks.end())
+      {
+        callbacks->handle(value);
+        ++callbacks;
+      }
     }
     else
     {
-      // fine
     }
-    ++filter;
   }
-  if (accepted)
+  else
   {
-    lostAElement = mRingBuffer.isFull();
-    mRingBuffer.push(value);
-    auto iter = mListeners.begin();
-    while (iter != mListeners.end())
+  }
+
+  context.setCurrentVirtual(nullptr);
+
+  return lostAElement;
+}
+
+template <typename T>
+size_t
+QueuePort<T>::QueuePortInternal::insertValues(const T* values,
+                                              size_t count,
+                                              size_t first,
+                                              uint64_t push)
+{
+  size_t consumed = first;
+  bool inserted = false;
+
+  auto& context = mRunner->getContext();
+  context.setCurrentVirtual(mRunner);
+
+  while (consumed < count && !mustWait())
+  {
+    T value = values[consumed];
+    const bool passed = passes(values, count, consumed, push);
+    consumed++;
+    if (passed && accept(value) && store(value))
     {
-      iter->notify();
-      ++iter;
+      inserted = true;
+      auto callbacks = mCallbacks.begin();
+      while (callbacks != mCallbacks.end())
+      {
+        callbacks->handle(value);
+        ++callbacks;
+      }
     }
-    auto callbacks = mCallbacks.begin();
-    while (callbacks != mCallbacks.end())
+    else
     {
-      callbacks->handle(value);
-      ++callbacks;
     }
   }
+
+  if (inserted)
+  {
+    notifyListeners();
+  }
   else
   {
   }
 
   context.setCurrentVirtual(nullptr);
 
-  return lostAElement;
+  return consumed;
+}
+
+template <typename T>
+template <typename Function>
+size_t
+QueuePort<T>::QueuePortInternal::drain(Function& function)
+{
+  size_t count = 0;
+  while (mRingBuffer.isAvailable())
+  {
+    T value = mRingBuffer.pop();
+    function(value);
+    count++;
+  }
+  if (count > 0)
+  {
+    // the size changed, also wakes up the runners waiting for space
+    notifyListeners();
+  }
+  else
+  {
+  }
+  return count;
+}
+
+template <typename T>
+bool
+QueuePort<T>::QueuePortInternal::accept(T& value)
+{
+  // stops at the first rejection
+  bool accepted = true;
+  auto filter = mFilters.begin();
+  while (accepted && filter != mFilters.end())
+  {
+    accepted = filter->handle(value);
+    ++filter;
+  }
+  return accepted;
+}
+
+template <typename T>
+bool
+QueuePort<T>::QueuePortInternal::store(const T& value)
+{
+  bool stored = true;
+  if (mRingBuffer.isFull() &&
+      mOverflow == QueueOptions::Overflow::dropNewest)
+  {
+    stored = false;
+    mOverflows.mDropped++;
+  }
+  else
+  {
+    if (mRingBuffer.isFull())
+    {
+      // the pushing runner waits for space before storing into a blocking
+      // port
+      PROTEST_ASSERT(mOverflow == QueueOptions::Overflow::dropOldest);
+      mOverflows.mDropped++;
+      mRingBuffer.pop();
+    }
+    else
+    {
+    }
+    mRingBuffer.push(value);
+  }
+  return stored;
+}
+
+template <typename T>
+bool
+QueuePort<T>::QueuePortInternal::mustWait()
+{
+  return mOverflow == QueueOptions::Overflow::block && mRingBuffer.isFull();
+}
+
+template <typename T>
+auto
+QueuePort<T>::QueuePortInternal::hasSpace()
+{
+  return Size(this) < mRingBuffer.capacity();
+}
+
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::waitForSpace(RunnerRaw* runner)
+{
+  if (mustWait())
+  {
+    countBlocked(runner);
+    auto expr = hasSpace();
+    ExprCondition<decltype(expr)> condition(runner, expr, runner);
+    condition.enable();
+    // another pusher could have filled the queue again before this runner
+    // was resumed
+    while (mustWait())
+    {
+      runner->RunnerRaw::waitInternal(time::Duration::infinity(), &condition);
+    }
+    condition.disable();
+  }
+  else
+  {
+  }
+}
+
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::countBlocked(RunnerRaw* runner)
+{
+  PROTEST_ASSERT(runner != mRunner);
+  mOverflows.mBlocked++;
 }
 
 template <typename T>
@@ -975,6 +1312,39 @@ QueuePort<T>::QueuePortInternal::removeFilter(FilterRaw* filter)
   delete filter;
 }
 
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::attachFilter(SignalFilterRaw<T>* filter)
+{
+  mSignalFilters.push_back(filter);
+}
+
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::detachFilter(SignalFilterRaw<T>* filter)
+{
+  mSignalFilters.erase(
+      std::remove(mSignalFilters.begin(), mSignalFilters.end(), filter),
+      mSignalFilters.end());
+}
+
+template <typename T>
+bool
+QueuePort<T>::QueuePortInternal::passes(const T* values,
+                                        size_t count,
+                                        size_t index,
+                                        uint64_t push)
+{
+  bool accepted = true;
+  auto filter = mSignalFilters.begin();
+  while (accepted && filter != mSignalFilters.end())
+  {
+    accepted = (*filter)->accepts(values, count, index, push);
+    ++filter;
+  }
+  return accepted;
+}
+
 template <typename T>
 bool
 QueuePort<T>::QueuePortInternal::isAvailable()
@@ -993,7 +1363,34 @@ template <typename T>
 void
 QueuePort<T>::QueuePortInternal::clear()
 {
-  return mRingBuffer.clear();
+  mRingBuffer.clear();
+  notifyListeners();
+}
+
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::logPop(const char* text,
+                                        meta::CallContext& context)
+{
+  auto& logger = mRunner->getLogger();
+  logger.startLog("POP ",
+                  mRunner->getName(),
+                  context.getUnit().getFileName(),
+                  context.getLine(),
+                  mRunner->now());
+  logger.getStream().mOutput << text << context.getObjectName() << "':\n";
+}
+
+template <typename T>
+void
+QueuePort<T>::QueuePortInternal::notifyListeners()
+{
+  auto iter = mListeners.begin();
+  while (iter != mListeners.end())
+  {
+    iter->notify();
+    ++iter;
+  }
 }
 
 template <typename T>
@@ -1016,7 +1413,7 @@ QueuePort<T>::QueuePort(core::Signal<T>& signal, RunnerRaw* coroutine) :
   mInternal(nullptr)
 {
   assert(mInternal == nullptr);
-  mInternal = new QueuePortInternal();
+  mInternal = new QueuePortInternal(QueueOptions());
   mInternal->increment();
   assert(mInternal);
   mInternal->bindTo(signal, coroutine);
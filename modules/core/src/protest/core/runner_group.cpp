@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/core/runner_group.h"
+#include "protest/core/context.h"
+
+#include <cstdlib>
+
+using namespace protest::core;
+
+// ---------------------------------------------------------------------------
+// NOLINTNEXTLINE
+thread_local RunnerGroup* RunnerGroup::currentGroup = nullptr;
+
+// ---------------------------------------------------------------------------
+RunnerGroup*
+RunnerGroup::getCurrentGroup()
+{
+  return currentGroup;
+}
+
+// ---------------------------------------------------------------------------
+RunnerGroup::RunnerGroup(Context& context) :
+  mContext(context),
+  mIndex(context.getNumberOfGroups() + 1),
+  mNumberOfSentMessages(0),
+  mRandomState(static_cast<unsigned int>(mIndex)),
+  mCurrentVirtual(nullptr),
+  mNext(nullptr)
+{
+  setStackPainting(context.isStackPainting());
+  context.addGroup(this);
+}
+
+// ---------------------------------------------------------------------------
+Context&
+RunnerGroup::getContext()
+{
+  return mContext;
+}
+
+size_t
+RunnerGroup::getIndex() const
+{
+  return mIndex;
+}
+
+int
+RunnerGroup::random()
+{
+  // NOLINTNEXTLINE
+  return rand_r(&mRandomState);
+}
@@ -0,0 +1,131 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/coro/scheduler.h"
+
+#include <cstdint>
+
+namespace protest
+{
+
+template <typename T>
+class List;
+
+namespace core
+{
+
+class Context;
+class RunnerRaw;
+
+// ---------------------------------------------------------------------------
+/**
+ * @class RunnerGroup
+ * 
+ * A group of runners with its own scheduler and logical clock. If a context
+ * has groups, Context::run() executes every group on its own thread (the
+ * runners which are not part of a group are executed by the context itself
+ * on the calling thread).
+ * 
+ * The groups are synchronized conservatively: they are executed in windows
+ * of simulated time whose size is the lookahead of the context, which is
+ * the smallest latency of all links (see Link). Within a window no group
+ * can receive a message from another one, so the groups do not have to wait
+ * for each other. After every window the links are delivered and the log
+ * output of the groups is written in the order of their creation, so the
+ * output does not depend on the scheduling of the threads.
+ * 
+ * Runners of different groups must only interact via links. Signals, ports,
+ * values and conditions must only be used within one group. random() and
+ * coinFlip() use one random sequence per group.
+ */
+class RunnerGroup : public coro::Scheduler
+{
+public:
+  friend class Context;
+  friend class List<RunnerGroup>;
+
+  /**
+   * @brief getCurrentGroup
+   * 
+   * @return
+   *  the group which is executed by the calling thread or nullptr if the
+   *  thread does not execute a group
+   */
+  static RunnerGroup*
+  getCurrentGroup();
+
+// ---------------------------------------------------------------------------
+  explicit RunnerGroup(Context& context);
+
+  RunnerGroup(const RunnerGroup&) = delete;
+
+  RunnerGroup(RunnerGroup&&) noexcept = delete;
+
+  RunnerGroup&
+  operator=(const RunnerGroup&) = delete;
+
+  RunnerGroup&
+  operator=(RunnerGroup&&) noexcept = delete;
+
+  ~RunnerGroup() = default;
+
+// ---------------------------------------------------------------------------
+  Context&
+  getContext();
+
+  /**
+   * @brief getIndex
+   * 
+   * @return
+   *  the index of the group in the context. The context itself has the index
+   *  zero, the groups are numbered in the order of their creation.
+   */
+  size_t
+  getIndex() const;
+
+  /**
+   * @brief random
+   * 
+   * @return
+   *  the next number of the random sequence of the group (like rand())
+   */
+  int
+  random();
+
+private:
+  static thread_local RunnerGroup* currentGroup;
+
+  Context& mContext;
+  size_t mIndex;
+  uint64_t mNumberOfSentMessages;
+  unsigned int mRandomState;
+  RunnerRaw* mCurrentVirtual;
+  RunnerGroup* mNext;
+};
+
+} // namespace core
+
+} // namespace protest
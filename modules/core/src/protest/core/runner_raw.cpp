@@ -24,6 +24,7 @@
 
 #include "protest/core/runner_raw.h"
 #include "protest/core/condition.h"
+#include "protest/core/runner_group.h"
 #include "protest/core/section.h"
 #include "protest/utils/log.h"
 
@@ -39,34 +40,77 @@ RunnerRaw::Userdata::Userdata(size_t identifier) : mId(identifier)
 
 // ---------------------------------------------------------------------------
 RunnerRaw::RunnerRaw(const char* name) :
-  coro::Coroutine(*Context::getCurrentContext()),
+  RunnerRaw(Context::getCurrentContext()->getStackSize(name), name)
+{
+}
+
+RunnerRaw::RunnerRaw(core::Context& context, const char* name) :
+  RunnerRaw(context, context.getStackSize(name), name)
+{
+}
+
+RunnerRaw::RunnerRaw(size_t stackSize, const char* name) :
+  coro::Coroutine(*Context::getCurrentContext(), stackSize),
+  mPeriodicJobs(0u),
+  mContext(*Context::getCurrentContext()),
   mCondition(nullptr),
   mName(name),
   mWakeUpEvent(false),
   mNext(nullptr),
   mTestSteps(1),
   mCurrentTestStepName(nullptr),
-  mUserdata({})
+  mUserdata({}),
+  mInvariantCheck(this)
 {
   mUserdata.fill(nullptr);
   Context::getCurrentContext()->addRunner(this);
 }
 
-RunnerRaw::RunnerRaw(core::Context& context, const char* name) :
-  coro::Coroutine(context),
+RunnerRaw::RunnerRaw(core::Context& context,
+                     size_t stackSize,
+                     const char* name) :
+  coro::Coroutine(context, stackSize),
+  mPeriodicJobs(0u),
+  mContext(context),
   mCondition(nullptr),
   mName(name),
   mWakeUpEvent(false),
   mNext(nullptr),
   mTestSteps(1),
   mCurrentTestStepName(nullptr),
-  mUserdata({})
+  mUserdata({}),
+  mInvariantCheck(this)
 {
   mUserdata.fill(nullptr);
   context.Scheduler::addThread(this);
   context.addRunner(this);
 }
 
+RunnerRaw::RunnerRaw(core::RunnerGroup& group, const char* name) :
+  RunnerRaw(group, group.getContext().getStackSize(name), name)
+{
+}
+
+RunnerRaw::RunnerRaw(core::RunnerGroup& group,
+                     size_t stackSize,
+                     const char* name) :
+  coro::Coroutine(group, stackSize),
+  mPeriodicJobs(0u),
+  mContext(group.getContext()),
+  mCondition(nullptr),
+  mName(name),
+  mWakeUpEvent(false),
+  mNext(nullptr),
+  mTestSteps(1),
+  mCurrentTestStepName(nullptr),
+  mUserdata({}),
+  mInvariantCheck(this)
+{
+  mUserdata.fill(nullptr);
+  group.addThread(this);
+  mContext.addRunner(this);
+}
+
 RunnerRaw::~RunnerRaw()
 {
   assert(mPriorityQueue.isEmpty());
@@ -114,6 +158,13 @@ void
 RunnerRaw::add(Job& job)
 {
   mPriorityQueue.push(&job);
+  if (job.isPeriodic())
+  {
+    mPeriodicJobs++;
+  }
+  else
+  {
+  }
   job.added();
   if (isWaiting())
   {
@@ -141,6 +192,13 @@ RunnerRaw::remove(Job& job)
     job.notExecuted();
   }
 
+  if (job.isPeriodic())
+  {
+    mPeriodicJobs--;
+  }
+  else
+  {
+  }
   job.removed();
 
   if (isWaiting())
@@ -159,6 +217,12 @@ RunnerRaw::coroRun()
   process();
   // this makes sure that all timers etc. are executed before destroying the
   // coroutine
+  while (hasOneShotJobs())
+  {
+    coro::Coroutine::coroWait(getTimeToSleep(time::Duration::infinity()));
+    executeDueJobs();
+  }
+  cancelPeriodicJobs();
   waitInternal(time::Duration::infinity());
   coroExit();
 }
@@ -183,33 +247,12 @@ RunnerRaw::waitInternal(time::Duration timeout)
   // might be true from a previouse call to wakeInternal
   mWakeUpEvent = false;
 
-  while (timeout > time::Duration::zero() &&
-         (mCondition == nullptr || !mCondition->isFulfilled()) && !mWakeUpEvent)
+  while (timeout > time::Duration::zero() && !isWaitFulfilled())
   {
     auto startAt = now();
-    auto timeToSleep = timeout;
-
-    if (mPriorityQueue.isAvailable())
-    {
-      Job* job = mPriorityQueue.peek();
-      PROTEST_ASSERT(job->timeTilDue(now()) >= time::Duration::zero());
-
-      if (timeout >= job->timeTilDue(now()))
-      {
-        timeToSleep = job->timeTilDue(now());
-      }
-      else
-      {
-        // timeout is fine
-      }
-    }
-    else
-    {
-      // timeout is fine
-    }
 
     assert(mWakeUpEvent == false);
-    coro::Coroutine::coroWait(timeToSleep);
+    coro::Coroutine::coroWait(getTimeToSleep(timeout));
 
     // if sleeping for ever, do not set a new timeout
     if (timeout != time::Duration::infinity())
@@ -218,17 +261,10 @@ RunnerRaw::waitInternal(time::Duration timeout)
       PROTEST_ASSERT(timeout >= time::Duration::zero());
     }
 
-    while (mPriorityQueue.isAvailable() &&
-           mPriorityQueue.peek()->timeTilDue(now()) == time::Duration::zero())
-    {
-      Job* job = mPriorityQueue.pop();
-      job->execute(this);
-      job->removed();
-    }
+    executeDueJobs();
   }
 
-  const bool gotTimeout =
-      ((mCondition == nullptr || !mCondition->isFulfilled()) && !mWakeUpEvent);
+  const bool gotTimeout = !isWaitFulfilled();
   return gotTimeout;
 }
 
@@ -310,8 +346,89 @@ RunnerRaw::getLogger()
 protest::core::Context&
 RunnerRaw::getContext()
 {
-  // NOLINTNEXTLINE
-  return static_cast<protest::core::Context&>(getScheduler());
+  return mContext;
+}
+
+InvariantCheck&
+RunnerRaw::getInvariantCheck()
+{
+  return mInvariantCheck;
+}
+
+// ---------------------------------------------------------------------------
+bool
+RunnerRaw::isWaitFulfilled()
+{
+  return (mCondition != nullptr && mCondition->isFulfilled()) || mWakeUpEvent;
+}
+
+protest::time::Duration
+RunnerRaw::getTimeToSleep(time::Duration timeout)
+{
+  auto timeToSleep = timeout;
+
+  if (mPriorityQueue.isAvailable())
+  {
+    Job* job = mPriorityQueue.peek();
+    PROTEST_ASSERT(job->timeTilDue(now()) >= time::Duration::zero());
+
+    if (timeout >= job->timeTilDue(now()))
+    {
+      timeToSleep = job->timeTilDue(now());
+    }
+    else
+    {
+      // timeout is fine
+    }
+  }
+  else
+  {
+    // timeout is fine
+  }
+  return timeToSleep;
+}
+
+void
+RunnerRaw::executeDueJobs()
+{
+  while (mPriorityQueue.isAvailable() &&
+         mPriorityQueue.peek()->timeTilDue(now()) == time::Duration::zero())
+  {
+    Job* job = mPriorityQueue.peek();
+    if (job->isPeriodic())
+    {
+      // rescheduled in place, the job is neither removed nor added again
+      job->reschedule(now());
+      mPriorityQueue.update(job);
+      job->notifyPeriodic(this);
+    }
+    else
+    {
+      mPriorityQueue.pop();
+      job->execute(this);
+      job->removed();
+    }
+  }
+}
+
+bool
+RunnerRaw::hasOneShotJobs()
+{
+  return mPriorityQueue.numberOfElements() > mPeriodicJobs;
+}
+
+void
+RunnerRaw::cancelPeriodicJobs()
+{
+  PROTEST_ASSERT(!hasOneShotJobs());
+  while (mPriorityQueue.isAvailable())
+  {
+    Job* job = mPriorityQueue.peek();
+    mPriorityQueue.pop();
+    mPeriodicJobs--;
+    job->notExecuted();
+    job->removed();
+  }
 }
 
 // ---------------------------------------------------------------------------
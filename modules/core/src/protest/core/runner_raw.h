@@ -26,10 +26,11 @@
 
 #include "protest/core/job.h"
 #include "protest/coro/coroutine.h"
-#include "protest/utils/heap.h"
+#include "protest/utils/dynamic_heap.h"
 #include "protest/log/logger.h"
 #include "protest/core/condition.h"
 #include "protest/core/context.h"
+#include "protest/core/invariant.h"
 
 #include <array>
 
@@ -42,6 +43,8 @@ namespace core
 {
 
 class Condition;
+class RunnerGroup;
+class StacklessRunner;
 
 // ---------------------------------------------------------------------------
 /**
@@ -53,6 +56,7 @@ public:
   static constexpr size_t numberOfPerRunnerData = 10;
 
   friend class List<RunnerRaw>;
+  friend class StacklessRunner;
 
 // ---------------------------------------------------------------------------
   /**
@@ -82,10 +86,39 @@ public:
   };
 
 // ---------------------------------------------------------------------------
+  /**
+   * @param name
+   *  name of the runner. The size of the stack is taken from the context
+   *  (see Context::getStackSize).
+   */
   explicit RunnerRaw(const char* name);
 
   explicit RunnerRaw(core::Context& context, const char* name);
 
+  /**
+   * @param stackSize
+   *  size of the stack of the runner in bytes (see
+   *  coro::StackAllocator::allocate)
+   * 
+   * @param name
+   *  name of the runner
+   */
+  explicit RunnerRaw(size_t stackSize, const char* name);
+
+  explicit RunnerRaw(core::Context& context,
+                     size_t stackSize,
+                     const char* name);
+
+  /**
+   * @param group
+   *  the runner is executed by the scheduler of the group (see RunnerGroup)
+   */
+  explicit RunnerRaw(core::RunnerGroup& group, const char* name);
+
+  explicit RunnerRaw(core::RunnerGroup& group,
+                     size_t stackSize,
+                     const char* name);
+
   RunnerRaw(const RunnerRaw&) = delete;
 
   RunnerRaw(RunnerRaw&&) noexcept = delete;
@@ -153,6 +186,9 @@ public:
   core::Context&
   getContext();
 
+  InvariantCheck&
+  getInvariantCheck();
+
 // ---------------------------------------------------------------------------
   /**
    * @brief getUserdataAs
@@ -192,8 +228,30 @@ private:
   void
   notify() override;
 
-  // TODO (jreinking) magic number
-  Heap<Job, 100> mPriorityQueue;
+  // parts of waitInternal (shared with StacklessRunner::waitInternal)
+  bool
+  isWaitFulfilled();
+
+  time::Duration
+  getTimeToSleep(time::Duration timeout);
+
+  void
+  executeDueJobs();
+
+  // parts of coroRun (shared with StacklessRunner::body). Periodic jobs
+  // would keep a finished runner alive forever, so it only waits for the
+  // other jobs and cancels the periodic ones afterwards.
+  bool
+  hasOneShotJobs();
+
+  void
+  cancelPeriodicJobs();
+
+  // armed jobs (timers, stopwatch operators, ...) ordered by their due
+  DynamicHeap<Job> mPriorityQueue;
+  // number of the periodic jobs in mPriorityQueue
+  size_t mPeriodicJobs;
+  core::Context& mContext;
   Condition* mCondition;
   const char* mName;
   bool mWakeUpEvent;
@@ -203,6 +261,7 @@ private:
   uint32_t mTestSteps;
   Section* mCurrentTestStepName;
   std::array<Userdata*, numberOfPerRunnerData> mUserdata;
+  InvariantCheck mInvariantCheck;
 };
 
 // ---------------------------------------------------------------------------
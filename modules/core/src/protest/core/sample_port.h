@@ -25,10 +25,16 @@
 #pragma once
 
 #include "protest/core/signal_raw.h"
+#include "protest/core/job.h"
 #include "protest/core/port.h"
+#include "protest/core/sample_window.h"
+#include "protest/core/signal_filter.h"
 #include "protest/utils/can_invoke.h"
 #include "protest/utils/ref_counter.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace protest
 {
 
@@ -54,6 +60,7 @@ private:
   class Listener;
   class CallbackRaw;
   class FilterRaw;
+  class History;
 
 public:
   friend class Signal<T>;
@@ -83,7 +90,9 @@ public:
 
 // ---------------------------------------------------------------------------
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -97,10 +106,70 @@ public:
   private:
     SamplePortInternal* mInternal;
     Condition* mCondition;
+    ExprNode* mNode;
   };
 
   using Type = SamplePortExpr;
 
+// ---------------------------------------------------------------------------
+  /**
+   * @class WindowExpr
+   * 
+   * An aggregate over the history of the port (see setHistory). Changes
+   * with every sample and when samples expire.
+   */
+  template <WindowAggregate Aggregate>
+  class WindowExpr : public Listener, public CopyExprTag
+  {
+  public:
+    using Type = std::conditional_t<
+        Aggregate == WindowAggregate::count,
+        size_t,
+        std::conditional_t<
+            Aggregate == WindowAggregate::mean,
+            double,
+            std::conditional_t<Aggregate == WindowAggregate::sum,
+                               typename SampleWindow<T>::Sum,
+                               T>>>;
+
+    explicit WindowExpr(SamplePortInternal* port);
+
+    WindowExpr(const WindowExpr&);
+
+    WindowExpr(WindowExpr&&) noexcept = delete;
+
+    WindowExpr&
+    operator=(const WindowExpr&) = delete;
+
+    WindowExpr&
+    operator=(WindowExpr&&) noexcept = delete;
+
+    ~WindowExpr();
+
+// ---------------------------------------------------------------------------
+    operator Type();
+
+// ---------------------------------------------------------------------------
+    void
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
+
+    void
+    conditionDisable();
+
+    void
+    notify();
+
+    Type
+    getValue();
+
+  private:
+    SamplePortInternal* mInternal;
+    Condition* mCondition;
+    ExprNode* mNode;
+  };
+
 // ---------------------------------------------------------------------------
   /**
    * @class Converter
@@ -136,6 +205,32 @@ public:
 // ---------------------------------------------------------------------------
   operator T();
 
+  /**
+   * @brief setHistory
+   * 
+   * keeps the last `samples` values which are younger than `window` (only
+   * for arithmetic types). Enables count(), sum(), min(), max() and
+   * mean(), which are maintained in O(1) per sample.
+   */
+  void
+  setHistory(size_t samples,
+             time::Duration window = time::Duration::infinity());
+
+  WindowExpr<WindowAggregate::count>
+  count();
+
+  WindowExpr<WindowAggregate::sum>
+  sum();
+
+  WindowExpr<WindowAggregate::min>
+  min();
+
+  WindowExpr<WindowAggregate::max>
+  max();
+
+  WindowExpr<WindowAggregate::mean>
+  mean();
+
   template <typename Function>
   void
   setPrinterFunction(Function& printer);
@@ -156,6 +251,18 @@ public:
   void
   removeFilter(FilterRaw* filter);
 
+  /**
+   * @brief attachFilter
+   * 
+   * lets the port receive only the values accepted by a filter of its
+   * signal (see Signal::addFilter).
+   */
+  void
+  attachFilter(SignalFilterRaw<T>* filter);
+
+  void
+  detachFilter(SignalFilterRaw<T>* filter);
+
   const char*
   getName();
 
@@ -289,6 +396,48 @@ private:
     Function mFunction;
   };
 
+  /**
+   * @class History
+   * 
+   * The window of the samples and the job which expires them.
+   */
+  class History final : public Job::Listener
+  {
+  public:
+    friend class SamplePortInternal;
+
+    explicit History(SamplePortInternal* internal,
+                     size_t samples,
+                     time::Duration window);
+
+    History(const History&) = delete;
+
+    History(History&&) noexcept = delete;
+
+    History&
+    operator=(const History&) = delete;
+
+    History&
+    operator=(History&&) noexcept = delete;
+
+    ~History();
+
+// ---------------------------------------------------------------------------
+    void
+    push(T value);
+
+    void
+    notify(RunnerRaw* runner) override;
+
+  private:
+    void
+    arm();
+
+    SamplePortInternal* mInternal;
+    SampleWindow<T> mWindow;
+    Job mJob;
+  };
+
   /**
    * @class Listener
    */
@@ -318,6 +467,7 @@ private:
     Listener* mNext;
     SamplePortInternal* mInternal;
     Condition* mCondition;
+    ExprNode* mNode;
   };
 
   /**
@@ -330,6 +480,7 @@ private:
 
     template <typename Function>
     friend class Callback;
+    friend class History;
 
     explicit SamplePortInternal();
 
@@ -358,6 +509,16 @@ private:
     bool
     insertValue(T value);
 
+    /**
+     * @brief insertValues
+     * 
+     * inserts the values of the push with the number `push` (see
+     * Signal::pushBatch). The port keeps the last accepted value, the
+     * listeners are notified once.
+     */
+    void
+    insertValues(const T* values, size_t count, uint64_t push);
+
     template <typename Function>
     void
     setPrinterFunction(Function& printer);
@@ -378,9 +539,31 @@ private:
     void
     removeFilter(FilterRaw* filter);
 
+    void
+    attachFilter(SignalFilterRaw<T>* filter);
+
+    void
+    detachFilter(SignalFilterRaw<T>* filter);
+
+    /**
+     * @brief passes
+     * 
+     * @return
+     *  true if all attached signal filters accept `values[index]`
+     */
+    bool
+    passes(const T* values, size_t count, size_t index, uint64_t push);
+
     const char*
     getName();
 
+    void
+    setHistory(size_t samples, time::Duration window);
+
+    template <WindowAggregate Aggregate>
+    auto
+    getAggregate();
+
 // ---------------------------------------------------------------------------
     void
     add(Listener* listener);
@@ -389,6 +572,15 @@ private:
     remove(Listener* listener);
 
   private:
+    bool
+    accept(T& value);
+
+    void
+    record(const T& value);
+
+    void
+    notifyListeners();
+
     T mValue;
     core::SignalRaw* mSignal;
     SamplePortInternal* mNext;
@@ -397,6 +589,8 @@ private:
     List<Listener> mListeners;
     List<CallbackRaw> mCallbacks;
     List<FilterRaw> mFilters;
+    std::vector<SignalFilterRaw<T>*> mSignalFilters;
+    History* mHistory;
 
     void (*mPrinter)(std::ostream&, T&);
   };
@@ -410,7 +604,8 @@ private:
 template <typename T>
 SamplePort<T>::SamplePortExpr::SamplePortExpr(SamplePortInternal* port) :
   mInternal(port),
-  mCondition(nullptr)
+  mCondition(nullptr),
+  mNode(nullptr)
 {
   assert(mInternal);
   assert(port);
@@ -420,7 +615,8 @@ SamplePort<T>::SamplePortExpr::SamplePortExpr(SamplePortInternal* port) :
 template <typename T>
 SamplePort<T>::SamplePortExpr::SamplePortExpr(const SamplePortExpr& other) :
   mInternal(other.mInternal),
-  mCondition(other.mCondition)
+  mCondition(other.mCondition),
+  mNode(other.mNode)
 {
   assert(mInternal);
   mInternal->increment();
@@ -443,10 +639,12 @@ SamplePort<T>::SamplePortExpr::~SamplePortExpr()
 template <typename T>
 void
 SamplePort<T>::SamplePortExpr::conditionEnable(RunnerRaw* runner,
-                                               Condition* condition)
+                                               Condition* condition,
+                                               ExprNode* parent)
 {
   assert(mInternal);
   mCondition = condition;
+  mNode = parent;
   mInternal->add(this);
 }
 
@@ -463,6 +661,7 @@ void
 SamplePort<T>::SamplePortExpr::notify()
 {
   assert(mCondition);
+  ExprNode::invalidate(mNode);
   mCondition->notifyListener();
 }
 
@@ -482,6 +681,155 @@ SamplePort<T>::Converter::toCopyExpr(SamplePort<T>& port)
   return SamplePort<T>::SamplePortExpr(port.mInternal);
 }
 
+// ---------------------------------------------------------------------------
+template <typename T>
+template <WindowAggregate Aggregate>
+SamplePort<T>::WindowExpr<Aggregate>::WindowExpr(SamplePortInternal* port) :
+  mInternal(port),
+  mCondition(nullptr),
+  mNode(nullptr)
+{
+  assert(mInternal);
+  mInternal->increment();
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+SamplePort<T>::WindowExpr<Aggregate>::WindowExpr(const WindowExpr& other) :
+  mInternal(other.mInternal),
+  mCondition(other.mCondition),
+  mNode(other.mNode)
+{
+  assert(mInternal);
+  mInternal->increment();
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+SamplePort<T>::WindowExpr<Aggregate>::~WindowExpr()
+{
+  if (mInternal->decrement())
+  {
+    delete mInternal;
+    mInternal = nullptr;
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <WindowAggregate Aggregate>
+SamplePort<T>::WindowExpr<Aggregate>::operator Type()
+{
+  return getValue();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <WindowAggregate Aggregate>
+void
+SamplePort<T>::WindowExpr<Aggregate>::conditionEnable(
+    RunnerRaw* /* runner */,
+    Condition* condition,
+    ExprNode* parent)
+{
+  assert(mInternal);
+  mCondition = condition;
+  mNode = parent;
+  mInternal->add(this);
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+void
+SamplePort<T>::WindowExpr<Aggregate>::conditionDisable()
+{
+  assert(mInternal);
+  mInternal->remove(this);
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+void
+SamplePort<T>::WindowExpr<Aggregate>::notify()
+{
+  assert(mCondition);
+  ExprNode::invalidate(mNode);
+  mCondition->notifyListener();
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+typename SamplePort<T>::template WindowExpr<Aggregate>::Type
+SamplePort<T>::WindowExpr<Aggregate>::getValue()
+{
+  assert(mInternal);
+  return mInternal->template getAggregate<Aggregate>();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+SamplePort<T>::History::History(SamplePortInternal* internal,
+                                size_t samples,
+                                time::Duration window) :
+  mInternal(internal),
+  mWindow(samples, window)
+{
+}
+
+template <typename T>
+SamplePort<T>::History::~History()
+{
+  if (mJob.isArmed())
+  {
+    mInternal->mRunner->remove(mJob);
+  }
+  else
+  {
+  }
+}
+
+template <typename T>
+void
+SamplePort<T>::History::push(T value)
+{
+  mWindow.push(mInternal->mRunner->now(), value);
+  arm();
+}
+
+template <typename T>
+void
+SamplePort<T>::History::notify(RunnerRaw* runner)
+{
+  if (mWindow.expire(runner->now()))
+  {
+    mInternal->notifyListeners();
+  }
+  else
+  {
+  }
+  arm();
+}
+
+template <typename T>
+void
+SamplePort<T>::History::arm()
+{
+  // the job is due when the oldest sample expires. It may be early if the
+  // sample was dropped because the window is full, notify re-arms it then.
+  const auto expiry = mWindow.nextExpiry();
+  if (!mJob.isArmed() && expiry != time::TimePoint::endOfEpoche())
+  {
+    mJob.setDue(expiry, this);
+    mInternal->mRunner->add(mJob);
+  }
+  else
+  {
+  }
+}
+
 // ---------------------------------------------------------------------------
 template <typename T>
 SamplePort<T>::SamplePort() : mInternal(nullptr)
@@ -571,6 +919,65 @@ SamplePort<T>::removeFilter(FilterRaw* filter)
   return mInternal->removeFilter(filter);
 }
 
+template <typename T>
+void
+SamplePort<T>::attachFilter(SignalFilterRaw<T>* filter)
+{
+  assert(mInternal);
+  mInternal->attachFilter(filter);
+}
+
+template <typename T>
+void
+SamplePort<T>::detachFilter(SignalFilterRaw<T>* filter)
+{
+  assert(mInternal);
+  mInternal->detachFilter(filter);
+}
+
+template <typename T>
+void
+SamplePort<T>::setHistory(size_t samples, time::Duration window)
+{
+  assert(mInternal);
+  mInternal->setHistory(samples, window);
+}
+
+template <typename T>
+typename SamplePort<T>::template WindowExpr<WindowAggregate::count>
+SamplePort<T>::count()
+{
+  return WindowExpr<WindowAggregate::count>(mInternal);
+}
+
+template <typename T>
+typename SamplePort<T>::template WindowExpr<WindowAggregate::sum>
+SamplePort<T>::sum()
+{
+  return WindowExpr<WindowAggregate::sum>(mInternal);
+}
+
+template <typename T>
+typename SamplePort<T>::template WindowExpr<WindowAggregate::min>
+SamplePort<T>::min()
+{
+  return WindowExpr<WindowAggregate::min>(mInternal);
+}
+
+template <typename T>
+typename SamplePort<T>::template WindowExpr<WindowAggregate::max>
+SamplePort<T>::max()
+{
+  return WindowExpr<WindowAggregate::max>(mInternal);
+}
+
+template <typename T>
+typename SamplePort<T>::template WindowExpr<WindowAggregate::mean>
+SamplePort<T>::mean()
+{
+  return WindowExpr<WindowAggregate::mean>(mInternal);
+}
+
 template <typename T>
 const char*
 SamplePort<T>::getName()
@@ -665,7 +1072,8 @@ template <typename T>
 SamplePort<T>::Listener::Listener() :
   mNext(nullptr),
   mInternal(nullptr),
-  mCondition(nullptr)
+  mCondition(nullptr),
+  mNode(nullptr)
 {
 }
 
@@ -677,6 +1085,7 @@ SamplePort<T>::SamplePortInternal::SamplePortInternal() :
   mNext(nullptr),
   mRunner(nullptr),
   mName(nullptr),
+  mHistory(nullptr),
   mPrinter(nullptr)
 {
 }
@@ -685,6 +1094,14 @@ template <typename T>
 SamplePort<T>::SamplePortInternal::~SamplePortInternal()
 {
   mSignal->removeSamplePort(this);
+  if constexpr (std::is_arithmetic_v<T>)
+  {
+    delete mHistory;
+  }
+  else
+  {
+    // setHistory is not available, History must not be instantiated
+  }
 
   // should not be deleted if someone has still a ref to this object
   // PROTEST_ASSERT(mListeners.numberOfElements() == 0);
@@ -745,29 +1162,13 @@ SamplePort<T>::SamplePortInternal::insertValue(T value)
   auto& context = mRunner->getContext();
   context.setCurrentVirtual(mRunner);
 
-  auto filter = mFilters.begin();
-  while (filter != mFilters.end())
-  {
-    if (!filter->handle(value))
-    {
-      accepted = false;
-    }
-    else
-    {
-      // fine
-    }
-    ++filter;
-  }
+  accepted = accept(value);
 
   if (accepted)
   {
     mValue = value;
-    auto iter = mListeners.begin();
-    while (iter != mListeners.end())
-    {
-      iter->notify();
-      ++iter;
-    }
+    record(mValue);
+    notifyListeners();
     auto callbacks = mCallbacks.begin();
     while (callbacks != mCallbacks.end())
     {
@@ -784,6 +1185,48 @@ SamplePort<T>::SamplePortInternal::insertValue(T value)
   return hasChanged;
 }
 
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::insertValues(const T* values,
+                                                size_t count,
+                                                uint64_t push)
+{
+  bool inserted = false;
+
+  auto& context = mRunner->getContext();
+  context.setCurrentVirtual(mRunner);
+
+  for (size_t i = 0; i < count; i++)
+  {
+    T value = values[i];
+    if (passes(values, count, i, push) && accept(value))
+    {
+      inserted = true;
+      mValue = value;
+      record(mValue);
+      auto callbacks = mCallbacks.begin();
+      while (callbacks != mCallbacks.end())
+      {
+        callbacks->handle(mValue);
+        ++callbacks;
+      }
+    }
+    else
+    {
+    }
+  }
+
+  if (inserted)
+  {
+    notifyListeners();
+  }
+  else
+  {
+  }
+
+  context.setCurrentVirtual(nullptr);
+}
+
 template <typename T>
 template <typename Function>
 void
@@ -832,6 +1275,54 @@ SamplePort<T>::SamplePortInternal::removeFilter(FilterRaw* filter)
   delete filter;
 }
 
+template <typename T>
+bool
+SamplePort<T>::SamplePortInternal::accept(T& value)
+{
+  // stops at the first rejection
+  bool accepted = true;
+  auto filter = mFilters.begin();
+  while (accepted && filter != mFilters.end())
+  {
+    accepted = filter->handle(value);
+    ++filter;
+  }
+  return accepted;
+}
+
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::attachFilter(SignalFilterRaw<T>* filter)
+{
+  mSignalFilters.push_back(filter);
+}
+
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::detachFilter(SignalFilterRaw<T>* filter)
+{
+  mSignalFilters.erase(
+      std::remove(mSignalFilters.begin(), mSignalFilters.end(), filter),
+      mSignalFilters.end());
+}
+
+template <typename T>
+bool
+SamplePort<T>::SamplePortInternal::passes(const T* values,
+                                          size_t count,
+                                          size_t index,
+                                          uint64_t push)
+{
+  bool accepted = true;
+  auto filter = mSignalFilters.begin();
+  while (accepted && filter != mSignalFilters.end())
+  {
+    accepted = (*filter)->accepts(values, count, index, push);
+    ++filter;
+  }
+  return accepted;
+}
+
 template <typename T>
 const char*
 SamplePort<T>::SamplePortInternal::getName()
@@ -839,6 +1330,76 @@ SamplePort<T>::SamplePortInternal::getName()
   return mName;
 }
 
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::setHistory(size_t samples,
+                                              time::Duration window)
+{
+  PROTEST_ASSERT(mHistory == nullptr);
+  mHistory = new History(this, samples, window);
+}
+
+template <typename T>
+template <WindowAggregate Aggregate>
+auto
+SamplePort<T>::SamplePortInternal::getAggregate()
+{
+  PROTEST_ASSERT(mHistory != nullptr);
+  auto& window = mHistory->mWindow;
+  if constexpr (Aggregate == WindowAggregate::count)
+  {
+    return window.count();
+  }
+  else if constexpr (Aggregate == WindowAggregate::sum)
+  {
+    return window.sum();
+  }
+  else if constexpr (Aggregate == WindowAggregate::min)
+  {
+    return window.min();
+  }
+  else if constexpr (Aggregate == WindowAggregate::max)
+  {
+    return window.max();
+  }
+  else
+  {
+    return window.mean();
+  }
+}
+
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::record(const T& value)
+{
+  if constexpr (std::is_arithmetic_v<T>)
+  {
+    if (mHistory != nullptr)
+    {
+      mHistory->push(value);
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    // setHistory is not available
+  }
+}
+
+template <typename T>
+void
+SamplePort<T>::SamplePortInternal::notifyListeners()
+{
+  auto iter = mListeners.begin();
+  while (iter != mListeners.end())
+  {
+    iter->notify();
+    ++iter;
+  }
+}
+
 template <typename T>
 void
 SamplePort<T>::SamplePortInternal::add(Listener* listener)
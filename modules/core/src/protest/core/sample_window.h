@@ -0,0 +1,316 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/time/duration.h"
+#include "protest/time/time_point.h"
+#include "protest/utils/debug.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+
+namespace protest
+{
+
+namespace core
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @enum WindowAggregate
+ * 
+ * The aggregates of a SampleWindow (see SamplePort::setHistory).
+ */
+enum class WindowAggregate
+{
+  count,
+  sum,
+  min,
+  max,
+  mean
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class SampleWindow
+ * 
+ * Keeps the last `samples` values which are younger than `window` and
+ * maintains their aggregates incrementally: sum and count are running
+ * values, min and max use monotonic queues. Every operation is O(1)
+ * amortized. min and max of an empty window are T(), its mean is zero.
+ * The running sum of floating point samples is recomputed from the samples
+ * after as many removals as there are samples, so rounding errors do not
+ * accumulate.
+ */
+template <typename T>
+class SampleWindow
+{
+public:
+  static_assert(std::is_arithmetic_v<T>,
+                "the history of a sample port needs an arithmetic type");
+
+  using Sum = std::conditional_t<
+      std::is_floating_point_v<T>,
+      double,
+      std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+  explicit SampleWindow(size_t samples, time::Duration window);
+
+  SampleWindow(const SampleWindow&) = delete;
+
+  SampleWindow(SampleWindow&&) noexcept = delete;
+
+  SampleWindow&
+  operator=(const SampleWindow&) = delete;
+
+  SampleWindow&
+  operator=(SampleWindow&&) noexcept = delete;
+
+  ~SampleWindow() = default;
+
+// ---------------------------------------------------------------------------
+  void
+  push(time::TimePoint now, T value);
+
+  /**
+   * @brief expire
+   * 
+   * removes the samples which are `window` or older.
+   * 
+   * @return
+   *  true if a sample was removed
+   */
+  bool
+  expire(time::TimePoint now);
+
+  /**
+   * @brief nextExpiry
+   * 
+   * @return
+   *  the time the oldest sample expires (end of epoche if it never does)
+   */
+  time::TimePoint
+  nextExpiry();
+
+// ---------------------------------------------------------------------------
+  size_t
+  count();
+
+  Sum
+  sum();
+
+  T
+  min();
+
+  T
+  max();
+
+  double
+  mean();
+
+private:
+  struct Sample
+  {
+    uint64_t mNumber;
+    time::TimePoint mTime;
+    T mValue;
+  };
+
+  void
+  popFront();
+
+  std::deque<Sample> mSamples;
+  // candidates for the minimum (increasing) and the maximum (decreasing)
+  std::deque<Sample> mMin;
+  std::deque<Sample> mMax;
+  size_t mCapacity;
+  time::Duration mWindow;
+  uint64_t mNumberOfSamples;
+  Sum mSum;
+  size_t mRemovalsSinceSum;
+};
+
+// ---------------------------------------------------------------------------
+template <typename T>
+SampleWindow<T>::SampleWindow(size_t samples, time::Duration window) :
+  mCapacity(samples),
+  mWindow(window),
+  mNumberOfSamples(0u),
+  mSum(0),
+  mRemovalsSinceSum(0u)
+{
+  PROTEST_ASSERT(samples > 0u);
+}
+
+template <typename T>
+void
+SampleWindow<T>::push(time::TimePoint now, T value)
+{
+  const Sample sample {mNumberOfSamples, now, value};
+  mNumberOfSamples++;
+
+  mSamples.push_back(sample);
+  mSum += static_cast<Sum>(value);
+  while (!mMin.empty() && !(mMin.back().mValue < value))
+  {
+    mMin.pop_back();
+  }
+  mMin.push_back(sample);
+  while (!mMax.empty() && !(value < mMax.back().mValue))
+  {
+    mMax.pop_back();
+  }
+  mMax.push_back(sample);
+
+  if (mSamples.size() > mCapacity)
+  {
+    popFront();
+  }
+  else
+  {
+  }
+  expire(now);
+}
+
+template <typename T>
+bool
+SampleWindow<T>::expire(time::TimePoint now)
+{
+  bool expired = false;
+  if (mWindow != time::Duration::infinity())
+  {
+    while (!mSamples.empty() && now - mSamples.front().mTime >= mWindow)
+    {
+      popFront();
+      expired = true;
+    }
+  }
+  else
+  {
+  }
+  return expired;
+}
+
+template <typename T>
+time::TimePoint
+SampleWindow<T>::nextExpiry()
+{
+  time::TimePoint expiry = time::TimePoint::endOfEpoche();
+  if (mWindow != time::Duration::infinity() && !mSamples.empty())
+  {
+    expiry = mSamples.front().mTime + mWindow;
+  }
+  else
+  {
+  }
+  return expiry;
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+size_t
+SampleWindow<T>::count()
+{
+  return mSamples.size();
+}
+
+template <typename T>
+typename SampleWindow<T>::Sum
+SampleWindow<T>::sum()
+{
+  return mSum;
+}
+
+template <typename T>
+T
+SampleWindow<T>::min()
+{
+  return mMin.empty() ? T() : mMin.front().mValue;
+}
+
+template <typename T>
+T
+SampleWindow<T>::max()
+{
+  return mMax.empty() ? T() : mMax.front().mValue;
+}
+
+template <typename T>
+double
+SampleWindow<T>::mean()
+{
+  return mSamples.empty() ? 0.0
+                          : static_cast<double>(mSum) /
+                                static_cast<double>(mSamples.size());
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+void
+SampleWindow<T>::popFront()
+{
+  const uint64_t number = mSamples.front().mNumber;
+  mSum -= static_cast<Sum>(mSamples.front().mValue);
+  mSamples.pop_front();
+  mRemovalsSinceSum++;
+  if (mSamples.empty())
+  {
+    mSum = 0;
+    mRemovalsSinceSum = 0u;
+  }
+  else if (std::is_floating_point_v<T> &&
+           mRemovalsSinceSum >= mSamples.size())
+  {
+    mSum = 0;
+    for (const auto& sample : mSamples)
+    {
+      mSum += static_cast<Sum>(sample.mValue);
+    }
+    mRemovalsSinceSum = 0u;
+  }
+  else
+  {
+  }
+  if (!mMin.empty() && mMin.front().mNumber == number)
+  {
+    mMin.pop_front();
+  }
+  else
+  {
+  }
+  if (!mMax.empty() && mMax.front().mNumber == number)
+  {
+    mMax.pop_front();
+  }
+  else
+  {
+  }
+}
+
+} // namespace core
+
+} // namespace protest
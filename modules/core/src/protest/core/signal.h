@@ -27,6 +27,7 @@
 #include "protest/core/queue_port.h"
 #include "protest/core/signal_raw.h"
 #include "protest/core/sample_port.h"
+#include "protest/core/signal_filter.h"
 #include "protest/utils/list.h"
 #include "protest/core/context.h"
 #include "protest/meta.h"
@@ -39,6 +40,8 @@ namespace protest
 namespace core
 {
 
+class StacklessRunner;
+
 // ---------------------------------------------------------------------------
 /**
  * @class Signal
@@ -47,6 +50,8 @@ template <typename T>
 class Signal : public protest::core::SignalRaw
 {
 public:
+  friend class StacklessRunner;
+
   explicit Signal(
       Context& context,
       protest::meta::Signal& signal = protest::meta::Signal::defaultContext());
@@ -64,12 +69,160 @@ public:
   ~Signal();
 
 // ---------------------------------------------------------------------------
+  /**
+   * Delivers the value to all bound ports with the delivery of the signal
+   * (see setDelivery) or the given one.
+   */
+  void
+  push(T value,
+       protest::meta::CallContext& push =
+           protest::meta::CallContext::defaultContext());
+
   void
   push(T value,
+       Delivery delivery,
        protest::meta::CallContext& push =
            protest::meta::CallContext::defaultContext());
 
+  /**
+   * Delivers the values as one unit: a single log entry, every port gets
+   * the whole batch at once and notifies its listeners once. The yields
+   * follow the delivery of the signal, a sample port keeps the last value.
+   * Ports whose signal filters reject all values are skipped (no yield).
+   */
+  void
+  pushBatch(const T* values,
+            size_t count,
+            protest::meta::CallContext& push =
+                protest::meta::CallContext::defaultContext());
+
+  /**
+   * Adds a filter owned by the signal. Ports attach it with attachFilter
+   * and receive only the values it accepts. It is tested once per value.
+   */
+  template <typename Function>
+  SignalFilterRaw<T>*
+  addFilter(Function function);
+
+  void
+  removeFilter(SignalFilterRaw<T>* filter);
+
 private:
+// ---------------------------------------------------------------------------
+  /**
+   * @class Dispatch
+   * 
+   * Delivery of one push (see push and pushBatch) to the bound ports. It
+   * chooses the ports whose signal filters accept the values, waits for the
+   * blocking queue ports and inserts the values. Instead of suspending the
+   * pushing runner itself it returns from next() with the step the caller
+   * has to take, so the blocking push and the awaitable one of the
+   * StacklessRunner share everything except the suspension points.
+   */
+  class Dispatch
+  {
+  public:
+    enum class Step
+    {
+      // internal, never returned by next()
+      proceed,
+      // the caller yields before next() is called again
+      yield,
+      // the caller waits for space in getQueuePort()
+      waitForSpace,
+      done
+    };
+
+    /**
+     * @param batch
+     *  the values are inserted as one unit (see pushBatch), otherwise
+     *  `values` points to the single value of push
+     */
+    explicit Dispatch(Signal& signal,
+                      const T* values,
+                      size_t count,
+                      bool batch,
+                      Delivery delivery);
+
+    Dispatch(const Dispatch&) = delete;
+
+    Dispatch(Dispatch&&) noexcept = delete;
+
+    Dispatch&
+    operator=(const Dispatch&) = delete;
+
+    Dispatch&
+    operator=(Dispatch&&) noexcept = delete;
+
+    ~Dispatch() = default;
+
+    /**
+     * @brief next
+     * 
+     * delivers as far as possible without suspending the pushing runner.
+     */
+    Step
+    next();
+
+    typename QueuePort<T>::QueuePortInternal&
+    getQueuePort();
+
+  private:
+    enum class State
+    {
+      sampleTarget,
+      sampleInsert,
+      queueTarget,
+      queueInsert,
+      queueFill,
+      finish,
+      done
+    };
+
+    template <typename Iterator>
+    void
+    skipRejecting(Iterator& iter, Iterator end);
+
+    Signal& mSignal;
+    const T* mValues;
+    size_t mCount;
+    uint64_t mPush;
+    bool mBatch;
+    bool mInterleaved;
+    State mState;
+    // number of ports of the list being delivered to, the pass must not
+    // bind or remove ports
+    size_t mNumberOfPorts;
+    // values of the batch consumed by the current queue port
+    size_t mConsumed;
+    typename List<typename SamplePort<T>::SamplePortInternal>::Iterator
+        mSample;
+    typename List<typename QueuePort<T>::QueuePortInternal>::Iterator mQueue;
+  };
+
+// ---------------------------------------------------------------------------
+  void
+  dispatch(Dispatch& dispatch, RunnerRaw& runner);
+
+  /**
+   * @return
+   *  true if the signal filters of the port accept at least one of the
+   *  values. Ports rejecting the whole batch are skipped without a yield.
+   */
+  template <typename Port>
+  static bool
+  passesAny(Port& port, const T* values, size_t count, uint64_t push);
+
+  void
+  logPush(RunnerRaw& runner,
+          const T& value,
+          protest::meta::CallContext& context);
+
+  void
+  logPushBatch(RunnerRaw& runner,
+               size_t count,
+               protest::meta::CallContext& context);
+
   void
   bindSamplePort(void* port) override;
 
@@ -93,6 +246,9 @@ private:
 
   protest::List<typename core::SamplePort<T>::SamplePortInternal> mSamplePorts;
   protest::List<typename core::QueuePort<T>::QueuePortInternal> mQueuePorts;
+  protest::List<SignalFilterRaw<T>> mFilters;
+  // number of the last push, the results of the filters are cached per push
+  uint64_t mPushes;
   Context& mContext;
   // meta::Signal& mSignalInfo;
 };
@@ -101,6 +257,7 @@ private:
 template <typename T>
 Signal<T>::Signal(Context& context, protest::meta::Signal& signal) :
   SignalRaw(signal),
+  mPushes(0u),
   mContext(context)
 {
 }
@@ -110,6 +267,10 @@ Signal<T>::~Signal()
 {
   // PROTEST_ASSERT(mSamplePorts.numberOfElements() == 0);
   // PROTEST_ASSERT(mQueuePorts.numberOfElements() == 0);
+  while (mFilters.numberOfElements() > 0)
+  {
+    removeFilter(&*mFilters.begin());
+  }
 }
 
 // ---------------------------------------------------------------------------
@@ -117,46 +278,277 @@ template <typename T>
 void
 Signal<T>::push(T value, meta::CallContext& context)
 {
-  auto runner = mContext.getCurrent();
-  {
-    auto stream = runner->getLogger().startLog("PUSH",
-                                               runner->getName(),
-                                               context.getUnit().getFileName(),
-                                               context.getLine(),
-                                               runner->now());
-    stream.operator std::ostream&()
-        << "Push value to '" << getSignalInfo().getObjectName() << "':\n";
-    runner->getLogger().getStream() << value;
-  }
+  push(value, getDelivery(), context);
+}
+
+template <typename T>
+void
+Signal<T>::push(T value, Delivery delivery, meta::CallContext& context)
+{
+  auto* runner = mContext.getCurrent();
+  logPush(*runner, value, context);
+
+  Dispatch dispatch(*this, &value, 1u, false, delivery);
+  this->dispatch(dispatch, *runner);
+}
 
-  auto n = mSamplePorts.numberOfElements();
+template <typename T>
+void
+Signal<T>::pushBatch(const T* values, size_t count, meta::CallContext& context)
+{
+  auto* runner = mContext.getCurrent();
+  logPushBatch(*runner, count, context);
+
+  Dispatch dispatch(*this, values, count, true, getDelivery());
+  this->dispatch(dispatch, *runner);
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <typename Function>
+SignalFilterRaw<T>*
+Signal<T>::addFilter(Function function)
+{
+  auto* filter = new SignalFilter<T, Function>(function);
+  mFilters.append(*filter);
+  return filter;
+}
+
+template <typename T>
+void
+Signal<T>::removeFilter(SignalFilterRaw<T>* filter)
+{
   auto iter1 = mSamplePorts.begin();
   while (iter1 != mSamplePorts.end())
   {
-    // yield here so that if there are two or more coroutines are runable
-    // there can mix the delivery ot the message instead of that each
-    // coroutine is pushing it in a raw
-    mContext.getCurrent()->coroYield();
-    iter1->insertValue(value);
+    iter1->detachFilter(filter);
     ++iter1;
   }
-  PROTEST_ASSERT(mSamplePorts.numberOfElements() == n);
-
-  n = mQueuePorts.numberOfElements();
   auto iter2 = mQueuePorts.begin();
   while (iter2 != mQueuePorts.end())
   {
-    // yield here so that if there are two or more coroutines runable
-    // there can mix the delivery ot the message instead of that each
-    // coroutine is pushing it in a row
-    mContext.getCurrent()->coroYield();
-    iter2->insertValue(value);
+    iter2->detachFilter(filter);
     ++iter2;
   }
-  PROTEST_ASSERT(mQueuePorts.numberOfElements() == n);
+  mFilters.remove(*filter);
+  delete filter;
 }
 
 // ---------------------------------------------------------------------------
+template <typename T>
+void
+Signal<T>::dispatch(Dispatch& dispatch, RunnerRaw& runner)
+{
+  auto step = dispatch.next();
+  while (step != Dispatch::Step::done)
+  {
+    if (step == Dispatch::Step::yield)
+    {
+      runner.coroYield();
+    }
+    else
+    {
+      dispatch.getQueuePort().waitForSpace(&runner);
+    }
+    step = dispatch.next();
+  }
+}
+
+template <typename T>
+template <typename Port>
+bool
+Signal<T>::passesAny(Port& port,
+                     const T* values,
+                     size_t count,
+                     uint64_t push)
+{
+  bool passed = false;
+  for (size_t i = 0; !passed && i < count; i++)
+  {
+    passed = port.passes(values, count, i, push);
+  }
+  return passed;
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Signal<T>::Dispatch::Dispatch(Signal& signal,
+                              const T* values,
+                              size_t count,
+                              bool batch,
+                              Delivery delivery) :
+  mSignal(signal),
+  mValues(values),
+  mCount(count),
+  mPush(++signal.mPushes),
+  mBatch(batch),
+  mInterleaved(delivery == Delivery::interleaved),
+  mState(State::sampleTarget),
+  mNumberOfPorts(signal.mSamplePorts.numberOfElements()),
+  mConsumed(0u),
+  mSample(signal.mSamplePorts.begin()),
+  mQueue(signal.mQueuePorts.begin())
+{
+}
+
+template <typename T>
+typename Signal<T>::Dispatch::Step
+Signal<T>::Dispatch::next()
+{
+  Step step = Step::proceed;
+  while (step == Step::proceed)
+  {
+    switch (mState)
+    {
+      case State::sampleTarget:
+        skipRejecting(mSample, mSignal.mSamplePorts.end());
+        if (mSample != mSignal.mSamplePorts.end())
+        {
+          // yield here so that if there are two or more coroutines runable
+          // they can mix the delivery of the message instead of that each
+          // coroutine is pushing it in a row
+          step = mInterleaved ? Step::yield : Step::proceed;
+          mState = State::sampleInsert;
+        }
+        else
+        {
+          PROTEST_ASSERT(mSignal.mSamplePorts.numberOfElements() ==
+                         mNumberOfPorts);
+          mNumberOfPorts = mSignal.mQueuePorts.numberOfElements();
+          mState = State::queueTarget;
+        }
+        break;
+
+      case State::sampleInsert:
+        if (mBatch)
+        {
+          mSample->insertValues(mValues, mCount, mPush);
+        }
+        else
+        {
+          mSample->insertValue(*mValues);
+        }
+        ++mSample;
+        mState = State::sampleTarget;
+        break;
+
+      case State::queueTarget:
+        skipRejecting(mQueue, mSignal.mQueuePorts.end());
+        if (mQueue != mSignal.mQueuePorts.end())
+        {
+          step = mInterleaved ? Step::yield : Step::proceed;
+          mConsumed = 0u;
+          mState = State::queueInsert;
+        }
+        else
+        {
+          PROTEST_ASSERT(mSignal.mQueuePorts.numberOfElements() ==
+                         mNumberOfPorts);
+          mState = State::finish;
+        }
+        break;
+
+      case State::queueInsert:
+        // the value is inserted right after the wait, so a blocking port
+        // cannot be filled up again in between
+        step = Step::waitForSpace;
+        mState = State::queueFill;
+        break;
+
+      case State::queueFill:
+        if (mBatch)
+        {
+          // a blocking port takes the batch in chunks
+          mConsumed = mQueue->insertValues(mValues, mCount, mConsumed, mPush);
+        }
+        else
+        {
+          mQueue->insertValue(*mValues);
+          mConsumed = mCount;
+        }
+        if (mConsumed < mCount)
+        {
+          mState = State::queueInsert;
+        }
+        else
+        {
+          ++mQueue;
+          mState = State::queueTarget;
+        }
+        break;
+
+      case State::finish:
+        if (!mInterleaved && mSignal.mSamplePorts.numberOfElements() +
+                                     mSignal.mQueuePorts.numberOfElements() >
+                                 0)
+        {
+          step = Step::yield;
+        }
+        else
+        {
+        }
+        mState = State::done;
+        break;
+
+      case State::done:
+        step = Step::done;
+        break;
+    }
+  }
+  return step;
+}
+
+template <typename T>
+typename QueuePort<T>::QueuePortInternal&
+Signal<T>::Dispatch::getQueuePort()
+{
+  return *mQueue;
+}
+
+template <typename T>
+template <typename Iterator>
+void
+Signal<T>::Dispatch::skipRejecting(Iterator& iter, Iterator end)
+{
+  // ports whose signal filters reject all values are skipped (no yield)
+  while (iter != end && !passesAny(*iter, mValues, mCount, mPush))
+  {
+    ++iter;
+  }
+}
+
+template <typename T>
+void
+Signal<T>::logPush(RunnerRaw& runner,
+                   const T& value,
+                   protest::meta::CallContext& context)
+{
+  auto stream = runner.getLogger().startLog("PUSH",
+                                            runner.getName(),
+                                            context.getUnit().getFileName(),
+                                            context.getLine(),
+                                            runner.now());
+  stream.operator std::ostream&()
+      << "Push value to '" << getSignalInfo().getObjectName() << "':\n";
+  runner.getLogger().getStream() << value;
+}
+
+template <typename T>
+void
+Signal<T>::logPushBatch(RunnerRaw& runner,
+                        size_t count,
+                        protest::meta::CallContext& context)
+{
+  auto stream = runner.getLogger().startLog("PUSH",
+                                            runner.getName(),
+                                            context.getUnit().getFileName(),
+                                            context.getLine(),
+                                            runner.now());
+  stream.operator std::ostream&()
+      << "Push " << count << " values to '" << getSignalInfo().getObjectName()
+      << "'\n";
+}
+
 template <typename T>
 void
 Signal<T>::bindSamplePort(void* port)
@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/utils/list.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace protest
+{
+
+namespace core
+{
+
+template <typename T>
+class Signal;
+
+// ---------------------------------------------------------------------------
+/**
+ * @class SignalFilterRaw
+ * 
+ * Predicate owned by a signal (see Signal::addFilter) and shared by the
+ * ports attached to it (see QueuePort::attachFilter). The signal tests a
+ * pushed value at most once per filter, no matter how many ports use it.
+ * Ports whose filters reject a value are skipped by the signal, before any
+ * yield or copy.
+ */
+template <typename T>
+class SignalFilterRaw
+{
+public:
+  friend class List<SignalFilterRaw>;
+  friend class Signal<T>;
+
+  explicit SignalFilterRaw();
+
+  SignalFilterRaw(const SignalFilterRaw&) = delete;
+
+  SignalFilterRaw&
+  operator=(const SignalFilterRaw&) = delete;
+
+  SignalFilterRaw(SignalFilterRaw&&) noexcept = delete;
+
+  SignalFilterRaw&
+  operator=(SignalFilterRaw&&) noexcept = delete;
+
+  virtual ~SignalFilterRaw() = default;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief accepts
+   * 
+   * @param values
+   *  all values of the push with the number `push` (one unless batched)
+   * 
+   * @return
+   *  the result for `values[index]`. The results of a push are computed
+   *  on the first call and cached.
+   */
+  bool
+  accepts(const T* values, size_t count, size_t index, uint64_t push);
+
+private:
+  virtual bool
+  handle(const T& value) = 0;
+
+  SignalFilterRaw* mNext;
+  uint64_t mPush;
+  std::vector<bool> mResults;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class SignalFilter
+ */
+template <typename T, typename Function>
+class SignalFilter : public SignalFilterRaw<T>
+{
+public:
+  explicit SignalFilter(Function function);
+
+private:
+  bool
+  handle(const T& value) override;
+
+  Function mFunction;
+};
+
+// ---------------------------------------------------------------------------
+template <typename T>
+SignalFilterRaw<T>::SignalFilterRaw() : mNext(nullptr), mPush(0u)
+{
+}
+
+template <typename T>
+bool
+SignalFilterRaw<T>::accepts(const T* values,
+                            size_t count,
+                            size_t index,
+                            uint64_t push)
+{
+  if (mPush != push)
+  {
+    mPush = push;
+    mResults.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      mResults[i] = handle(values[i]);
+    }
+  }
+  else
+  {
+  }
+  return mResults[index];
+}
+
+// ---------------------------------------------------------------------------
+template <typename T, typename Function>
+SignalFilter<T, Function>::SignalFilter(Function function) :
+  mFunction(function)
+{
+}
+
+template <typename T, typename Function>
+bool
+SignalFilter<T, Function>::handle(const T& value)
+{
+  return mFunction(value);
+}
+
+} // namespace core
+
+} // namespace protest
@@ -29,12 +29,16 @@
 using namespace protest::core;
 
 // ---------------------------------------------------------------------------
-SignalRaw::SignalRaw() : mSignalInfo(nullptr)
+SignalRaw::SignalRaw() :
+  mSignalInfo(nullptr),
+  mDelivery(Delivery::interleaved)
 {
   assert(false);
 }
 
-SignalRaw::SignalRaw(meta::Signal& signal) : mSignalInfo(&signal)
+SignalRaw::SignalRaw(meta::Signal& signal) :
+  mSignalInfo(&signal),
+  mDelivery(Delivery::interleaved)
 {
 }
 
@@ -44,3 +48,15 @@ SignalRaw::getSignalInfo()
 {
   return *mSignalInfo;
 }
+
+void
+SignalRaw::setDelivery(Delivery delivery)
+{
+  mDelivery = delivery;
+}
+
+SignalRaw::Delivery
+SignalRaw::getDelivery() const
+{
+  return mDelivery;
+}
@@ -39,6 +39,23 @@ namespace core
 class SignalRaw
 {
 public:
+  /**
+   * @enum Delivery
+   *
+   * How Signal::push delivers a value to the bound ports.
+   */
+  enum class Delivery
+  {
+    // yields before each port, so pushes of several runners in the same
+    // time step can interleave port by port
+    interleaved,
+    // inserts into all ports in one pass and yields once afterwards, so
+    // every subscriber already sees the value when the first one runs and
+    // no other push can get between two ports (unless the pass waits for
+    // space in a blocking queue port)
+    batched
+  };
+
   explicit SignalRaw();
 
   explicit SignalRaw(meta::Signal& signal);
@@ -75,8 +92,15 @@ public:
   meta::Signal&
   getSignalInfo();
 
+  void
+  setDelivery(Delivery delivery);
+
+  Delivery
+  getDelivery() const;
+
 private:
   meta::Signal* mSignalInfo;
+  Delivery mDelivery;
 };
 
 } // namespace core
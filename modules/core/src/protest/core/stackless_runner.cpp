@@ -0,0 +1,217 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/core/stackless_runner.h"
+#include "protest/core/runner_group.h"
+
+#include <cassert>
+#include <utility>
+
+using namespace protest::core;
+
+// ---------------------------------------------------------------------------
+StacklessRunner::YieldAwaiter::YieldAwaiter(StacklessRunner& runner) :
+  mRunner(runner)
+{
+}
+
+bool
+StacklessRunner::YieldAwaiter::await_ready() noexcept
+{
+  return false;
+}
+
+void
+StacklessRunner::YieldAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+  mRunner.mSuspended = handle;
+  mRunner.mScheduler.yield(&mRunner);
+}
+
+void
+StacklessRunner::YieldAwaiter::await_resume() noexcept
+{
+}
+
+// ---------------------------------------------------------------------------
+StacklessRunner::SleepAwaiter::SleepAwaiter(StacklessRunner& runner,
+                                            time::Duration duration) :
+  mRunner(runner),
+  mDuration(duration)
+{
+}
+
+bool
+StacklessRunner::SleepAwaiter::await_ready() noexcept
+{
+  return false;
+}
+
+void
+StacklessRunner::SleepAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+  mRunner.mSuspended = handle;
+  mRunner.prepareWait(mDuration);
+  mRunner.mScheduler.sleep(&mRunner, mDuration);
+}
+
+bool
+StacklessRunner::SleepAwaiter::await_resume() noexcept
+{
+  return mRunner.completeWait();
+}
+
+// ---------------------------------------------------------------------------
+StacklessRunner::StacklessRunner(core::Context& context, const char* name) :
+  RunnerRaw(context, coro::Coroutine::stackless, name),
+  mBody(body()),
+  mSuspended(mBody.getHandle())
+{
+}
+
+StacklessRunner::StacklessRunner(core::RunnerGroup& group, const char* name) :
+  RunnerRaw(group, coro::Coroutine::stackless, name),
+  mBody(body()),
+  mSuspended(mBody.getHandle())
+{
+}
+
+// ---------------------------------------------------------------------------
+protest::coro::Task<>
+StacklessRunner::coProcess()
+{
+  co_return;
+}
+
+// ---------------------------------------------------------------------------
+void
+StacklessRunner::coroResume()
+{
+  PROTEST_ASSERT(mSuspended);
+  std::exchange(mSuspended, nullptr).resume();
+  if (mBody.isDone())
+  {
+    mScheduler.exit(this);
+    // forwards an exception of coProcess
+    mBody.getResult();
+  }
+  else
+  {
+    // suspended by an awaiter which already handed over to the scheduler
+  }
+}
+
+// ---------------------------------------------------------------------------
+StacklessRunner::YieldAwaiter
+StacklessRunner::yield()
+{
+  return YieldAwaiter(*this);
+}
+
+StacklessRunner::SleepAwaiter
+StacklessRunner::sleep(time::Duration duration)
+{
+  return SleepAwaiter(*this, duration);
+}
+
+protest::coro::Task<bool>
+StacklessRunner::waitInternal(time::Duration timeout, Condition* condition)
+{
+  PROTEST_ASSERT(mCondition == nullptr);
+  mCondition = condition;
+  const bool gotTimeout = co_await waitInternal(timeout);
+  mCondition = nullptr;
+  co_return gotTimeout;
+}
+
+protest::coro::Task<bool>
+StacklessRunner::waitInternal(time::Duration timeout)
+{
+  // same as RunnerRaw::waitInternal, but suspends instead of blocking
+  mWakeUpEvent = false;
+
+  while (timeout > time::Duration::zero() && !isWaitFulfilled())
+  {
+    auto startAt = now();
+
+    assert(mWakeUpEvent == false);
+    co_await sleep(getTimeToSleep(timeout));
+
+    // if sleeping for ever, do not set a new timeout
+    if (timeout != time::Duration::infinity())
+    {
+      timeout = timeout - (now() - startAt);
+      PROTEST_ASSERT(timeout >= time::Duration::zero());
+    }
+
+    executeDueJobs();
+  }
+
+  const bool gotTimeout = !isWaitFulfilled();
+  co_return gotTimeout;
+}
+
+// ---------------------------------------------------------------------------
+protest::coro::Task<>
+StacklessRunner::wait(time::Duration duration,
+                      protest::meta::CallContext& callContext)
+{
+  logWait("WAIT",
+          callContext,
+          "Wait for " + std::to_string(duration.milliseconds()) + " ms\n");
+  co_await waitInternal(duration);
+  logWait("WAIT",
+          callContext,
+          "Timeout of " + std::to_string(duration.milliseconds()) +
+              " ms elapsed!\n");
+}
+
+// ---------------------------------------------------------------------------
+protest::coro::Task<>
+StacklessRunner::body()
+{
+  co_await coProcess();
+  // this makes sure that all timers etc. are executed before the runner
+  // exits
+  while (hasOneShotJobs())
+  {
+    co_await sleep(getTimeToSleep(time::Duration::infinity()));
+    executeDueJobs();
+  }
+  cancelPeriodicJobs();
+  co_await waitInternal(time::Duration::infinity());
+}
+
+void
+StacklessRunner::logWait(const char* tag,
+                         protest::meta::CallContext& callContext,
+                         const std::string& message)
+{
+  auto stream = getLogger().startLog(tag,
+                                     getName(),
+                                     callContext.getUnit().getFileName(),
+                                     callContext.getLine(),
+                                     now());
+  stream.operator std::ostream&() << message;
+}
@@ -0,0 +1,375 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "protest/core/stackless_runner.h requires C++20 coroutines"
+#endif
+
+#include "protest/core/condition.h"
+#include "protest/core/runner_raw.h"
+#include "protest/core/signal.h"
+#include "protest/coro/task.h"
+#include "protest/meta.h"
+
+#include <coroutine>
+#include <string>
+#include <type_traits>
+
+namespace protest
+{
+
+namespace core
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class StacklessRunner
+ * 
+ * Runner without a stack of its own. Instead of process it executes the
+ * C++20 coroutine coProcess, which is resumed by the scheduler on its own
+ * stack (see coro::Coroutine::isStackless). It uses the same scheduler and
+ * logical clock as all other runners of the context.
+ * 
+ * Every blocking call has an awaitable counterpart here which suspends the
+ * coroutine and hands over the control to the scheduler. The blocking calls
+ * (e.g. protest::wait or Signal::push) must not be used by a stackless
+ * runner:
+ * 
+ *    coro::Task<>
+ *    coProcess() override
+ *    {
+ *      co_await wait(protest::time::Millisecond(10));
+ *      co_await push(mSignal, 42);
+ *    }
+ * 
+ * Only the frames of the active tasks are allocated instead of a stack of
+ * coro::CoroutineBase::defaultStackSize bytes, which allows simulations
+ * with a large number of lightweight runners.
+ */
+class StacklessRunner : public RunnerRaw
+{
+public:
+// ---------------------------------------------------------------------------
+  /**
+   * @class YieldAwaiter
+   */
+  class YieldAwaiter
+  {
+  public:
+    explicit YieldAwaiter(StacklessRunner& runner);
+
+    bool
+    await_ready() noexcept;
+
+    void
+    await_suspend(std::coroutine_handle<> handle);
+
+    void
+    await_resume() noexcept;
+
+  private:
+    StacklessRunner& mRunner;
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class SleepAwaiter
+   * 
+   * awaitable counterpart of coro::Coroutine::coroWait. Returns true on a
+   * timeout and false if the runner was woken up.
+   */
+  class SleepAwaiter
+  {
+  public:
+    explicit SleepAwaiter(StacklessRunner& runner, time::Duration duration);
+
+    bool
+    await_ready() noexcept;
+
+    void
+    await_suspend(std::coroutine_handle<> handle);
+
+    bool
+    await_resume() noexcept;
+
+  private:
+    StacklessRunner& mRunner;
+    time::Duration mDuration;
+  };
+
+// ---------------------------------------------------------------------------
+  explicit StacklessRunner(core::Context& context, const char* name);
+
+  /**
+   * @param group
+   *  the runner is executed by the scheduler of the group (see RunnerGroup)
+   */
+  explicit StacklessRunner(core::RunnerGroup& group, const char* name);
+
+  StacklessRunner(const StacklessRunner&) = delete;
+
+  StacklessRunner(StacklessRunner&&) noexcept = delete;
+
+  StacklessRunner&
+  operator=(const StacklessRunner&) = delete;
+
+  StacklessRunner&
+  operator=(StacklessRunner&&) noexcept = delete;
+
+  ~StacklessRunner() override = default;
+
+// ---------------------------------------------------------------------------
+  virtual coro::Task<>
+  coProcess();
+
+// ---------------------------------------------------------------------------
+  void
+  coroResume() override;
+
+// ---------------------------------------------------------------------------
+  YieldAwaiter
+  yield();
+
+  SleepAwaiter
+  sleep(time::Duration duration);
+
+  coro::Task<bool>
+  waitInternal(time::Duration timeout, Condition* condition);
+
+  coro::Task<bool>
+  waitInternal(time::Duration timeout);
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief wait
+   * 
+   * awaitable counterparts of protest::wait (see api.h). Expressions are
+   * taken by reference, the result must be awaited immediately.
+   */
+  coro::Task<>
+  wait(time::Duration duration,
+       protest::meta::CallContext& callContext =
+           protest::meta::CallContext::defaultContext());
+
+  template <typename Expr>
+  std::enable_if_t<
+      !std::is_base_of_v<time::Duration, std::remove_const_t<Expr>>,
+      coro::Task<>>
+  wait(const Expr& condition,
+       protest::meta::CallContext& callContext =
+           protest::meta::CallContext::defaultContext());
+
+  template <typename Expr>
+  std::enable_if_t<
+      !std::is_base_of_v<time::Duration, std::remove_const_t<Expr>>,
+      coro::Task<bool>>
+  wait(const Expr& condition,
+       time::Duration timeout,
+       protest::meta::CallContext& callContext =
+           protest::meta::CallContext::defaultContext());
+
+  /**
+   * @brief push
+   * 
+   * awaitable counterpart of Signal::push. Yields before every delivery
+   * like Signal::push does, or once after all deliveries if the signal
+   * uses SignalRaw::Delivery::batched. Waits for space in the queue ports
+   * with QueueOptions::Overflow::block.
+   */
+  template <typename T>
+  coro::Task<>
+  push(Signal<T>& signal,
+       T value,
+       protest::meta::CallContext& callContext =
+           protest::meta::CallContext::defaultContext());
+
+  /**
+   * @brief pushBatch
+   * 
+   * awaitable counterpart of Signal::pushBatch. The values must stay alive
+   * until the task is completed.
+   */
+  template <typename T>
+  coro::Task<>
+  pushBatch(Signal<T>& signal,
+            const T* values,
+            size_t count,
+            protest::meta::CallContext& callContext =
+                protest::meta::CallContext::defaultContext());
+
+private:
+  coro::Task<>
+  body();
+
+  void
+  logWait(const char* tag,
+          protest::meta::CallContext& callContext,
+          const std::string& message);
+
+  // awaitable counterpart of QueuePortInternal::waitForSpace
+  template <typename Port>
+  coro::Task<>
+  waitForSpace(Port& port);
+
+  // awaitable counterpart of Signal::dispatch
+  template <typename Dispatch>
+  coro::Task<>
+  dispatch(Dispatch& dispatch);
+
+  coro::Task<> mBody;
+  // the innermost suspended task, resumed by coroResume
+  std::coroutine_handle<> mSuspended;
+};
+
+// ---------------------------------------------------------------------------
+template <typename Expr>
+std::enable_if_t<!std::is_base_of_v<time::Duration, std::remove_const_t<Expr>>,
+                 coro::Task<>>
+StacklessRunner::wait(const Expr& condition,
+                      protest::meta::CallContext& callContext)
+{
+  ExprCondition<Expr> expr(this, condition, this);
+  logWait("WAIT",
+          callContext,
+          "Wait for condition:\n'" + std::string(callContext.getArg(0)) + "'");
+
+  expr.enable();
+  const bool gotTimeout =
+      co_await waitInternal(time::Duration::infinity(), &expr);
+  PROTEST_ASSERT(!gotTimeout);
+  expr.disable();
+
+  logWait("RESM",
+          callContext,
+          "Condition is fulfilled:\n'" + std::string(callContext.getArg(0)) +
+              "'\n");
+}
+
+template <typename Expr>
+std::enable_if_t<!std::is_base_of_v<time::Duration, std::remove_const_t<Expr>>,
+                 coro::Task<bool>>
+StacklessRunner::wait(const Expr& condition,
+                      time::Duration timeout,
+                      protest::meta::CallContext& callContext)
+{
+  ExprCondition<Expr> expr(this, condition, this);
+  logWait("WAIT",
+          callContext,
+          "Wait for condition:\n'" + std::string(callContext.getArg(0)) +
+              "'\n");
+
+  expr.enable();
+  const bool gotTimeout = co_await waitInternal(timeout, &expr);
+  expr.disable();
+
+  if (!gotTimeout)
+  {
+    logWait("RESM",
+            callContext,
+            "Condition is fulfilled:\n'" + std::string(callContext.getArg(0)) +
+                "'\n");
+  }
+  else
+  {
+    logWait("RESM",
+            callContext,
+            "Condition is not fulfilled (timeout after " +
+                std::to_string(timeout.milliseconds()) + " ms):\n'" +
+                std::string(callContext.getArg(0)) + "'\n");
+  }
+  co_return !gotTimeout;
+}
+
+template <typename Port>
+coro::Task<>
+StacklessRunner::waitForSpace(Port& port)
+{
+  if (port.mustWait())
+  {
+    port.countBlocked(this);
+    auto expr = port.hasSpace();
+    ExprCondition<decltype(expr)> condition(this, expr, this);
+    condition.enable();
+    while (port.mustWait())
+    {
+      co_await waitInternal(time::Duration::infinity(), &condition);
+    }
+    condition.disable();
+  }
+  else
+  {
+  }
+}
+
+template <typename Dispatch>
+coro::Task<>
+StacklessRunner::dispatch(Dispatch& dispatch)
+{
+  auto step = dispatch.next();
+  while (step != Dispatch::Step::done)
+  {
+    if (step == Dispatch::Step::yield)
+    {
+      co_await yield();
+    }
+    else
+    {
+      co_await waitForSpace(dispatch.getQueuePort());
+    }
+    step = dispatch.next();
+  }
+}
+
+template <typename T>
+coro::Task<>
+StacklessRunner::push(Signal<T>& signal,
+                      T value,
+                      protest::meta::CallContext& callContext)
+{
+  signal.logPush(*this, value, callContext);
+
+  typename Signal<T>::Dispatch dispatch(
+      signal, &value, 1u, false, signal.getDelivery());
+  co_await this->dispatch(dispatch);
+}
+
+template <typename T>
+coro::Task<>
+StacklessRunner::pushBatch(Signal<T>& signal,
+                           const T* values,
+                           size_t count,
+                           protest::meta::CallContext& callContext)
+{
+  signal.logPushBatch(*this, count, callContext);
+
+  typename Signal<T>::Dispatch dispatch(
+      signal, values, count, true, signal.getDelivery());
+  co_await this->dispatch(dispatch);
+}
+
+} // namespace core
+
+} // namespace protest
@@ -35,6 +35,7 @@ Stopwatch::Operator::Operator(StopwatchInternal& stopwatch,
   mStopwatch(&stopwatch),
   mRunner(nullptr),
   mCondition(nullptr),
+  mNode(nullptr),
   mNext(nullptr)
 {
   mStopwatch->increment();
@@ -46,6 +47,7 @@ Stopwatch::Operator::Operator(const Operator& other) :
   mStopwatch(other.mStopwatch),
   mRunner(other.mRunner),
   mCondition(other.mCondition),
+  mNode(other.mNode),
   mNext(other.mNext)
 {
   mStopwatch->increment();
@@ -75,6 +77,13 @@ Stopwatch::Operator::removed(Job* /* job */)
   }
 }
 
+void
+Stopwatch::Operator::notifyCondition()
+{
+  ExprNode::invalidate(mNode);
+  mCondition->notifyListener();
+}
+
 // ---------------------------------------------------------------------------
 Stopwatch::Equals::Equals(StopwatchInternal& stopwatch,
                           time::Duration duration) :
@@ -83,18 +92,22 @@ Stopwatch::Equals::Equals(StopwatchInternal& stopwatch,
 }
 
 void
-Stopwatch::Equals::conditionEnable(RunnerRaw* runner, Condition* condition)
+Stopwatch::Equals::conditionEnable(RunnerRaw* runner,
+                                   Condition* condition,
+                                   ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::Equals::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::Equals::Type
@@ -106,13 +119,13 @@ Stopwatch::Equals::getValue()
 void
 Stopwatch::Equals::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::Equals::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -137,18 +150,22 @@ Stopwatch::NotEquals::NotEquals(StopwatchInternal& stopwatch,
 }
 
 void
-Stopwatch::NotEquals::conditionEnable(RunnerRaw* runner, Condition* condition)
+Stopwatch::NotEquals::conditionEnable(RunnerRaw* runner,
+                                      Condition* condition,
+                                      ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::NotEquals::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::NotEquals::Type
@@ -160,13 +177,13 @@ Stopwatch::NotEquals::getValue()
 void
 Stopwatch::NotEquals::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::NotEquals::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -191,18 +208,22 @@ Stopwatch::Greater::Greater(StopwatchInternal& stopwatch,
 }
 
 void
-Stopwatch::Greater::conditionEnable(RunnerRaw* runner, Condition* condition)
+Stopwatch::Greater::conditionEnable(RunnerRaw* runner,
+                                    Condition* condition,
+                                    ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::Greater::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::Greater::Type
@@ -214,13 +235,13 @@ Stopwatch::Greater::getValue()
 void
 Stopwatch::Greater::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::Greater::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -239,18 +260,21 @@ Stopwatch::GreaterOrEquals::GreaterOrEquals(StopwatchInternal& stopwatch,
 
 void
 Stopwatch::GreaterOrEquals::conditionEnable(RunnerRaw* runner,
-                                            Condition* condition)
+                                            Condition* condition,
+                                            ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::GreaterOrEquals::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::GreaterOrEquals::Type
@@ -262,13 +286,13 @@ Stopwatch::GreaterOrEquals::getValue()
 void
 Stopwatch::GreaterOrEquals::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::GreaterOrEquals::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -292,18 +316,22 @@ Stopwatch::Less::Less(StopwatchInternal& stopwatch, time::Duration duration) :
 }
 
 void
-Stopwatch::Less::conditionEnable(RunnerRaw* runner, Condition* condition)
+Stopwatch::Less::conditionEnable(RunnerRaw* runner,
+                                 Condition* condition,
+                                 ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::Less::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::Less::Type
@@ -315,13 +343,13 @@ Stopwatch::Less::getValue()
 void
 Stopwatch::Less::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::Less::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -340,18 +368,21 @@ Stopwatch::LessOrEquals::LessOrEquals(StopwatchInternal& stopwatch,
 
 void
 Stopwatch::LessOrEquals::conditionEnable(RunnerRaw* runner,
-                                         Condition* condition)
+                                         Condition* condition,
+                                         ExprNode* parent)
 {
   mRunner = runner;
   mCondition = condition;
-  mStopwatch->add(*this, mCondition);
+  mNode = parent;
+  ExprNode::invalidateAlways(mNode);
+  mStopwatch->add(*this);
   reset();
 }
 
 void
 Stopwatch::LessOrEquals::conditionDisable()
 {
-  mStopwatch->remove(*this, mCondition);
+  mStopwatch->remove(*this);
 }
 
 Stopwatch::LessOrEquals::Type
@@ -363,13 +394,13 @@ Stopwatch::LessOrEquals::getValue()
 void
 Stopwatch::LessOrEquals::notify(RunnerRaw* /* runner */)
 {
-  mCondition->notifyListener();
+  notifyCondition();
 }
 
 void
 Stopwatch::LessOrEquals::resetAndNotify()
 {
-  mCondition->notifyListener();
+  notifyCondition();
   reset();
 }
 
@@ -495,7 +526,7 @@ Stopwatch::StopwatchInternal::start()
     iter->updateDue(diff);
     if (!iter->isDue(mRunner->now()))
     {
-      mRunner->add(*iter);
+      arm(*iter);
     }
     else
     {
@@ -504,6 +535,7 @@ Stopwatch::StopwatchInternal::start()
     ++iter;
   }
   mRunning = true;
+  schedule();
 }
 
 void
@@ -518,7 +550,7 @@ Stopwatch::StopwatchInternal::stop()
   {
     if (iter->isArmed())
     {
-      mRunner->remove(*iter);
+      disarm(*iter);
     }
     else
     {
@@ -527,6 +559,7 @@ Stopwatch::StopwatchInternal::stop()
   }
   mStartOrStopedAt = now;
   mRunning = false;
+  schedule();
 }
 
 void
@@ -570,7 +603,8 @@ Stopwatch::StopwatchInternal::update(Operator& opr, time::Duration duration)
   opr.setDue(mRunner->now() + diff, &opr);
   if (mRunning && !opr.isDue(mRunner->now()))
   {
-    mRunner->add(opr);
+    arm(opr);
+    schedule();
   }
   else
   {
@@ -638,20 +672,19 @@ Stopwatch::StopwatchInternal::operator<=(time::Duration duration)
 }
 
 void
-Stopwatch::StopwatchInternal::add(Operator& opr, Condition* condition)
+Stopwatch::StopwatchInternal::add(Operator& opr)
 {
-  mConditions.prepend(*condition);
   mOperators.prepend(opr);
 }
 
 void
-Stopwatch::StopwatchInternal::remove(Operator& opr, Condition* condition)
+Stopwatch::StopwatchInternal::remove(Operator& opr)
 {
-  mConditions.remove(*condition);
   mOperators.remove(opr);
   if (opr.isArmed())
   {
-    mRunner->remove(opr);
+    disarm(opr);
+    schedule();
   }
   else
   {
@@ -659,6 +692,100 @@ Stopwatch::StopwatchInternal::remove(Operator& opr, Condition* condition)
   }
 }
 
+// ---------------------------------------------------------------------------
+void
+Stopwatch::StopwatchInternal::notify(RunnerRaw* runner)
+{
+  // cascade to all operators which are due by now
+  while (mDeadlines.isAvailable() && mDeadlines.peek()->isDue(runner->now()))
+  {
+    Job* opr = mDeadlines.pop();
+    opr->execute(runner);
+    opr->removed();
+  }
+  schedule();
+}
+
+void
+Stopwatch::StopwatchInternal::added(Job* /* job */)
+{
+  increment();
+}
+
+void
+Stopwatch::StopwatchInternal::removed(Job* /* job */)
+{
+  if (decrement())
+  {
+    delete this;
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+void
+Stopwatch::StopwatchInternal::arm(Operator& opr)
+{
+  mDeadlines.push(&opr);
+  opr.Job::added();
+}
+
+void
+Stopwatch::StopwatchInternal::disarm(Operator& opr)
+{
+  mDeadlines.remove(&opr);
+
+  // like RunnerRaw::remove, an operator which is due right now is executed
+  if (opr.isDue(mRunner->now()))
+  {
+    opr.execute(mRunner);
+  }
+  else
+  {
+    opr.notExecuted();
+  }
+  opr.Job::removed();
+}
+
+void
+Stopwatch::StopwatchInternal::schedule()
+{
+  if (mDeadlines.isEmpty())
+  {
+    if (mJob.isArmed())
+    {
+      mRunner->remove(mJob);
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    Job* next = mDeadlines.peek();
+    if (mJob.isArmed() && *next < mJob && !mJob.isDue(mRunner->now()))
+    {
+      // an earlier deadline was added -> move the job forward
+      mRunner->remove(mJob);
+    }
+    else
+    {
+      // a job which expires too early just schedules again
+    }
+
+    if (!mJob.isArmed())
+    {
+      mJob.setDue(mRunner->now() + next->timeTilDue(mRunner->now()), this);
+      mRunner->add(mJob);
+    }
+    else
+    {
+    }
+  }
+}
+
 // ---------------------------------------------------------------------------
 Stopwatch::Stopwatch(RunnerRaw* runner) :
   mInternal(new StopwatchInternal(runner))
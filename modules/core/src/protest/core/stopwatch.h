@@ -29,6 +29,7 @@
 #include "protest/time/duration.h"
 #include "protest/utils/list.h"
 #include "protest/core/runner_raw.h"
+#include "protest/utils/dynamic_heap.h"
 #include "protest/utils/ref_counter.h"
 
 namespace protest
@@ -81,10 +82,14 @@ public:
     removed(Job* job) override;
 
   protected:
+    void
+    notifyCondition();
+
     time::Duration mDuration;
     StopwatchInternal* mStopwatch;
     RunnerRaw* mRunner;
     Condition* mCondition;
+    ExprNode* mNode;
 
   private:
     Operator* mNext;
@@ -114,7 +119,9 @@ public:
     ~Equals() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -158,7 +165,9 @@ public:
     ~NotEquals() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -201,7 +210,9 @@ public:
     ~Greater() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -245,7 +256,9 @@ public:
     ~GreaterOrEquals() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -288,7 +301,9 @@ public:
     ~Less() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -332,7 +347,9 @@ public:
     ~LessOrEquals() = default;
 
     void
-    conditionEnable(RunnerRaw* runner, Condition* condition);
+    conditionEnable(RunnerRaw* runner,
+                    Condition* condition,
+                    ExprNode* parent);
 
     void
     conditionDisable();
@@ -404,8 +421,12 @@ private:
 // ---------------------------------------------------------------------------
   /**
    * @class StopwatchInternal
+   *
+   * The due times of all enabled operators are kept in a deadline list of
+   * their own. Only the next one is armed as a job in the runner, the other
+   * operators are executed in a cascade when it expires.
    */
-  class StopwatchInternal : public RefCounter
+  class StopwatchInternal final : public Job::Listener, public RefCounter
   {
   public:
     friend class GreaterEquals;
@@ -458,14 +479,34 @@ private:
     operator<=(time::Duration duration);
 
     void
-    add(Operator& opr, Condition* condition);
+    add(Operator& opr);
 
     void
-    remove(Operator& opr, Condition* condition);
+    remove(Operator& opr);
+
+// ---------------------------------------------------------------------------
+    void
+    notify(RunnerRaw* runner) override;
+
+    void
+    added(Job* job) override;
+
+    void
+    removed(Job* job) override;
 
   private:
-    List<Condition> mConditions;
+    void
+    arm(Operator& opr);
+
+    void
+    disarm(Operator& opr);
+
+    void
+    schedule();
+
     List<Operator> mOperators;
+    DynamicHeap<Job> mDeadlines;
+    Job mJob;
     RunnerRaw* mRunner;
     time::TimePoint mStartOrStopedAt;
     time::Duration mTimePassed;
@@ -30,12 +30,39 @@
 #include "protest/utils/can_invoke.h"
 #include "protest/utils/ref_counter.h"
 
+#include <cstring>
+
 namespace protest
 {
 
 namespace core
 {
 
+// ---------------------------------------------------------------------------
+/**
+ * @class Period
+ *
+ * Makes a Timer periodic. The timer expires at the start time plus
+ * multiples of the duration, so late executions do not add drift. If
+ * several periods expired at once, the callback is called once per period
+ * but at most maxCatchUp times (0 means no limit).
+ */
+class Period
+{
+public:
+  constexpr explicit Period(time::Duration duration, size_t maxCatchUp = 0u);
+
+  constexpr time::Duration
+  getDuration() const;
+
+  constexpr size_t
+  getMaxCatchUp() const;
+
+private:
+  time::Duration mDuration;
+  size_t mMaxCatchUp;
+};
+
 // ---------------------------------------------------------------------------
 /**
  * @class Timer
@@ -53,6 +80,11 @@ public:
                  time::Duration timeout,
                  meta::CallContext& context);
 
+  explicit Timer(RunnerRaw* runner,
+                 Callback callback,
+                 Period period,
+                 meta::CallContext& context);
+
   Timer(Timer&&) noexcept = delete;
 
   Timer&
@@ -67,6 +99,9 @@ public:
   void
   start(time::Duration duration);
 
+  void
+  start(Period period);
+
   void
   start();
 
@@ -101,6 +136,9 @@ private:
     void
     start(time::Duration duration);
 
+    void
+    start(Period period);
+
     void
     start();
 
@@ -127,12 +165,19 @@ private:
                            Callback callback,
                            meta::CallContext& callContext);
 
+    void
+    arm(time::Duration duration);
+
     RunnerRaw* mRunner;
     Callback mCallback;
     time::Duration mRemaining;
     time::Duration mStartValue;
     time::TimePoint mStartedAt;
+    time::Duration mPeriod;
+    size_t mMaxCatchUp;
     bool mArmed;
+    // number of the Timer handles, the armed job holds a reference too
+    size_t mHandles;
     Job mJob;
     meta::CallContext* mCallContext;
   };
@@ -144,11 +189,40 @@ private:
   TimerInternal* mInternal;
 };
 
+// ---------------------------------------------------------------------------
+constexpr Period::Period(time::Duration duration, size_t maxCatchUp) :
+  mDuration(duration),
+  mMaxCatchUp(maxCatchUp)
+{
+}
+
+constexpr time::Duration
+Period::getDuration() const
+{
+  return mDuration;
+}
+
+constexpr size_t
+Period::getMaxCatchUp() const
+{
+  return mMaxCatchUp;
+}
+
 // ---------------------------------------------------------------------------
 template <typename Callback>
 Timer<Callback>::~Timer()
 {
   // PROTEST_ASSERT(mInternal);
+  mInternal->mHandles--;
+  if (mInternal->mHandles == 0u && mInternal->mArmed &&
+      mInternal->mPeriod != time::Duration::zero())
+  {
+    // nobody could stop the timer anymore, it would expire forever
+    mInternal->stop();
+  }
+  else
+  {
+  }
   if (mInternal->decrement())
   {
     delete mInternal;
@@ -167,6 +241,13 @@ Timer<Callback>::start(time::Duration duration)
   mInternal->start(duration);
 }
 
+template <typename Callback>
+void
+Timer<Callback>::start(Period period)
+{
+  mInternal->start(period);
+}
+
 template <typename Callback>
 void
 Timer<Callback>::start()
@@ -193,13 +274,18 @@ template <typename Callback>
 void
 Timer<Callback>::TimerInternal::start(time::Duration duration)
 {
-  PROTEST_ASSERT(!mArmed);
-  mStartValue = duration;
-  mRemaining = duration;
-  mStartedAt = mRunner->now();
-  mJob.setDue(mStartedAt + mRemaining, this);
-  mRunner->add(mJob);
-  mArmed = true;
+  mPeriod = time::Duration::zero();
+  arm(duration);
+}
+
+template <typename Callback>
+void
+Timer<Callback>::TimerInternal::start(Period period)
+{
+  PROTEST_ASSERT(period.getDuration() > time::Duration::zero());
+  mPeriod = period.getDuration();
+  mMaxCatchUp = period.getMaxCatchUp();
+  arm(mPeriod);
 }
 
 template <typename Callback>
@@ -209,6 +295,7 @@ Timer<Callback>::TimerInternal::start()
   PROTEST_ASSERT(!mArmed);
   mStartedAt = mRunner->now();
   mJob.setDue(mStartedAt + mRemaining, this);
+  mJob.setPeriod(mPeriod);
   mRunner->add(mJob);
   mArmed = true;
 }
@@ -217,8 +304,23 @@ template <typename Callback>
 void
 Timer<Callback>::TimerInternal::stop()
 {
-  mRemaining = mRunner->now() - mStartedAt;
   PROTEST_ASSERT(mArmed);
+  if (mPeriod != time::Duration::zero())
+  {
+    // keep the phase: start() continues with the rest of the period
+    mRemaining = mJob.timeTilDue(mRunner->now());
+    if (mRemaining == time::Duration::zero())
+    {
+      mRemaining = mPeriod;
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    mRemaining = mRunner->now() - mStartedAt;
+  }
   mRunner->remove(mJob);
   mArmed = false;
 }
@@ -234,7 +336,21 @@ Timer<Callback>::TimerInternal::reset()
   else
   {
   }
-  start(mStartValue);
+  arm(mStartValue);
+}
+
+template <typename Callback>
+void
+Timer<Callback>::TimerInternal::arm(time::Duration duration)
+{
+  PROTEST_ASSERT(!mArmed);
+  mStartValue = duration;
+  mRemaining = duration;
+  mStartedAt = mRunner->now();
+  mJob.setDue(mStartedAt + mRemaining, this);
+  mJob.setPeriod(mPeriod);
+  mRunner->add(mJob);
+  mArmed = true;
 }
 
 template <typename Callback>
@@ -244,7 +360,16 @@ Timer<Callback>::TimerInternal::notify(RunnerRaw* /* runner */)
   PROTEST_ASSERT(mArmed);
   Timer timer(this);
 
-  mArmed = false;
+  // a periodic job stays armed unless it was removed while being due
+  mArmed = mJob.isArmed();
+  size_t expirations = mJob.getExpirations();
+  if (mMaxCatchUp != 0u && expirations > mMaxCatchUp)
+  {
+    expirations = mMaxCatchUp;
+  }
+  else
+  {
+  }
 
   const char* name = mCallContext->getObjectName();
   if (strlen(name) == 0)
@@ -261,13 +386,17 @@ Timer<Callback>::TimerInternal::notify(RunnerRaw* /* runner */)
   stream.operator std::ostream&() << "Timer '" << name << "' expired after:\n"
                                   << mStartValue.milliseconds() << " ms\n";
 
-  if constexpr (CanInvoke<decltype(mCallback), Timer&>::value)
-  {
-    mCallback(timer);
-  }
-  else
+  // stops catching up when the callback stops the timer
+  for (size_t i = 0; i < expirations && (i == 0 || mArmed); i++)
   {
-    mCallback();
+    if constexpr (CanInvoke<decltype(mCallback), Timer&>::value)
+    {
+      mCallback(timer);
+    }
+    else
+    {
+      mCallback();
+    }
   }
 }
 
@@ -282,6 +411,9 @@ template <typename Callback>
 void
 Timer<Callback>::TimerInternal::removed(Job* job)
 {
+  // false unless restarted by the callback, also if the runner cancelled
+  // the periodic job when it finished
+  mArmed = mJob.isArmed();
   if (decrement())
   {
     delete this;
@@ -301,7 +433,10 @@ Timer<Callback>::TimerInternal::TimerInternal(RunnerRaw* runner,
   mRemaining(time::Duration::infinity()),
   mStartValue(time::Duration::infinity()),
   mStartedAt(time::TimePoint::startOfEpoche()),
+  mPeriod(time::Duration::zero()),
+  mMaxCatchUp(0u),
   mArmed(false),
+  mHandles(0u),
   mCallContext(&callContext)
 {
 }
@@ -311,6 +446,7 @@ template <typename Callback>
 Timer<Callback>::Timer(TimerInternal* internal) : mInternal(internal)
 {
   mInternal->increment();
+  mInternal->mHandles++;
 }
 
 template <typename Callback>
@@ -327,6 +463,7 @@ Timer<Callback>::Timer(RunnerRaw* runner,
   mInternal(new TimerInternal(runner, callback, callContext))
 {
   mInternal->increment();
+  mInternal->mHandles++;
 }
 
 template <typename Callback>
@@ -337,9 +474,22 @@ Timer<Callback>::Timer(RunnerRaw* runner,
   mInternal(new TimerInternal(runner, callback, callContext))
 {
   mInternal->increment();
+  mInternal->mHandles++;
   mInternal->start(timeout);
 }
 
+template <typename Callback>
+Timer<Callback>::Timer(RunnerRaw* runner,
+                       Callback callback,
+                       Period period,
+                       meta::CallContext& callContext) :
+  mInternal(new TimerInternal(runner, callback, callContext))
+{
+  mInternal->increment();
+  mInternal->mHandles++;
+  mInternal->start(period);
+}
+
 } // namespace core
 
 } // namespace protest
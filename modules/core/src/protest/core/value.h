@@ -26,6 +26,12 @@
 
 #include "protest/core/expression.h"
 #include "protest/core/condition.h"
+#include "protest/utils/ref_counter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 
 namespace protest
 {
@@ -44,12 +50,20 @@ namespace protest
  * auto value = Value(32);
  * auto inv = createInvariant(value < 59);
  * 
+ * A comparison of an integral value with a constant (<, <=, >, >=, ==,
+ * != where the constant converts to the type of the value) is represented
+ * by a ThresholdExpr. It is not notified on every write but only if the
+ * written value crossed or hit the constant. Other expressions are
+ * notified on every write. The notified expressions of a write are
+ * notified in the reverse order of their registration (enabling of their
+ * condition), regardless of their kind.
  */
 template <typename T>
 class Value : public core::ConvertableToCopyExprTag
 {
 private:
   class Listener;
+  class ThresholdListener;
   class ValueInternal;
 
 public:
@@ -78,7 +92,57 @@ public:
 
 // ---------------------------------------------------------------------------
     void
-    conditionEnable(core::RunnerRaw* runner, core::Condition* condition);
+    conditionEnable(core::RunnerRaw* runner,
+                    core::Condition* condition,
+                    core::ExprNode* parent);
+
+    void
+    conditionDisable();
+
+    void
+    notify() override;
+
+    Type
+    getValue();
+
+  private:
+    ValueInternal* mInternal;
+    core::Condition* mCondition;
+    core::ExprNode* mNode;
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class ThresholdExpr
+   * 
+   * comparison of the value with the constant `threshold` (value on the
+   * left hand side)
+   */
+  template <typename Operation>
+  class ThresholdExpr : public ThresholdListener, public core::CopyExprTag
+  {
+  public:
+    using Type = bool;
+
+    explicit ThresholdExpr(ValueInternal* port, T threshold);
+
+    ThresholdExpr(const ThresholdExpr&);
+
+    ThresholdExpr(ThresholdExpr&&) noexcept = delete;
+
+    ThresholdExpr&
+    operator=(const ThresholdExpr&) = delete;
+
+    ThresholdExpr&
+    operator=(ThresholdExpr&&) noexcept = delete;
+
+    ~ThresholdExpr();
+
+// ---------------------------------------------------------------------------
+    void
+    conditionEnable(core::RunnerRaw* runner,
+                    core::Condition* condition,
+                    core::ExprNode* parent);
 
     void
     conditionDisable();
@@ -89,9 +153,12 @@ public:
     Type
     getValue();
 
+    operator Type();
+
   private:
     ValueInternal* mInternal;
     core::Condition* mCondition;
+    core::ExprNode* mNode;
   };
 
   using Type = ValueExpr;
@@ -106,6 +173,10 @@ public:
     // in the auto completion -> use a extra class with static method.
     static Type
     toCopyExpr(Value& port);
+
+    template <typename Operation>
+    static ThresholdExpr<Operation>
+    toThresholdExpr(Value& value, T threshold);
   };
 
 // ---------------------------------------------------------------------------
@@ -155,6 +226,7 @@ private:
   {
   public:
     friend class List<Listener>;
+    friend class ValueInternal;
 
     explicit Listener();
 
@@ -176,6 +248,41 @@ private:
   private:
     Listener* mNext;
     ValueInternal* mInternal;
+    uint64_t mRegistration;
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class ThresholdListener
+   */
+  class ThresholdListener
+  {
+  public:
+    friend class ValueInternal;
+
+    explicit ThresholdListener(T threshold);
+
+    ThresholdListener(const ThresholdListener&) = default;
+
+    ThresholdListener&
+    operator=(const ThresholdListener&) = delete;
+
+    ThresholdListener(ThresholdListener&&) noexcept = delete;
+
+    ThresholdListener&
+    operator=(ThresholdListener&&) noexcept = delete;
+
+    virtual ~ThresholdListener() = default;
+
+    virtual void
+    notify() = 0;
+
+    T
+    getThreshold() const;
+
+  private:
+    T mThreshold;
+    uint64_t mRegistration;
   };
 
 // ---------------------------------------------------------------------------
@@ -208,13 +315,39 @@ private:
     void
     remove(Listener* listener);
 
+    /**
+     * @brief addThreshold
+     * 
+     * the listeners are sorted by their threshold, so a write only visits
+     * the ones between the old and the new value. Only used for integral
+     * values.
+     */
+    void
+    addThreshold(ThresholdListener* listener);
+
+    void
+    removeThreshold(ThresholdListener* listener);
+
 // ---------------------------------------------------------------------------
   private:
+    template <typename Modifier>
     void
-    notify();
+    modify(Modifier modifier);
+
+    /**
+     * @param crossed
+     *  the threshold listeners to notify too, latest registration first
+     */
+    void
+    notify(const std::vector<ThresholdListener*>& crossed);
+
+    std::vector<ThresholdListener*>
+    collectThresholds(T previous);
 
     T mValue;
+    uint64_t mNumberOfRegistrations;
     protest::List<Listener> mListeners;
+    std::vector<ThresholdListener*> mThresholds;
   };
 
   ValueInternal* mInternal;
@@ -224,7 +357,8 @@ private:
 template <typename T>
 Value<T>::ValueExpr::ValueExpr(ValueInternal* port) :
   mInternal(port),
-  mCondition(nullptr)
+  mCondition(nullptr),
+  mNode(nullptr)
 {
   assert(mInternal);
   assert(port);
@@ -234,7 +368,8 @@ Value<T>::ValueExpr::ValueExpr(ValueInternal* port) :
 template <typename T>
 Value<T>::ValueExpr::ValueExpr(const ValueExpr& other) :
   mInternal(other.mInternal),
-  mCondition(other.mCondition)
+  mCondition(other.mCondition),
+  mNode(other.mNode)
 {
   assert(mInternal);
   mInternal->increment();
@@ -257,10 +392,12 @@ Value<T>::ValueExpr::~ValueExpr()
 template <typename T>
 void
 Value<T>::ValueExpr::conditionEnable(core::RunnerRaw* runner,
-                                     core::Condition* condition)
+                                     core::Condition* condition,
+                                     core::ExprNode* parent)
 {
   assert(mInternal);
   mCondition = condition;
+  mNode = parent;
   mInternal->add(this);
 }
 
@@ -277,6 +414,7 @@ void
 Value<T>::ValueExpr::notify()
 {
   assert(mCondition);
+  core::ExprNode::invalidate(mNode);
   mCondition->notifyListener();
 }
 
@@ -296,6 +434,106 @@ Value<T>::Converter::toCopyExpr(Value<T>& value)
   return Value<T>::ValueExpr(value.mInternal);
 }
 
+template <typename T>
+template <typename Operation>
+typename Value<T>::template ThresholdExpr<Operation>
+Value<T>::Converter::toThresholdExpr(Value<T>& value, T threshold)
+{
+  return Value<T>::ThresholdExpr<Operation>(value.mInternal, threshold);
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <typename Operation>
+Value<T>::ThresholdExpr<Operation>::ThresholdExpr(ValueInternal* port,
+                                                  T threshold) :
+  ThresholdListener(threshold),
+  mInternal(port),
+  mCondition(nullptr),
+  mNode(nullptr)
+{
+  assert(mInternal);
+  mInternal->increment();
+}
+
+template <typename T>
+template <typename Operation>
+Value<T>::ThresholdExpr<Operation>::ThresholdExpr(const ThresholdExpr& other) :
+  ThresholdListener(other),
+  mInternal(other.mInternal),
+  mCondition(other.mCondition),
+  mNode(other.mNode)
+{
+  assert(mInternal);
+  mInternal->increment();
+}
+
+template <typename T>
+template <typename Operation>
+Value<T>::ThresholdExpr<Operation>::~ThresholdExpr()
+{
+  if (mInternal->decrement())
+  {
+    delete mInternal;
+    mInternal = nullptr;
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+template <typename Operation>
+void
+Value<T>::ThresholdExpr<Operation>::conditionEnable(
+    core::RunnerRaw* /* runner */,
+    core::Condition* condition,
+    core::ExprNode* parent)
+{
+  assert(mInternal);
+  mCondition = condition;
+  mNode = parent;
+  mInternal->addThreshold(this);
+}
+
+template <typename T>
+template <typename Operation>
+void
+Value<T>::ThresholdExpr<Operation>::conditionDisable()
+{
+  assert(mInternal);
+  mInternal->removeThreshold(this);
+}
+
+template <typename T>
+template <typename Operation>
+void
+Value<T>::ThresholdExpr<Operation>::notify()
+{
+  assert(mCondition);
+  core::ExprNode::invalidate(mNode);
+  mCondition->notifyListener();
+}
+
+template <typename T>
+template <typename Operation>
+typename Value<T>::template ThresholdExpr<Operation>::Type
+Value<T>::ThresholdExpr<Operation>::getValue()
+{
+  assert(mInternal);
+  return core::BinaryResult<core::Copy<T>, core::Copy<T>, Operation>::apply(
+      mInternal->mValue,
+      this->getThreshold());
+}
+
+template <typename T>
+template <typename Operation>
+Value<T>::ThresholdExpr<Operation>::operator Type()
+{
+  return getValue();
+}
+
 // ---------------------------------------------------------------------------
 template <typename T>
 Value<T>::Value(T value) : mInternal(new ValueInternal(value))
@@ -325,8 +563,7 @@ template <typename U>
 Value<T>&
 Value<T>::operator=(U&& other)
 {
-  mInternal->mValue = other;
-  mInternal->notify();
+  mInternal->modify([&other](T& value) { value = other; });
   return *this;
 }
 
@@ -335,8 +572,7 @@ template <typename U>
 Value<T>&
 Value<T>::operator+=(U&& other)
 {
-  mInternal->mValue += other;
-  mInternal->notify();
+  mInternal->modify([&other](T& value) { value += other; });
   return *this;
 }
 
@@ -345,8 +581,7 @@ template <typename U>
 Value<T>&
 Value<T>::operator-=(U&& other)
 {
-  mInternal->mValue -= other;
-  mInternal->notify();
+  mInternal->modify([&other](T& value) { value -= other; });
   return *this;
 }
 
@@ -355,8 +590,7 @@ template <typename U>
 Value<T>&
 Value<T>::operator*=(U&& other)
 {
-  mInternal->mValue *= other;
-  mInternal->notify();
+  mInternal->modify([&other](T& value) { value *= other; });
   return *this;
 }
 
@@ -365,8 +599,7 @@ template <typename U>
 Value<T>&
 Value<T>::operator/=(U&& other)
 {
-  mInternal->mValue /= other;
-  mInternal->notify();
+  mInternal->modify([&other](T& value) { value /= other; });
   return *this;
 }
 
@@ -378,13 +611,33 @@ Value<T>::operator T()
 
 // ---------------------------------------------------------------------------
 template <typename T>
-Value<T>::Listener::Listener() : mNext(nullptr), mInternal(nullptr)
+Value<T>::Listener::Listener() :
+  mNext(nullptr),
+  mInternal(nullptr),
+  mRegistration(0u)
+{
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Value<T>::ThresholdListener::ThresholdListener(T threshold) :
+  mThreshold(threshold),
+  mRegistration(0u)
+{
+}
+
+template <typename T>
+T
+Value<T>::ThresholdListener::getThreshold() const
 {
+  return mThreshold;
 }
 
 // ---------------------------------------------------------------------------
 template <typename T>
-Value<T>::ValueInternal::ValueInternal(T value) : mValue(value)
+Value<T>::ValueInternal::ValueInternal(T value) :
+  mValue(value),
+  mNumberOfRegistrations(0u)
 {
 }
 
@@ -393,6 +646,7 @@ template <typename T>
 void
 Value<T>::ValueInternal::add(Listener* listener)
 {
+  listener->mRegistration = mNumberOfRegistrations++;
   mListeners.prepend(*listener);
 }
 
@@ -403,19 +657,148 @@ Value<T>::ValueInternal::remove(Listener* listener)
   mListeners.remove(*listener);
 }
 
+template <typename T>
+void
+Value<T>::ValueInternal::addThreshold(ThresholdListener* listener)
+{
+  listener->mRegistration = mNumberOfRegistrations++;
+  // behind all listeners with the same threshold
+  auto position = std::upper_bound(
+      mThresholds.begin(),
+      mThresholds.end(),
+      listener->getThreshold(),
+      [](T threshold, ThresholdListener* other) {
+        return threshold < other->getThreshold();
+      });
+  mThresholds.insert(position, listener);
+}
+
+template <typename T>
+void
+Value<T>::ValueInternal::removeThreshold(ThresholdListener* listener)
+{
+  auto position = std::find(mThresholds.begin(), mThresholds.end(), listener);
+  PROTEST_ASSERT(position != mThresholds.end());
+  mThresholds.erase(position);
+}
+
 // ---------------------------------------------------------------------------
+template <typename T>
+template <typename Modifier>
+void
+Value<T>::ValueInternal::modify(Modifier modifier)
+{
+  if constexpr (std::is_integral_v<T>)
+  {
+    const T previous = mValue;
+    modifier(mValue);
+    // a local list, a listener may write the value again while notified
+    notify(collectThresholds(previous));
+  }
+  else
+  {
+    modifier(mValue);
+    notify({});
+  }
+}
+
 template <typename T>
 void
-Value<T>::ValueInternal::notify()
+Value<T>::ValueInternal::notify(
+    const std::vector<ThresholdListener*>& crossedListeners)
 {
+  // both are ordered by descending registration (mListeners is prepended)
+  // -> merge them
   auto iter = mListeners.begin();
-  while (iter != mListeners.end())
+  auto crossed = crossedListeners.begin();
+  while (iter != mListeners.end() || crossed != crossedListeners.end())
+  {
+    if (crossed == crossedListeners.end() ||
+        (iter != mListeners.end() &&
+         iter->mRegistration > (*crossed)->mRegistration))
+    {
+      iter->notify();
+      ++iter;
+    }
+    else
+    {
+      (*crossed)->notify();
+      ++crossed;
+    }
+  }
+}
+
+template <typename T>
+std::vector<typename Value<T>::ThresholdListener*>
+Value<T>::ValueInternal::collectThresholds(T previous)
+{
+  // the result of a comparison with a threshold outside of
+  // [min(previous, value), max(previous, value)] has not changed
+  const T low = std::min(previous, mValue);
+  const T high = std::max(previous, mValue);
+  auto iter = std::lower_bound(mThresholds.begin(),
+                               mThresholds.end(),
+                               low,
+                               [](ThresholdListener* listener, T threshold) {
+                                 return listener->getThreshold() < threshold;
+                               });
+  std::vector<ThresholdListener*> crossed;
+  while (low != high && iter != mThresholds.end() &&
+         (*iter)->getThreshold() <= high)
   {
-    iter->notify();
+    crossed.push_back(*iter);
     ++iter;
   }
+  std::sort(crossed.begin(),
+            crossed.end(),
+            [](ThresholdListener* lhs, ThresholdListener* rhs) {
+              return lhs->mRegistration > rhs->mRegistration;
+            });
+  return crossed;
 }
 
+// ---------------------------------------------------------------------------
+/**
+ * is true if the comparison of a Value<T> with a constant of type U is
+ * indexed (see Value::ThresholdExpr). The constant is converted to T by
+ * the comparison anyway, so the index can use T.
+ */
+template <typename T, typename U>
+inline constexpr bool isThresholdComparison =
+    std::is_integral_v<T> && std::is_integral_v<U> &&
+    std::is_same_v<std::common_type_t<T, U>, T>;
+
+// the constant is on the right hand side of `opr` and on the left hand
+// side of `mirrored`. Preferred to the generic operators of core since
+// they are more specialized.
+#define VALUE_THRESHOLD_OPERATOR(oprcls, opr, mirrored)                        \
+  template <typename T, typename U>                                            \
+  std::enable_if_t<isThresholdComparison<T, U>,                                \
+                   typename Value<T>::template ThresholdExpr<core::oprcls>>    \
+  operator opr(Value<T> value, U threshold)                                    \
+  {                                                                            \
+    return Value<T>::Converter::template toThresholdExpr<core::oprcls>(        \
+        value,                                                                 \
+        static_cast<T>(threshold));                                            \
+  }                                                                            \
+                                                                               \
+  template <typename T, typename U>                                            \
+  std::enable_if_t<isThresholdComparison<T, U>,                                \
+                   typename Value<T>::template ThresholdExpr<core::mirrored>>  \
+  operator opr(U threshold, Value<T> value)                                    \
+  {                                                                            \
+    return Value<T>::Converter::template toThresholdExpr<core::mirrored>(      \
+        value,                                                                 \
+        static_cast<T>(threshold));                                            \
+  }
+
+VALUE_THRESHOLD_OPERATOR(Equals, ==, Equals);
+VALUE_THRESHOLD_OPERATOR(NotEquals, !=, NotEquals);
+VALUE_THRESHOLD_OPERATOR(Greater, >, Less);
+VALUE_THRESHOLD_OPERATOR(GreaterOrEquals, >=, LessOrEquals);
+VALUE_THRESHOLD_OPERATOR(Less, <, Greater);
+VALUE_THRESHOLD_OPERATOR(LessOrEquals, <=, GreaterOrEquals);
+
 // } // namespace core
 
 } // namespace protest
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/context.h"
+#include "protest/core/context_pool.h"
+#include "protest/core/runner_raw.h"
+#include "protest/log/logger.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace protest::core;
+using namespace protest::time;
+
+namespace
+{
+
+class SleepingRunner : public RunnerRaw
+{
+public:
+  explicit SleepingRunner(Context& context, size_t index) :
+    RunnerRaw(context, "main"),
+    mIndex(index)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (size_t i = 0; i <= mIndex; i++)
+    {
+      getLogger().startLog("INFO", "main", now()) << "context " << mIndex
+                                                  << "\n";
+      waitInternal(Millisecond(10));
+    }
+    mEnd = now();
+    coroExit();
+  }
+
+  size_t mIndex;
+  TimePoint mEnd;
+};
+
+int
+runContext(size_t index, TimePoint* end)
+{
+  Context context;
+  EXPECT_EQ(nullptr, Context::getCurrentContext());
+  SleepingRunner runner(context, index);
+  const int exitValue = context.run();
+  EXPECT_EQ(&context, Context::getCurrentContext());
+  end[index] = runner.mEnd;
+  return exitValue + static_cast<int>(index);
+}
+
+} // namespace
+
+TEST(context_pool, should_run_contexts_with_own_clock)
+{
+  static constexpr size_t numberOfContexts = 8;
+  TimePoint end[numberOfContexts];
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+
+  ContextPool pool(4);
+  const int exitValue =
+      pool.run(numberOfContexts, [&](size_t index) -> int {
+        return runContext(index, &end[0]);
+      });
+
+  ASSERT_EQ(4u, pool.getNumberOfWorkers());
+  for (size_t i = 0; i < numberOfContexts; i++)
+  {
+    ASSERT_EQ(static_cast<int64_t>((i + 1) * 10), end[i].milliseconds());
+    ASSERT_EQ(static_cast<int>(i), pool.getExitValue(i));
+  }
+  ASSERT_EQ(1, exitValue);
+}
+
+TEST(context_pool, should_write_output_in_order_of_indices)
+{
+  static constexpr size_t numberOfContexts = 6;
+  TimePoint end[numberOfContexts];
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+
+  ContextPool pool(3);
+  pool.run(numberOfContexts, [&](size_t index) -> int {
+    return runContext(numberOfContexts - 1 - index, &end[0]);
+  });
+
+  std::string expected;
+  for (size_t i = 0; i < numberOfContexts; i++)
+  {
+    const std::string& contextOutput = pool.getOutput(i);
+    const std::string line =
+        "context " + std::to_string(numberOfContexts - 1 - i);
+    ASSERT_NE(std::string::npos, contextOutput.find(line));
+    expected += contextOutput;
+  }
+  ASSERT_EQ(expected, output.str());
+}
+
+TEST(context_pool, should_rethrow_the_exception_of_a_context)
+{
+  static constexpr size_t numberOfContexts = 4;
+  TimePoint end[numberOfContexts];
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+
+  ContextPool pool(2);
+  auto main = [&](size_t index) -> int {
+    if (index == 1u)
+    {
+      throw std::runtime_error("context 1 failed");
+    }
+    else
+    {
+    }
+    return runContext(index, &end[0]);
+  };
+  ASSERT_THROW(pool.run(numberOfContexts, main), std::runtime_error);
+
+  ASSERT_EQ(3, pool.getExitValue(3));
+  ASSERT_NE(std::string::npos, output.str().find("context 3"));
+}
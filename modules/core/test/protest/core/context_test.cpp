@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/context.h"
+#include "protest/core/runner_group.h"
+#include "protest/core/runner_raw.h"
+#include "protest/log/logger.h"
+#include "protest/log/trace_reader.h"
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace protest::core;
+using namespace protest::time;
+
+namespace
+{
+
+class YieldingRunner : public RunnerRaw
+{
+public:
+  explicit YieldingRunner(Context& context, const char* name) :
+    RunnerRaw(context, name)
+  {
+  }
+
+  explicit YieldingRunner(RunnerGroup& group, const char* name) :
+    RunnerRaw(group, name)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      coroYield();
+      waitInternal(Millisecond(10));
+    }
+  }
+};
+
+class LoggingRunner : public RunnerRaw
+{
+public:
+  explicit LoggingRunner(Context& context, const char* name) :
+    RunnerRaw(context, name)
+  {
+  }
+
+  explicit LoggingRunner(RunnerGroup& group, const char* name) :
+    RunnerRaw(group, name)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      getLogger().startLog("INFO", getName(), now())
+          << "step " << i << "\nof 3";
+      waitInternal(Millisecond(10));
+    }
+  }
+};
+
+// logs synchronously if logFile is null
+std::string
+runLoggingRunners(const char* logFile)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    if (logFile != nullptr)
+    {
+      context.setAsyncLog(logFile);
+    }
+    else
+    {
+    }
+    LoggingRunner first(context, "tsk1");
+    LoggingRunner second(context, "tsk2");
+    context.run();
+  }
+  return output.str();
+}
+
+} // namespace
+
+TEST(context, should_write_statistics_as_json)
+{
+  std::ostringstream output;
+  std::ostringstream statistics;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    RunnerGroup group(context);
+    YieldingRunner first(context, "tsk1");
+    YieldingRunner second(group, "tsk2");
+    ASSERT_EQ(0, context.run());
+    context.writeStatistics(statistics);
+  }
+
+  const std::string json = statistics.str();
+  ASSERT_NE(std::string::npos, json.find("\"group\": 0, \"switches\""));
+  ASSERT_NE(std::string::npos, json.find("\"group\": 1, \"switches\""));
+  ASSERT_NE(std::string::npos,
+            json.find("{\"name\": \"tsk1\", \"group\": 0,"));
+  ASSERT_NE(std::string::npos,
+            json.find("{\"name\": \"tsk2\", \"group\": 1,"));
+  if (protest::coro::isInstrumentationEnabled)
+  {
+    ASSERT_NE(std::string::npos, json.find("\"instrumentation\": true"));
+    ASSERT_NE(std::string::npos,
+              json.find("{\"name\": \"tsk1\", \"group\": 0, \"switches\": 1, "
+                        "\"yields\": 3, \"sleeps\": 4, \"wakeups\": 0"));
+  }
+  else
+  {
+    ASSERT_NE(std::string::npos, json.find("\"instrumentation\": false"));
+  }
+}
+
+TEST(context, should_report_stack_usage_in_summary)
+{
+  std::ostringstream output;
+  std::vector<Context::StackUsage> usage;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    YieldingRunner unpainted(context, "tsk0");
+    context.setStackMode(Context::StackMode::measure);
+    RunnerGroup group(context);
+    YieldingRunner first(context, "tsk1");
+    YieldingRunner second(group, "tsk2");
+    YieldingRunner third(group, "tsk2");
+    ASSERT_EQ(0, context.run());
+    usage = context.getStackUsage();
+  }
+
+  ASSERT_EQ(2u, usage.size());
+  ASSERT_EQ("tsk1", usage[0].mName);
+  ASSERT_EQ("tsk2", usage[1].mName);
+  for (const auto& entry : usage)
+  {
+    ASSERT_GT(entry.mPeak, 0u);
+    ASSERT_LT(entry.mPeak, entry.mSize);
+  }
+  ASSERT_NE(std::string::npos,
+            output.str().find("* STACK USAGE (PEAK / SIZE IN BYTES):\n"));
+  ASSERT_NE(std::string::npos, output.str().find("* tsk2  "));
+  ASSERT_EQ(std::string::npos, output.str().find("* tsk0  "));
+}
+
+TEST(context, should_right_size_stacks_from_persisted_usage)
+{
+  std::ostringstream output;
+  std::stringstream sizes;
+  protest::log::OutputScope outputScope(output);
+  size_t peak = 0;
+  {
+    Context context;
+    context.setStackMode(Context::StackMode::adapt);
+    YieldingRunner runner(context, "my runner");
+    ASSERT_EQ(protest::coro::CoroutineBase::defaultStackSize,
+              runner.getStackSize());
+    ASSERT_EQ(0, context.run());
+    peak = runner.getStackUsage();
+    context.writeStackSizes(sizes);
+  }
+  ASSERT_EQ(std::to_string(peak) + " my runner\n", sizes.str());
+
+  {
+    Context context;
+    context.setStackMode(Context::StackMode::adapt);
+    context.readStackSizes(sizes);
+    ASSERT_EQ(peak * Context::stackSizeFactor,
+              context.getStackSize("my runner"));
+    ASSERT_EQ(protest::coro::CoroutineBase::defaultStackSize,
+              context.getStackSize("other"));
+    YieldingRunner runner(context, "my runner");
+    ASSERT_LT(runner.getStackSize(),
+              protest::coro::CoroutineBase::defaultStackSize);
+    ASSERT_EQ(0, context.run());
+    ASSERT_LT(runner.getStackUsage(), runner.getStackSize());
+
+    // the heap stacks have no guard page
+    std::vector<protest::coro::StackAllocator::Stack> stacks;
+    while (protest::coro::StackAllocator::hasGuardPages())
+    {
+      stacks.push_back(protest::coro::StackAllocator::allocate(0));
+    }
+    ASSERT_EQ(protest::coro::CoroutineBase::defaultStackSize,
+              context.getStackSize("my runner"));
+    for (auto& stack : stacks)
+    {
+      protest::coro::StackAllocator::release(stack);
+    }
+    protest::coro::StackAllocator::trim();
+
+    context.setStackMode(Context::StackMode::fixed);
+    ASSERT_EQ(protest::coro::CoroutineBase::defaultStackSize,
+              context.getStackSize("my runner"));
+  }
+}
+
+TEST(context, should_write_the_same_log_asynchronously)
+{
+  const std::string output = runLoggingRunners(nullptr);
+  ASSERT_NE(std::string::npos, output.find("step 2\n"));
+  ASSERT_EQ(output, runLoggingRunners(""));
+
+  const char* fileName = "context_test_async.log";
+  ASSERT_EQ("", runLoggingRunners(fileName));
+  std::ifstream file(fileName);
+  ASSERT_EQ(output,
+            std::string(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>()));
+  std::remove(fileName);
+}
+
+TEST(context, should_log_synchronously_without_the_log_file)
+{
+  const std::string output = runLoggingRunners(nullptr);
+  ASSERT_EQ(output, runLoggingRunners("no_such_directory/async.log"));
+}
+
+TEST(context, should_write_the_async_log_on_terminate)
+{
+  const char* fileName = "context_test_terminate.log";
+  ASSERT_DEATH(
+      {
+        Context context;
+        context.setAsyncLog(fileName);
+        protest::log::Logger::getOutput() << "before terminate\n";
+        std::terminate();
+      },
+      "");
+  std::ifstream file(fileName);
+  ASSERT_EQ("before terminate\n",
+            std::string(std::istreambuf_iterator<char>(file),
+                        std::istreambuf_iterator<char>()));
+  std::remove(fileName);
+}
+
+TEST(context, should_render_a_trace_like_the_log)
+{
+  const char* fileName = "context_test.trace";
+  auto run = [&](bool isTraced) {
+    std::ostringstream output;
+    protest::log::OutputScope outputScope(output);
+    {
+      Context context;
+      if (isTraced)
+      {
+        context.setTrace(fileName);
+      }
+      else
+      {
+      }
+      RunnerGroup group(context);
+      LoggingRunner first(context, "tsk1");
+      LoggingRunner second(group, "tsk2");
+      context.run();
+    }
+    return output.str();
+  };
+
+  const std::string output = run(false);
+  ASSERT_NE(std::string::npos, output.find("tsk2"));
+  ASSERT_EQ("", run(true));
+
+  std::ifstream file(fileName, std::ios::binary);
+  std::ostringstream rendered;
+  protest::log::TraceReader reader(file);
+  ASSERT_TRUE(reader.render(rendered));
+  ASSERT_EQ(output, rendered.str());
+  std::remove(fileName);
+}
+
+TEST(context, should_reject_unknown_stack_modes)
+{
+  const char* valid[] = {"context_test", "--stack-mode=measure"};
+  const char* invalid[] = {"context_test", "--stack-mode=adpt"};
+  Context context;
+  context.initialize(2, valid);
+  ASSERT_EQ(Context::StackMode::measure, context.getStackMode());
+  ASSERT_THROW(context.initialize(2, invalid), std::runtime_error);
+  ASSERT_EQ(Context::StackMode::measure, context.getStackMode());
+}
+
+TEST(context, should_escape_runner_names_in_statistics)
+{
+  std::ostringstream output;
+  std::ostringstream statistics;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    YieldingRunner runner(context, "q\"\\");
+    ASSERT_EQ(0, context.run());
+    context.writeStatistics(statistics);
+  }
+
+  ASSERT_NE(std::string::npos,
+            statistics.str().find("{\"name\": \"q\\\"\\\\\", \"group\": 0,"));
+}
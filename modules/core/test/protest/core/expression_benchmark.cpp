@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/condition.h"
+#include "protest/core/value.h"
+#include "protest/coro/benchmark.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace protest::core;
+using protest::Value;
+using protest::benchmark::report;
+
+namespace
+{
+
+constexpr size_t numberOfTerms = 50u;
+constexpr size_t numberOfWrites = 2000000u;
+constexpr int limit = 100;
+
+// double values are not indexed (see Value::ThresholdExpr), so every write
+// notifies the invariant
+using Values = std::vector<std::unique_ptr<Value<double>>>;
+
+template <size_t... Index>
+auto
+createInvariant(Values& values, std::index_sequence<Index...>)
+{
+  return ((*values[Index] < limit) && ...);
+}
+
+// evaluates the invariant on every notification like Invariant does
+class InvariantListener : public Condition::Listener
+{
+public:
+  void
+  notify() override
+  {
+    mViolations += mCondition->isFulfilled() ? 0u : 1u;
+  }
+
+  Condition* mCondition = nullptr;
+  size_t mViolations = 0u;
+};
+
+Values
+createValues()
+{
+  Values values;
+  for (size_t i = 0; i < numberOfTerms; i++)
+  {
+    values.emplace_back(new Value<double>(0));
+  }
+  return values;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(core_benchmark, invariant_with_50_terms)
+{
+  Values values = createValues();
+  auto invariant =
+      createInvariant(values, std::make_index_sequence<numberOfTerms>());
+
+  // a disabled expression is not tracked and evaluates all terms
+  size_t violations = 0u;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < numberOfWrites; i++)
+  {
+    *values[i % numberOfTerms] = static_cast<double>(i % (limit + 1));
+    violations += invariant.getValue() ? 0u : 1u;
+  }
+  auto end = std::chrono::steady_clock::now();
+  report("invariant with 50 terms (full)", "writes", numberOfWrites,
+         end - start);
+
+  InvariantListener listener;
+  ExprCondition<decltype(invariant)> condition(nullptr, invariant, &listener);
+  listener.mCondition = &condition;
+  condition.enable();
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < numberOfWrites; i++)
+  {
+    *values[i % numberOfTerms] = static_cast<double>(i % (limit + 1));
+  }
+  end = std::chrono::steady_clock::now();
+  condition.disable();
+  report("invariant with 50 terms (incremental)", "writes", numberOfWrites,
+         end - start);
+
+  ASSERT_EQ(violations, listener.mViolations);
+}
+
+TEST(core_benchmark, wait_for_counter)
+{
+  constexpr int numberOfIncrements = 10000000;
+  auto counter = Value(0);
+
+  // the generic expression is notified on every increment
+  auto generic = counter + 0 == numberOfIncrements;
+  InvariantListener genericListener;
+  ExprCondition<decltype(generic)> genericCondition(nullptr,
+                                                    generic,
+                                                    &genericListener);
+  genericListener.mCondition = &genericCondition;
+  genericCondition.enable();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < numberOfIncrements; i++)
+  {
+    counter += 1;
+  }
+  auto end = std::chrono::steady_clock::now();
+  genericCondition.disable();
+  report("wait for counter (generic)", "increments", numberOfIncrements,
+         end - start);
+
+  // the indexed one only when the counter reaches the threshold
+  counter = 0;
+  auto indexed = counter == numberOfIncrements;
+  InvariantListener indexedListener;
+  ExprCondition<decltype(indexed)> indexedCondition(nullptr,
+                                                    indexed,
+                                                    &indexedListener);
+  indexedListener.mCondition = &indexedCondition;
+  indexedCondition.enable();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < numberOfIncrements; i++)
+  {
+    counter += 1;
+  }
+  end = std::chrono::steady_clock::now();
+  indexedCondition.disable();
+  report("wait for counter (indexed)", "increments", numberOfIncrements,
+         end - start);
+
+  ASSERT_EQ(numberOfIncrements - 1, genericListener.mViolations);
+  ASSERT_EQ(0u, indexedListener.mViolations);
+}
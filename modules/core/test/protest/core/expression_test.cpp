@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/condition.h"
+#include "protest/core/expression.h"
+#include "protest/core/value.h"
+
+using namespace protest::core;
+
+namespace
+{
+
+// leaf which counts how often it is evaluated
+struct Counter
+{
+  int mValue = 0;
+  size_t mEvaluations = 0;
+  Condition* mCondition = nullptr;
+  ExprNode* mNode = nullptr;
+};
+
+class CountingExpr : public CopyExprTag
+{
+public:
+  using Type = int;
+
+  explicit CountingExpr(Counter& counter) : mCounter(&counter)
+  {
+  }
+
+  Type
+  getValue()
+  {
+    mCounter->mEvaluations++;
+    return mCounter->mValue;
+  }
+
+  void
+  conditionEnable(RunnerRaw* /* runner */,
+                  Condition* condition,
+                  ExprNode* parent)
+  {
+    mCounter->mCondition = condition;
+    mCounter->mNode = parent;
+  }
+
+  void
+  conditionDisable()
+  {
+    mCounter->mCondition = nullptr;
+    mCounter->mNode = nullptr;
+  }
+
+private:
+  Counter* mCounter;
+};
+
+void
+set(Counter& counter, int value)
+{
+  counter.mValue = value;
+  ExprNode::invalidate(counter.mNode);
+  if (counter.mCondition != nullptr)
+  {
+    counter.mCondition->notifyListener();
+  }
+  else
+  {
+  }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(expression, should_evaluate_only_changed_subtrees)
+{
+  Counter a, b, c, d;
+  set(a, 1);
+  set(b, 1);
+  set(c, 1);
+  set(d, 1);
+  auto expr = (CountingExpr(a) + CountingExpr(b)) +
+                  (CountingExpr(c) + CountingExpr(d)) ==
+              4;
+  ExprCondition<decltype(expr)> condition(nullptr, expr, nullptr);
+  condition.enable();
+
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_EQ(1u, a.mEvaluations);
+  ASSERT_EQ(1u, d.mEvaluations);
+
+  // leaves are not cached, only the nodes on the path to the root
+  set(a, 2);
+  ASSERT_FALSE(condition.isFulfilled());
+  ASSERT_EQ(2u, a.mEvaluations);
+  ASSERT_EQ(2u, b.mEvaluations);
+  ASSERT_EQ(1u, c.mEvaluations);
+  ASSERT_EQ(1u, d.mEvaluations);
+
+  set(d, 0);
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_EQ(2u, a.mEvaluations);
+  ASSERT_EQ(2u, b.mEvaluations);
+  ASSERT_EQ(2u, c.mEvaluations);
+  ASSERT_EQ(2u, d.mEvaluations);
+  condition.disable();
+}
+
+TEST(expression, should_short_circuit_and_and_or)
+{
+  Counter a, b;
+  set(a, 20);
+  auto expr = CountingExpr(a) < 10 && CountingExpr(b) < 10;
+  ExprCondition<decltype(expr)> condition(nullptr, expr, nullptr);
+  condition.enable();
+
+  ASSERT_FALSE(condition.isFulfilled());
+  ASSERT_EQ(0u, b.mEvaluations);
+
+  // the result does not depend on b as long as a is unchanged
+  set(b, 5);
+  ASSERT_FALSE(condition.isFulfilled());
+  ASSERT_EQ(1u, a.mEvaluations);
+  ASSERT_EQ(0u, b.mEvaluations);
+
+  set(a, 5);
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_EQ(1u, b.mEvaluations);
+
+  set(b, 15);
+  ASSERT_FALSE(condition.isFulfilled());
+  ASSERT_EQ(2u, a.mEvaluations);
+  ASSERT_EQ(2u, b.mEvaluations);
+  condition.disable();
+
+  auto other = CountingExpr(a) < 10 || CountingExpr(b) < 10;
+  ASSERT_TRUE(other.getValue());
+  ASSERT_EQ(2u, b.mEvaluations);
+}
+
+TEST(expression, should_evaluate_disabled_expressions_completely)
+{
+  Counter a;
+  auto expr = !(CountingExpr(a) > 0);
+  ExprCondition<decltype(expr)> condition(nullptr, expr, nullptr);
+
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_EQ(2u, a.mEvaluations);
+
+  condition.enable();
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_TRUE(condition.isFulfilled());
+  ASSERT_EQ(3u, a.mEvaluations);
+  condition.disable();
+
+  // changes are not tracked anymore
+  a.mValue = 1;
+  ASSERT_FALSE(condition.isFulfilled());
+  ASSERT_EQ(4u, a.mEvaluations);
+}
+
+TEST(expression, should_track_changes_of_values)
+{
+  auto first = protest::Value(1);
+  auto second = protest::Value(2);
+  auto expr = first < 5 && second < 5;
+  ExprCondition<decltype(expr)> condition(nullptr, expr, nullptr);
+  condition.enable();
+
+  ASSERT_TRUE(condition.isFulfilled());
+  second = 7;
+  ASSERT_FALSE(condition.isFulfilled());
+  first = 9;
+  ASSERT_FALSE(condition.isFulfilled());
+  second = 1;
+  ASSERT_FALSE(condition.isFulfilled());
+  first = 3;
+  ASSERT_TRUE(condition.isFulfilled());
+  condition.disable();
+}
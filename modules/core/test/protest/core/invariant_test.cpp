@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/context.h"
+#include "protest/core/invariant.h"
+#include "protest/core/runner_raw.h"
+#include "protest/core/value.h"
+#include "protest/log/logger.h"
+
+#include <sstream>
+#include <string>
+
+using namespace protest::core;
+using namespace protest::time;
+
+namespace
+{
+
+protest::meta::Invariant&
+invariantContext()
+{
+  static protest::meta::Unit unit("invariant_test");
+  static protest::meta::Invariant context(unit, 0, "", {"value < 10"}, {});
+  return context;
+}
+
+// owns an invariant on a value which is written by itself and by the
+// WritingRunner
+class OwningRunner : public RunnerRaw
+{
+public:
+  explicit OwningRunner(Context& context, protest::Value<int>& value) :
+    RunnerRaw(context, "owner"),
+    mValue(value),
+    mHoldsAfterBurst(false),
+    mHoldsAfterViolation(true)
+  {
+  }
+
+  void
+  process() override
+  {
+    Invariant invariant(this, mValue < 10, &invariantContext());
+    invariant.start();
+
+    // violated and restored in the same time step
+    for (int i = 0; i < 100; i++)
+    {
+      mValue = 20;
+      mValue = i % 10;
+    }
+    waitInternal(Millisecond(30));
+    mHoldsAfterBurst = invariant.holds();
+
+    // the check is done when the value of holds() is requested
+    mValue = 20;
+    mHoldsAfterViolation = invariant.holds();
+    mValue = 0;
+    waitInternal(Millisecond(10));
+  }
+
+  protest::Value<int>& mValue;
+  bool mHoldsAfterBurst;
+  bool mHoldsAfterViolation;
+};
+
+class WritingRunner : public RunnerRaw
+{
+public:
+  explicit WritingRunner(Context& context, protest::Value<int>& value) :
+    RunnerRaw(context, "writer"),
+    mValue(value)
+  {
+  }
+
+  void
+  process() override
+  {
+    waitInternal(Millisecond(10));
+    mValue = 20;
+    coroYield();
+    mValue = 5;
+  }
+
+  protest::Value<int>& mValue;
+};
+
+size_t
+countViolations(const std::string& output)
+{
+  size_t count = 0;
+  size_t position = output.find("Invariant does not hold");
+  while (position != std::string::npos)
+  {
+    count++;
+    position = output.find("Invariant does not hold", position + 1);
+  }
+  return count;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(invariant, should_check_on_every_change_by_default)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  bool holdsAfterBurst = true;
+  {
+    Context context;
+    auto value = protest::Value(0);
+    OwningRunner owner(context, value);
+    context.run();
+    holdsAfterBurst = owner.mHoldsAfterBurst;
+  }
+
+  ASSERT_FALSE(holdsAfterBurst);
+  ASSERT_EQ(1u, countViolations(output.str()));
+}
+
+TEST(invariant, should_check_once_per_time_step_if_coalescing)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  bool holdsAfterBurst = false;
+  bool holdsAfterViolation = true;
+  {
+    Context context;
+    context.setInvariantCoalescing(true);
+    auto value = protest::Value(0);
+    OwningRunner owner(context, value);
+    context.run();
+    holdsAfterBurst = owner.mHoldsAfterBurst;
+    holdsAfterViolation = owner.mHoldsAfterViolation;
+  }
+
+  ASSERT_TRUE(holdsAfterBurst);
+  ASSERT_FALSE(holdsAfterViolation);
+  ASSERT_EQ(1u, countViolations(output.str()));
+}
+
+TEST(invariant, should_check_changes_of_other_runners_in_same_time_step)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  bool holdsAfterBurst = true;
+  {
+    Context context;
+    context.setInvariantCoalescing(true);
+    auto value = protest::Value(0);
+    OwningRunner owner(context, value);
+    WritingRunner writer(context, value);
+    context.run();
+    holdsAfterBurst = owner.mHoldsAfterBurst;
+  }
+
+  // the writer yields while the value is violated, the owner checks it
+  // before the writer continues
+  ASSERT_FALSE(holdsAfterBurst);
+  ASSERT_EQ(1u, countViolations(output.str()));
+  ASSERT_NE(std::string::npos, output.str().find("INV  0000000010  owner"));
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+
+#include <array>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForPort(meta::CallContext::defaultContext().getUnit(),
+                              0,
+                              "mPort",
+                              {"mPort.size() > 0"});
+
+size_t globalCopies = 0u;
+size_t globalAlive = 0u;
+
+struct Frame
+{
+  Frame()
+  {
+    globalAlive++;
+  }
+
+  Frame(const Frame& other) : mData(other.mData)
+  {
+    globalCopies++;
+    globalAlive++;
+  }
+
+  Frame&
+  operator=(const Frame& other) = delete;
+
+  ~Frame()
+  {
+    globalAlive--;
+  }
+
+  std::array<char, 1024> mData = {};
+};
+
+class Subscriber : public Runner
+{
+public:
+  explicit Subscriber(Context& context,
+                      Signal<Payload<Frame>>& signal,
+                      int64_t delay) :
+    Runner(context, "sub"),
+    mSignal(signal),
+    mDelay(delay)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+  }
+
+  void
+  process() override
+  {
+    wait(mPort.size() > 0, waitForPort);
+    wait(Millisecond(mDelay));
+    mFirst = mPort.pop()->mData[0];
+    mAliveAfterPop = globalAlive;
+  }
+
+  Signal<Payload<Frame>>& mSignal;
+  int64_t mDelay;
+  QueuePort<Payload<Frame>> mPort;
+  char mFirst = 0;
+  size_t mAliveAfterPop = 0u;
+};
+
+class Publisher : public Runner
+{
+public:
+  explicit Publisher(Context& context, Signal<Payload<Frame>>& signal) :
+    Runner(context, "pub"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(10));
+    Payload<Frame> payload(createFrame());
+    mSignal.push(payload);
+  }
+
+  static Frame
+  createFrame()
+  {
+    Frame frame;
+    frame.mData[0] = 'x';
+    return frame;
+  }
+
+  Signal<Payload<Frame>>& mSignal;
+};
+
+} // namespace
+
+TEST(payload, should_share_the_value_between_copies)
+{
+  globalAlive = 0u;
+  {
+    Payload<Frame> empty;
+    ASSERT_TRUE(empty.isEmpty());
+
+    Payload<Frame> first{Frame()};
+    Payload<Frame> second = first;
+    empty = second;
+    ASSERT_EQ(&first.get(), &second.get());
+    ASSERT_EQ(&first.get(), &*empty);
+    ASSERT_EQ(1u, globalAlive);
+
+    Payload<Frame> moved = std::move(first);
+    ASSERT_TRUE(first.isEmpty());
+    ASSERT_EQ(1u, globalAlive);
+  }
+  ASSERT_EQ(0u, globalAlive);
+}
+
+TEST(payload, should_count_the_handles_of_several_threads)
+{
+  constexpr size_t numberOfCopies = 100000u;
+  globalAlive = 0u;
+  {
+    Payload<Frame> payload{Frame()};
+    auto copy = [&payload]() {
+      for (size_t i = 0; i < numberOfCopies; i++)
+      {
+        Payload<Frame> handle = payload;
+        ASSERT_FALSE(handle.isEmpty());
+      }
+    };
+    std::thread first(copy);
+    std::thread second(copy);
+    first.join();
+    second.join();
+    ASSERT_EQ(1u, globalAlive);
+  }
+  ASSERT_EQ(0u, globalAlive);
+}
+
+TEST(payload, should_release_the_value_after_the_last_pop)
+{
+  constexpr int64_t numberOfSubscribers = 3;
+  globalCopies = 0u;
+  globalAlive = 0u;
+
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  std::vector<size_t> aliveAfterPop;
+  {
+    Context context;
+    Signal<Payload<Frame>> signal(context);
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for (int64_t i = 0; i < numberOfSubscribers; i++)
+    {
+      subscribers.emplace_back(new Subscriber(context, signal, 10 * i));
+    }
+    Publisher publisher(context, signal);
+    ASSERT_EQ(0, context.run());
+    for (auto& subscriber : subscribers)
+    {
+      ASSERT_EQ('x', subscriber->mFirst);
+      aliveAfterPop.push_back(subscriber->mAliveAfterPop);
+    }
+  }
+
+  // copied once into the payload, not once per port
+  ASSERT_LE(globalCopies, 1u);
+  ASSERT_EQ((std::vector<size_t>{1u, 1u, 0u}), aliveAfterPop);
+  ASSERT_EQ(0u, globalAlive);
+}
@@ -0,0 +1,432 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForPort(meta::CallContext::defaultContext().getUnit(),
+                              0,
+                              "mPort",
+                              {"mPort.size() > 0"});
+
+constexpr size_t capacity = 4u;
+constexpr int numberOfValues = 10;
+
+class Consumer : public Runner
+{
+public:
+  explicit Consumer(Context& context,
+                    Signal<int>& signal,
+                    QueueOptions options,
+                    size_t expected) :
+    Runner(context, "cons"),
+    mSignal(signal),
+    mOptions(options),
+    mExpected(expected)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, mOptions);
+  }
+
+  void
+  process() override
+  {
+    // let the producer fill the queue first
+    wait(Millisecond(10));
+    while (mValues.size() < mExpected)
+    {
+      wait(mPort.size() > 0, waitForPort);
+      mValues.push_back(mPort.pop());
+      wait(Millisecond(1));
+    }
+  }
+
+  Signal<int>& mSignal;
+  QueueOptions mOptions;
+  size_t mExpected;
+  QueuePort<int> mPort;
+  std::vector<int> mValues;
+};
+
+class Producer : public Runner
+{
+public:
+  explicit Producer(Context& context, Signal<int>& signal) :
+    Runner(context, "prod"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(1));
+    for (int i = 1; i <= numberOfValues; i++)
+    {
+      mSignal.push(i);
+    }
+    mDone = true;
+  }
+
+  Signal<int>& mSignal;
+  bool mDone = false;
+};
+
+class BatchConsumer : public Runner
+{
+public:
+  explicit BatchConsumer(Context& context, Signal<int>& signal) :
+    Runner(context, "cons"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, QueueOptions(QueueOptions::unbounded));
+  }
+
+  void
+  process() override
+  {
+    wait(mPort.size() > 0, waitForPort);
+    // the whole batch arrived before this runner was resumed
+    mValues = mPort.popAll();
+    wait(mPort.size() > 0, waitForPort);
+    mDrained = mPort.drain([this](int value) { mSum += value; });
+  }
+
+  Signal<int>& mSignal;
+  QueuePort<int> mPort;
+  std::vector<int> mValues;
+  size_t mDrained = 0u;
+  int mSum = 0;
+};
+
+class BatchProducer : public Runner
+{
+public:
+  explicit BatchProducer(Context& context, Signal<int>& signal) :
+    Runner(context, "prod"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    std::vector<int> values;
+    for (int i = 1; i <= numberOfValues; i++)
+    {
+      values.push_back(i);
+    }
+    wait(Millisecond(1));
+    mSignal.pushBatch(values.data(), values.size());
+    wait(Millisecond(1));
+    mSignal.pushBatch(values.data(), values.size());
+  }
+
+  Signal<int>& mSignal;
+};
+
+class Popper : public Runner
+{
+public:
+  explicit Popper(Context& context, Signal<int>& signal, QueueOptions options) :
+    Runner(context, "pop"),
+    mSignal(signal),
+    mOptions(options)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, mOptions);
+  }
+
+  void
+  process() override
+  {
+    mSignal.push(1);
+    mSignal.push(2);
+    auto empty = mPort.size() == 0u;
+    auto available = mPort.isAvailable() == true;
+    core::ExprCondition<decltype(empty)> emptyCondition(nullptr,
+                                                        empty,
+                                                        nullptr);
+    core::ExprCondition<decltype(available)> availableCondition(nullptr,
+                                                                available,
+                                                                nullptr);
+    emptyCondition.enable();
+    availableCondition.enable();
+    mEmptyBefore = emptyCondition.isFulfilled();
+    mPort.pop();
+    mPort.pop();
+    mEmptyAfterPop = emptyCondition.isFulfilled();
+    mAvailableAfterPop = availableCondition.isFulfilled();
+    mSignal.push(3);
+    mPort.clear();
+    mEmptyAfterClear = emptyCondition.isFulfilled();
+    mSignal.push(4);
+    mPort.popAll();
+    mEmptyAfterDrain = emptyCondition.isFulfilled();
+    emptyCondition.disable();
+    availableCondition.disable();
+  }
+
+  Signal<int>& mSignal;
+  QueueOptions mOptions;
+  QueuePort<int> mPort;
+  bool mEmptyBefore = true;
+  bool mEmptyAfterPop = false;
+  bool mAvailableAfterPop = true;
+  bool mEmptyAfterClear = false;
+  bool mEmptyAfterDrain = false;
+};
+
+class SlowSink : public Runner
+{
+public:
+  explicit SlowSink(Context& context,
+                    Signal<int>& signal,
+                    size_t capacity,
+                    SignalFilter<int>* filter,
+                    Duration delay,
+                    size_t expected) :
+    Runner(context, "sink"),
+    mSignal(signal),
+    mCapacity(capacity),
+    mFilter(filter),
+    mDelay(delay),
+    mExpected(expected)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, QueueOptions(mCapacity, Overflow::block));
+    if (mFilter != nullptr)
+    {
+      mPort.attachFilter(mFilter);
+    }
+    else
+    {
+    }
+  }
+
+  void
+  process() override
+  {
+    wait(mDelay);
+    while (mValues.size() < mExpected)
+    {
+      wait(mPort.size() > 0, waitForPort);
+      mValues.push_back(mPort.pop());
+    }
+  }
+
+  Signal<int>& mSignal;
+  size_t mCapacity;
+  SignalFilter<int>* mFilter;
+  Duration mDelay;
+  size_t mExpected;
+  QueuePort<int> mPort;
+  std::vector<int> mValues;
+};
+
+class BatchedPusher : public Runner
+{
+public:
+  explicit BatchedPusher(Context& context, Signal<int>& signal) :
+    Runner(context, "bat"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    mSignal.push(10, Signal<int>::Delivery::batched);
+    wait(Millisecond(1));
+    mSignal.push(11, Signal<int>::Delivery::batched);
+  }
+
+  Signal<int>& mSignal;
+};
+
+class LatePusher : public Runner
+{
+public:
+  explicit LatePusher(Context& context, Signal<int>& signal) :
+    Runner(context, "late"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(2));
+    mSignal.push(1);
+  }
+
+  Signal<int>& mSignal;
+};
+
+struct Result
+{
+  std::vector<int> mValues;
+  std::vector<Context::QueueOverflow> mOverflows;
+  std::string mLog;
+};
+
+Result
+transfer(QueueOptions options, size_t expected)
+{
+  Result result;
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    Consumer consumer(context, signal, options, expected);
+    Producer producer(context, signal);
+    EXPECT_EQ(0, context.run());
+    EXPECT_TRUE(producer.mDone);
+    result.mValues = consumer.mValues;
+    result.mOverflows = context.getQueueOverflows();
+  }
+  result.mLog = output.str();
+  return result;
+}
+
+} // namespace
+
+TEST(queue_port, should_drop_the_newest_values)
+{
+  const auto result =
+      transfer(QueueOptions(capacity, Overflow::dropNewest), capacity);
+
+  ASSERT_EQ((std::vector<int> {1, 2, 3, 4}), result.mValues);
+  ASSERT_EQ(1u, result.mOverflows.size());
+  ASSERT_EQ(6u, result.mOverflows[0].mDropped);
+  ASSERT_EQ(0u, result.mOverflows[0].mBlocked);
+  ASSERT_NE(std::string::npos, result.mLog.find("QUEUE OVERFLOWS"));
+}
+
+TEST(queue_port, should_drop_the_oldest_values)
+{
+  const auto result =
+      transfer(QueueOptions(capacity, Overflow::dropOldest), capacity);
+
+  ASSERT_EQ((std::vector<int> {7, 8, 9, 10}), result.mValues);
+  ASSERT_EQ(1u, result.mOverflows.size());
+  ASSERT_EQ(6u, result.mOverflows[0].mDropped);
+}
+
+TEST(queue_port, should_block_the_pushing_runner)
+{
+  const auto result =
+      transfer(QueueOptions(capacity, Overflow::block), numberOfValues);
+
+  ASSERT_EQ((std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}),
+            result.mValues);
+  ASSERT_EQ(1u, result.mOverflows.size());
+  ASSERT_EQ(0u, result.mOverflows[0].mDropped);
+  ASSERT_EQ(6u, result.mOverflows[0].mBlocked);
+}
+
+TEST(queue_port, should_grow_if_unbounded)
+{
+  const auto result =
+      transfer(QueueOptions(QueueOptions::unbounded), numberOfValues);
+
+  ASSERT_EQ(static_cast<size_t>(numberOfValues), result.mValues.size());
+  ASSERT_TRUE(result.mOverflows.empty());
+  ASSERT_EQ(std::string::npos, result.mLog.find("QUEUE OVERFLOWS"));
+}
+
+TEST(queue_port, should_push_and_pop_batches_as_a_unit)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    BatchConsumer consumer(context, signal);
+    BatchProducer producer(context, signal);
+    EXPECT_EQ(0, context.run());
+
+    ASSERT_EQ((std::vector<int> {1, 2, 3, 4, 5, 6, 7, 8, 9, 10}),
+              consumer.mValues);
+    ASSERT_EQ(static_cast<size_t>(numberOfValues), consumer.mDrained);
+    ASSERT_EQ(55, consumer.mSum);
+  }
+  ASSERT_NE(std::string::npos, output.str().find("Push 10 values"));
+}
+
+TEST(queue_port, should_update_conditions_on_every_size_change)
+{
+  for (const auto overflow : {Overflow::dropNewest,
+                              Overflow::dropOldest,
+                              Overflow::block})
+  {
+    std::ostringstream output;
+    log::OutputScope outputScope(output);
+    {
+      Context context;
+      Signal<int> signal(context);
+      Popper popper(context, signal, QueueOptions(capacity, overflow));
+      EXPECT_EQ(0, context.run());
+
+      ASSERT_FALSE(popper.mEmptyBefore);
+      ASSERT_TRUE(popper.mEmptyAfterPop);
+      ASSERT_FALSE(popper.mAvailableAfterPop);
+      ASSERT_TRUE(popper.mEmptyAfterClear);
+      ASSERT_TRUE(popper.mEmptyAfterDrain);
+    }
+  }
+}
+
+TEST(queue_port, should_not_lose_values_of_a_batched_push_to_blocking_ports)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    auto* large = signal.addFilter([](const int& value) { return value > 9; });
+    // the first port is filled up again while the push of 11 waits for the
+    // second one
+    SlowSink first(context, signal, 2u, nullptr, Millisecond(10), 3u);
+    SlowSink second(context, signal, 1u, large, Millisecond(5), 2u);
+    BatchedPusher pusher(context, signal);
+    LatePusher latePusher(context, signal);
+    EXPECT_EQ(0, context.run());
+
+    auto values = first.mValues;
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ((std::vector<int> {1, 10, 11}), values);
+    ASSERT_EQ((std::vector<int> {10, 11}), second.mValues);
+    for (const auto& overflow : context.getQueueOverflows())
+    {
+      ASSERT_EQ(0u, overflow.mDropped);
+    }
+  }
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForPort(meta::CallContext::defaultContext().getUnit(),
+                              0,
+                              "mPort",
+                              {"mPort.size() > 0"});
+
+class Pinger : public Runner
+{
+public:
+  explicit Pinger(RunnerGroup& group,
+                  Signal<int>& signal,
+                  Link<int>& link) :
+    Runner(group, "ping"),
+    mSignal(signal),
+    mLink(link)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      mLink.push(i);
+      wait(mPort.size() > 0, waitForPort);
+      mReceived.push_back(mPort.pop());
+      mReceivedAt.push_back(now().milliseconds());
+    }
+  }
+
+  Signal<int>& mSignal;
+  Link<int>& mLink;
+  QueuePort<int> mPort;
+  std::vector<int> mReceived;
+  std::vector<int64_t> mReceivedAt;
+};
+
+class Ponger : public Runner
+{
+public:
+  explicit Ponger(RunnerGroup& group,
+                  Signal<int>& signal,
+                  Link<int>& link) :
+    Runner(group, "pong"),
+    mSignal(signal),
+    mLink(link)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      wait(mPort.size() > 0, waitForPort);
+      const int value = mPort.pop();
+      // the answer is sent after some local work
+      wait(Millisecond(3));
+      mLink.push(value + 100);
+    }
+  }
+
+  Signal<int>& mSignal;
+  Link<int>& mLink;
+  QueuePort<int> mPort;
+};
+
+std::string
+runPingPong(std::vector<int>* received, std::vector<int64_t>* receivedAt)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    RunnerGroup groupA(context);
+    RunnerGroup groupB(context);
+    Signal<int> toA(context);
+    Signal<int> toB(context);
+    Link<int> linkToA(groupA, toA, Millisecond(10));
+    Link<int> linkToB(groupB, toB, Millisecond(10));
+    Pinger pinger(groupA, toA, linkToB);
+    Ponger ponger(groupB, toB, linkToA);
+
+    EXPECT_EQ(Millisecond(10), context.getLookahead());
+    EXPECT_EQ(0, context.run());
+    *received = pinger.mReceived;
+    *receivedAt = pinger.mReceivedAt;
+  }
+  return output.str();
+}
+
+class Sleeper : public Runner
+{
+public:
+  explicit Sleeper(RunnerGroup& group, Duration duration) :
+    Runner(group, "main"),
+    mDuration(duration)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      wait(mDuration);
+    }
+    mEnd = now().milliseconds();
+  }
+
+  Duration mDuration;
+  int64_t mEnd = 0;
+};
+
+} // namespace
+
+TEST(runner_group, should_deliver_links_after_latency)
+{
+  std::vector<int> received;
+  std::vector<int64_t> receivedAt;
+  runPingPong(&received, &receivedAt);
+
+  ASSERT_EQ((std::vector<int> {100, 101, 102, 103, 104}), received);
+  ASSERT_EQ((std::vector<int64_t> {23, 46, 69, 92, 115}), receivedAt);
+}
+
+TEST(runner_group, should_write_same_output_on_every_run)
+{
+  std::vector<int> received;
+  std::vector<int64_t> receivedAt;
+  const std::string first = runPingPong(&received, &receivedAt);
+  const std::string second = runPingPong(&received, &receivedAt);
+
+  ASSERT_NE(std::string::npos, first.find("Start runner 'ping'"));
+  ASSERT_NE(std::string::npos, first.find("Start runner 'pong'"));
+  ASSERT_EQ(first, second);
+}
+
+TEST(runner_group, should_run_groups_without_links_independently)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    RunnerGroup groupA(context);
+    RunnerGroup groupB(context);
+    Sleeper fast(groupA, Millisecond(10));
+    Sleeper slow(groupB, Seconds(1));
+
+    ASSERT_EQ(Duration::infinity(), context.getLookahead());
+    ASSERT_EQ(0, context.run());
+    ASSERT_EQ(30, fast.mEnd);
+    ASSERT_EQ(3000, slow.mEnd);
+  }
+}
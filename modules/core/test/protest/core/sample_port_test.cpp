@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+
+#include <sstream>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForMax(meta::CallContext::defaultContext().getUnit(),
+                             0,
+                             "mWindow",
+                             {"mWindow.max() > 6"});
+
+meta::CallContext waitForEmpty(meta::CallContext::defaultContext().getUnit(),
+                               0,
+                               "mWindow",
+                               {"mWindow.count() == 0u"});
+
+class Monitor : public Runner
+{
+public:
+  explicit Monitor(Context& context, Signal<int>& signal) :
+    Runner(context, "mon"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mLast = createPort(mSignal);
+    mLast.setHistory(3u);
+    mWindow = createPort(mSignal);
+    mWindow.setHistory(100u, Millisecond(50));
+  }
+
+  void
+  process() override
+  {
+    wait(mWindow.max() > 6, waitForMax);
+    mMaxAt = elapsed();
+    // no new samples, the window empties when the samples expire
+    wait(mWindow.count() == 0u, waitForEmpty);
+    mEmptyAt = elapsed();
+  }
+
+  uint64_t
+  elapsed()
+  {
+    return (now() - TimePoint::startOfEpoche()).milliseconds();
+  }
+
+  Signal<int>& mSignal;
+  SamplePort<int> mLast;
+  SamplePort<int> mWindow;
+  uint64_t mMaxAt = 0u;
+  uint64_t mEmptyAt = 0u;
+};
+
+class Sensor : public Runner
+{
+public:
+  explicit Sensor(Context& context, Signal<int>& signal) :
+    Runner(context, "sens"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (int value : {5, 1, 9, 4})
+    {
+      wait(Millisecond(10));
+      mSignal.push(value);
+    }
+  }
+
+  Signal<int>& mSignal;
+};
+
+struct Position
+{
+  int mX;
+  int mY;
+};
+
+log::UniversalStream&
+toStringCustom(log::UniversalStream& stream, const Position& position)
+{
+  stream.getPlain() << position.mX << "/" << position.mY;
+  return stream;
+}
+
+class Tracker : public Runner
+{
+public:
+  explicit Tracker(Context& context, Signal<Position>& signal) :
+    Runner(context, "trck"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPosition = createPort(mSignal);
+  }
+
+  void
+  process() override
+  {
+    mSignal.push(Position {3, 4});
+    mLast = mPosition;
+  }
+
+  Signal<Position>& mSignal;
+  SamplePort<Position> mPosition;
+  Position mLast = {0, 0};
+};
+
+} // namespace
+
+TEST(sample_port, should_aggregate_the_history)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    Monitor monitor(context, signal);
+    Sensor sensor(context, signal);
+    EXPECT_EQ(0, context.run());
+
+    // the last three samples
+    ASSERT_EQ(3u, static_cast<size_t>(monitor.mLast.count()));
+    ASSERT_EQ(14, static_cast<int64_t>(monitor.mLast.sum()));
+    ASSERT_EQ(1, static_cast<int>(monitor.mLast.min()));
+    ASSERT_EQ(9, static_cast<int>(monitor.mLast.max()));
+    ASSERT_DOUBLE_EQ(14.0 / 3.0, static_cast<double>(monitor.mLast.mean()));
+
+    // 9 arrives at 30 ms, the last sample (40 ms) expires at 90 ms
+    ASSERT_EQ(30u, monitor.mMaxAt);
+    ASSERT_EQ(90u, monitor.mEmptyAt);
+    ASSERT_EQ(0, static_cast<int>(monitor.mWindow.max()));
+  }
+}
+
+TEST(sample_port, should_sample_values_without_history)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<Position> signal(context);
+    Tracker tracker(context, signal);
+    EXPECT_EQ(0, context.run());
+    ASSERT_EQ(3, tracker.mLast.mX);
+    ASSERT_EQ(4, tracker.mLast.mY);
+  }
+}
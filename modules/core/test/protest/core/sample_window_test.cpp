@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/sample_window.h"
+
+#include <vector>
+
+using namespace protest::core;
+using namespace protest::time;
+
+namespace
+{
+
+TimePoint
+at(int64_t milliseconds)
+{
+  return TimePoint() + Millisecond(milliseconds);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(sample_window, should_track_min_and_max_of_the_last_samples)
+{
+  SampleWindow<int> window(3, Duration::infinity());
+  const std::vector<int> values {5, 3, 4, 1, 2, 6, 0, 7, 1, 2, 3};
+  // min and max of the last three values after every push
+  const std::vector<int> mins {5, 3, 3, 1, 1, 1, 0, 0, 0, 1, 1};
+  const std::vector<int> maxs {5, 5, 5, 4, 4, 6, 6, 7, 7, 7, 3};
+  for (size_t i = 0; i < values.size(); i++)
+  {
+    window.push(at(0), values[i]);
+    ASSERT_EQ(mins[i], window.min()) << "after push " << i;
+    ASSERT_EQ(maxs[i], window.max()) << "after push " << i;
+  }
+  ASSERT_EQ(3u, window.count());
+  ASSERT_EQ(6, window.sum());
+  ASSERT_DOUBLE_EQ(2.0, window.mean());
+}
+
+TEST(sample_window, should_keep_the_newest_of_equal_values)
+{
+  SampleWindow<int> window(2, Duration::infinity());
+  window.push(at(0), 5);
+  window.push(at(0), 5);
+  ASSERT_EQ(5, window.min());
+  ASSERT_EQ(5, window.max());
+
+  window.push(at(0), 9);
+  ASSERT_EQ(5, window.min());
+  ASSERT_EQ(9, window.max());
+
+  // the older 9 is evicted, the newer one is still the maximum
+  window.push(at(0), 9);
+  window.push(at(0), 1);
+  ASSERT_EQ(1, window.min());
+  ASSERT_EQ(9, window.max());
+
+  window.push(at(0), 1);
+  ASSERT_EQ(1, window.min());
+  ASSERT_EQ(1, window.max());
+}
+
+TEST(sample_window, should_evict_by_capacity)
+{
+  SampleWindow<unsigned> window(2, Duration::infinity());
+  window.push(at(0), 1u);
+  window.push(at(10), 2u);
+  window.push(at(20), 3u);
+  ASSERT_EQ(2u, window.count());
+  ASSERT_EQ(5u, window.sum());
+  ASSERT_EQ(2u, window.min());
+  ASSERT_FALSE(window.expire(at(1000)));
+  ASSERT_EQ(TimePoint::endOfEpoche(), window.nextExpiry());
+}
+
+TEST(sample_window, should_evict_by_time)
+{
+  SampleWindow<int> window(10, Millisecond(10));
+  window.push(at(0), -4);
+  window.push(at(5), 2);
+  ASSERT_EQ(at(10), window.nextExpiry());
+
+  // pushing expires the samples which are too old
+  window.push(at(12), 8);
+  ASSERT_EQ(2u, window.count());
+  ASSERT_EQ(2, window.min());
+  ASSERT_EQ(at(15), window.nextExpiry());
+
+  ASSERT_FALSE(window.expire(at(14)));
+  ASSERT_TRUE(window.expire(at(15)));
+  ASSERT_EQ(1u, window.count());
+  ASSERT_EQ(8, window.sum());
+
+  ASSERT_TRUE(window.expire(at(22)));
+  ASSERT_EQ(0u, window.count());
+  ASSERT_EQ(0, window.sum());
+  ASSERT_EQ(0, window.min());
+  ASSERT_EQ(0, window.max());
+  ASSERT_DOUBLE_EQ(0.0, window.mean());
+  ASSERT_EQ(TimePoint::endOfEpoche(), window.nextExpiry());
+}
+
+TEST(sample_window, should_not_accumulate_rounding_errors)
+{
+  SampleWindow<double> window(2, Millisecond(10));
+  window.push(at(0), 0.1);
+  window.push(at(1), 0.2);
+  window.push(at(2), 0.7);
+  ASSERT_TRUE(window.expire(at(20)));
+  ASSERT_EQ(0.0, window.sum());
+
+  // 1 is below the precision of 1e16, the sum is recomputed
+  window.push(at(30), 1e16);
+  window.push(at(30), 1.0);
+  window.push(at(30), 1.0);
+  window.push(at(30), 1.0);
+  ASSERT_EQ(2.0, window.sum());
+
+  for (int i = 0; i < 100000; i++)
+  {
+    window.push(at(30), 0.1);
+  }
+  ASSERT_EQ(0.2, window.sum());
+  ASSERT_DOUBLE_EQ(0.1, window.mean());
+}
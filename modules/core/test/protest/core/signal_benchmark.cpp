@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+#include "protest/coro/benchmark.h"
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+using protest::benchmark::report;
+
+namespace
+{
+
+constexpr size_t numberOfSubscribers = 50u;
+constexpr int numberOfPushes = 20000;
+
+class Subscriber : public Runner
+{
+public:
+  explicit Subscriber(Context& context, Signal<int>& signal) :
+    Runner(context, "sub"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+  }
+
+  void
+  process() override
+  {
+  }
+
+  Signal<int>& mSignal;
+  SamplePort<int> mPort;
+};
+
+class Publisher : public Runner
+{
+public:
+  explicit Publisher(Context& context, Signal<int>& signal) :
+    Runner(context, "pub"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(1));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numberOfPushes; i++)
+    {
+      mSignal.push(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    report(mSignal.getDelivery() == Signal<int>::Delivery::batched
+               ? "push to 50 ports (batched)"
+               : "push to 50 ports (interleaved)",
+           "pushes",
+           numberOfPushes,
+           end - start);
+  }
+
+  Signal<int>& mSignal;
+};
+
+constexpr int numberOfMessages = 100000;
+
+class Recorder : public Runner
+{
+public:
+  explicit Recorder(Context& context, Signal<int>& signal) :
+    Runner(context, "rec"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, QueueOptions(QueueOptions::unbounded));
+  }
+
+  void
+  process() override
+  {
+  }
+
+  Signal<int>& mSignal;
+  QueuePort<int> mPort;
+};
+
+class Replayer : public Runner
+{
+public:
+  explicit Replayer(Context& context, Signal<int>& signal, bool batch) :
+    Runner(context, "rep"),
+    mSignal(signal),
+    mBatch(batch)
+  {
+  }
+
+  void
+  process() override
+  {
+    std::vector<int> messages(numberOfMessages);
+    for (int i = 0; i < numberOfMessages; i++)
+    {
+      messages[i] = i;
+    }
+    wait(Millisecond(1));
+    auto start = std::chrono::steady_clock::now();
+    if (mBatch)
+    {
+      mSignal.pushBatch(messages.data(), messages.size());
+    }
+    else
+    {
+      for (int message : messages)
+      {
+        mSignal.push(message);
+      }
+    }
+    auto end = std::chrono::steady_clock::now();
+    report(mBatch ? "replay messages (pushBatch)" : "replay messages (push)",
+           "messages",
+           numberOfMessages,
+           end - start);
+  }
+
+  Signal<int>& mSignal;
+  bool mBatch;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(core_benchmark, push_to_50_subscribers)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  for (auto delivery :
+       {Signal<int>::Delivery::interleaved, Signal<int>::Delivery::batched})
+  {
+    Context context;
+    Signal<int> signal(context);
+    signal.setDelivery(delivery);
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for (size_t i = 0; i < numberOfSubscribers; i++)
+    {
+      subscribers.emplace_back(new Subscriber(context, signal));
+    }
+    Publisher publisher(context, signal);
+    ASSERT_EQ(0, context.run());
+    ASSERT_EQ(numberOfPushes - 1, static_cast<int>(subscribers[0]->mPort));
+    output.str("");
+  }
+}
+
+TEST(core_benchmark, replay_100k_messages)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  for (bool batch : {false, true})
+  {
+    Context context;
+    Signal<int> signal(context);
+    Recorder recorder(context, signal);
+    Replayer replayer(context, signal, batch);
+    ASSERT_EQ(0, context.run());
+    ASSERT_EQ(static_cast<size_t>(numberOfMessages),
+              recorder.mPort.drain([](int) {}));
+    output.str("");
+  }
+}
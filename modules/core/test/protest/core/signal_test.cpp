@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForPort(meta::CallContext::defaultContext().getUnit(),
+                              0,
+                              "mPort",
+                              {"mPort.size() > 0"});
+
+constexpr size_t numberOfSubscribers = 4u;
+
+using Ports = std::vector<QueuePort<int>*>;
+
+class Subscriber : public Runner
+{
+public:
+  explicit Subscriber(Context& context, Signal<int>& signal, Ports& ports) :
+    Runner(context, "sub"),
+    mSignal(signal),
+    mPorts(ports)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+    mPorts.push_back(&mPort);
+  }
+
+  void
+  process() override
+  {
+    wait(mPort.size() > 0, waitForPort);
+    // number of ports which got the value when this subscriber runs
+    for (auto* port : mPorts)
+    {
+      mDelivered += port->size();
+    }
+    mPort.pop();
+  }
+
+  Signal<int>& mSignal;
+  Ports& mPorts;
+  QueuePort<int> mPort;
+  size_t mDelivered = 0u;
+};
+
+class Publisher : public Runner
+{
+public:
+  explicit Publisher(Context& context,
+                     Signal<int>& signal,
+                     Signal<int>::Delivery delivery) :
+    Runner(context, "pub"),
+    mSignal(signal),
+    mDelivery(delivery)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(10));
+    mSignal.push(1, mDelivery);
+  }
+
+  Signal<int>& mSignal;
+  Signal<int>::Delivery mDelivery;
+};
+
+std::vector<size_t>
+deliver(Signal<int>::Delivery delivery)
+{
+  std::vector<size_t> delivered;
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    Ports ports;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    for (size_t i = 0; i < numberOfSubscribers; i++)
+    {
+      subscribers.emplace_back(new Subscriber(context, signal, ports));
+    }
+    Publisher publisher(context, signal, delivery);
+    EXPECT_EQ(0, context.run());
+    for (auto& subscriber : subscribers)
+    {
+      delivered.push_back(subscriber->mDelivered);
+    }
+  }
+  return delivered;
+}
+
+class Receiver : public Runner
+{
+public:
+  explicit Receiver(Context& context,
+                    Signal<int>& signal,
+                    SignalFilter<int>* filter) :
+    Runner(context, "recv"),
+    mSignal(signal),
+    mFilter(filter)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, QueueOptions(QueueOptions::unbounded));
+    if (mFilter != nullptr)
+    {
+      mPort.attachFilter(mFilter);
+    }
+    else
+    {
+    }
+    // the second filter is not evaluated for values the first rejects
+    mPort.addFilter([](int& value) { return value < 3; });
+    mPort.addFilter([this](int&) {
+      mEvaluations++;
+      return true;
+    });
+  }
+
+  void
+  process() override
+  {
+  }
+
+  Signal<int>& mSignal;
+  SignalFilter<int>* mFilter;
+  QueuePort<int> mPort;
+  size_t mEvaluations = 0u;
+};
+
+class Sender : public Runner
+{
+public:
+  explicit Sender(Context& context, Signal<int>& signal) :
+    Runner(context, "send"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    wait(Millisecond(1));
+    for (int i = 0; i < 4; i++)
+    {
+      mSignal.push(i);
+    }
+  }
+
+  Signal<int>& mSignal;
+};
+
+class BatchSender : public Runner
+{
+public:
+  explicit BatchSender(Context& context, Signal<int>& signal) :
+    Runner(context, "send"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  process() override
+  {
+    const int values[] = {1, 2, 3};
+    wait(Millisecond(1));
+    mSignal.pushBatch(values, 3u);
+    mDone = true;
+  }
+
+  Signal<int>& mSignal;
+  bool mDone = false;
+};
+
+class BatchReceiver : public Runner
+{
+public:
+  explicit BatchReceiver(Context& context,
+                         Signal<int>& signal,
+                         SignalFilter<int>* filter,
+                         const BatchSender& sender) :
+    Runner(context, "recv"),
+    mSignal(signal),
+    mFilter(filter),
+    mSender(sender)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, QueueOptions(QueueOptions::unbounded));
+    mPort.attachFilter(mFilter);
+  }
+
+  void
+  process() override
+  {
+    wait(mPort.size() > 0, waitForPort);
+    mSenderDone = mSender.mDone;
+  }
+
+  Signal<int>& mSignal;
+  SignalFilter<int>* mFilter;
+  const BatchSender& mSender;
+  QueuePort<int> mPort;
+  bool mSenderDone = false;
+};
+
+} // namespace
+
+TEST(signal, should_interleave_the_delivery_by_default)
+{
+  const auto delivered = deliver(Signal<int>::Delivery::interleaved);
+  // every subscriber runs before the value is inserted into the next port
+  ASSERT_EQ((std::vector<size_t>{1u, 1u, 1u, 1u}), delivered);
+}
+
+TEST(signal, should_deliver_to_all_ports_before_yielding_if_batched)
+{
+  const auto delivered = deliver(Signal<int>::Delivery::batched);
+  // the first subscriber sees the value in all ports
+  ASSERT_EQ((std::vector<size_t>{4u, 3u, 2u, 1u}), delivered);
+}
+
+TEST(signal, should_test_signal_filters_once_per_value)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    size_t evaluations = 0u;
+    auto* even = signal.addFilter([&](const int& value) {
+      evaluations++;
+      return value % 2 == 0;
+    });
+    Receiver first(context, signal, even);
+    Receiver second(context, signal, even);
+    Receiver all(context, signal, nullptr);
+    Sender sender(context, signal);
+    EXPECT_EQ(0, context.run());
+
+    ASSERT_EQ(4u, evaluations);
+    ASSERT_EQ((std::vector<int> {0, 2}), first.mPort.popAll());
+    ASSERT_EQ((std::vector<int> {0, 2}), second.mPort.popAll());
+    ASSERT_EQ((std::vector<int> {0, 1, 2}), all.mPort.popAll());
+    // short-circuit: only the values below 3 reach the second port filter
+    ASSERT_EQ(2u, first.mEvaluations);
+    ASSERT_EQ(3u, all.mEvaluations);
+  }
+}
+
+TEST(signal, should_not_yield_to_ports_rejecting_the_whole_batch)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    auto* small = signal.addFilter([](const int& value) { return value < 3; });
+    auto* large = signal.addFilter([](const int& value) { return value > 9; });
+    BatchSender sender(context, signal);
+    BatchReceiver receiver(context, signal, small, sender);
+    Receiver rejecting(context, signal, large);
+    EXPECT_EQ(0, context.run());
+
+    ASSERT_EQ((std::vector<int> {1, 2}), receiver.mPort.popAll());
+    ASSERT_TRUE(rejecting.mPort.popAll().empty());
+    // the port of the receiver is delivered last, no yield follows
+    ASSERT_TRUE(receiver.mSenderDone);
+  }
+}
@@ -0,0 +1,311 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/api.h"
+#include "protest/core/stackless_runner.h"
+#include "protest/coro/stack_allocator.h"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace protest;
+using namespace protest::time;
+
+namespace
+{
+
+// usually generated by the protest compiler
+meta::CallContext waitForPort(meta::CallContext::defaultContext().getUnit(),
+                              0,
+                              "mPort",
+                              {"mPort.size() > 0"});
+
+class Ticker : public Runner
+{
+public:
+  explicit Ticker(Context& context, std::string& trace) :
+    Runner(context, "tick"),
+    mTrace(trace)
+  {
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      waitInternal(Millisecond(10));
+      mTrace += "a" + std::to_string(now().milliseconds()) + " ";
+    }
+  }
+
+  std::string& mTrace;
+};
+
+class StacklessTicker : public core::StacklessRunner
+{
+public:
+  explicit StacklessTicker(Context& context, std::string& trace) :
+    core::StacklessRunner(context, "tock"),
+    mTrace(trace)
+  {
+  }
+
+  coro::Task<>
+  coProcess() override
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      co_await wait(Millisecond(15));
+      mTrace += "b" + std::to_string(now().milliseconds()) + " ";
+      co_await yield();
+    }
+  }
+
+  std::string& mTrace;
+};
+
+class Producer : public core::StacklessRunner
+{
+public:
+  explicit Producer(Context& context, Signal<int>& signal) :
+    core::StacklessRunner(context, "prod"),
+    mSignal(signal)
+  {
+  }
+
+  coro::Task<>
+  coProcess() override
+  {
+    for (int i = 1; i <= 3; i++)
+    {
+      co_await push(mSignal, i);
+      co_await sleep(Millisecond(5));
+    }
+  }
+
+  Signal<int>& mSignal;
+};
+
+class BatchProducer : public core::StacklessRunner
+{
+public:
+  explicit BatchProducer(Context& context, Signal<int>& signal) :
+    core::StacklessRunner(context, "prod"),
+    mSignal(signal)
+  {
+  }
+
+  coro::Task<>
+  coProcess() override
+  {
+    const int values[] = {1, 2, 3};
+    co_await pushBatch(mSignal, values, 3u);
+    mDoneAt = now().milliseconds();
+  }
+
+  Signal<int>& mSignal;
+  int64_t mDoneAt = -1;
+};
+
+class Consumer : public Runner
+{
+public:
+  explicit Consumer(Context& context,
+                    Signal<int>& signal,
+                    QueueOptions options = QueueOptions()) :
+    Runner(context, "cons"),
+    mSignal(signal),
+    mOptions(options)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal, mOptions);
+  }
+
+  void
+  process() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      wait(mPort.size() > 0, waitForPort);
+      mReceived.push_back(mPort.pop());
+      mReceivedAt.push_back(now().milliseconds());
+    }
+  }
+
+  Signal<int>& mSignal;
+  QueueOptions mOptions;
+  QueuePort<int> mPort;
+  std::vector<int> mReceived;
+  std::vector<int64_t> mReceivedAt;
+};
+
+class StacklessConsumer : public core::StacklessRunner
+{
+public:
+  explicit StacklessConsumer(Context& context, Signal<int>& signal) :
+    core::StacklessRunner(context, "cons"),
+    mSignal(signal)
+  {
+  }
+
+  void
+  initialize() override
+  {
+    mPort = createPort(mSignal);
+  }
+
+  coro::Task<>
+  coProcess() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      co_await wait(mPort.size() > 0, waitForPort);
+      mReceived.push_back(mPort.pop());
+      mReceivedAt.push_back(now().milliseconds());
+    }
+    mGotTimeout =
+        !co_await wait(mPort.size() > 0, Millisecond(20), waitForPort);
+  }
+
+  Signal<int>& mSignal;
+  QueuePort<int> mPort;
+  std::vector<int> mReceived;
+  std::vector<int64_t> mReceivedAt;
+  bool mGotTimeout = false;
+};
+
+class Counter : public core::StacklessRunner
+{
+public:
+  explicit Counter(Context& context, int& counter) :
+    core::StacklessRunner(context, "cnt"),
+    mCounter(counter)
+  {
+  }
+
+  coro::Task<>
+  coProcess() override
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      co_await sleep(Millisecond(1));
+      mCounter++;
+    }
+  }
+
+  int& mCounter;
+};
+
+} // namespace
+
+TEST(stackless_runner, should_share_the_clock_with_stackful_runners)
+{
+  for (const bool directSwitching : {true, false})
+  {
+    std::ostringstream output;
+    std::string trace;
+    log::OutputScope outputScope(output);
+    {
+      Context context;
+      context.setDirectSwitching(directSwitching);
+      Ticker ticker(context, trace);
+      StacklessTicker stacklessTicker(context, trace);
+      ASSERT_TRUE(stacklessTicker.isStackless());
+      ASSERT_EQ(0u, stacklessTicker.getStackSize());
+      ASSERT_EQ(0, context.run());
+    }
+    ASSERT_EQ("a10 b15 a20 b30 a30 ", trace);
+  }
+}
+
+TEST(stackless_runner, should_push_to_stackful_runners)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  std::vector<int> received;
+  std::vector<int64_t> receivedAt;
+  {
+    Context context;
+    Signal<int> signal(context);
+    Producer producer(context, signal);
+    Consumer consumer(context, signal);
+    ASSERT_EQ(0, context.run());
+    received = consumer.mReceived;
+    receivedAt = consumer.mReceivedAt;
+  }
+  ASSERT_EQ((std::vector<int> {1, 2, 3}), received);
+  ASSERT_EQ((std::vector<int64_t> {0, 5, 10}), receivedAt);
+  ASSERT_NE(std::string::npos, output.str().find("Push value to"));
+}
+
+TEST(stackless_runner, should_push_batches_in_chunks_to_blocking_ports)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  {
+    Context context;
+    Signal<int> signal(context);
+    BatchProducer producer(context, signal);
+    Consumer consumer(context, signal, QueueOptions(2u, Overflow::block));
+    ASSERT_EQ(0, context.run());
+    ASSERT_EQ((std::vector<int> {1, 2, 3}), consumer.mReceived);
+    ASSERT_EQ(0, producer.mDoneAt);
+    // the last value fits only after the consumer popped the first one
+    const auto overflows = context.getQueueOverflows();
+    ASSERT_EQ(1u, overflows.size());
+    ASSERT_EQ(1u, overflows[0].mBlocked);
+    ASSERT_EQ(0u, overflows[0].mDropped);
+  }
+  ASSERT_NE(std::string::npos, output.str().find("Push 3 values to"));
+}
+
+TEST(stackless_runner, should_wait_for_conditions)
+{
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  std::vector<int> received;
+  std::vector<int64_t> receivedAt;
+  bool gotTimeout = false;
+  {
+    Context context;
+    Signal<int> signal(context);
+    Producer producer(context, signal);
+    StacklessConsumer consumer(context, signal);
+    ASSERT_EQ(0, context.run());
+    received = consumer.mReceived;
+    receivedAt = consumer.mReceivedAt;
+    gotTimeout = consumer.mGotTimeout;
+  }
+  ASSERT_EQ((std::vector<int> {1, 2, 3}), received);
+  ASSERT_EQ((std::vector<int64_t> {0, 5, 10}), receivedAt);
+  ASSERT_TRUE(gotTimeout);
+  ASSERT_NE(std::string::npos,
+            output.str().find("Condition is not fulfilled (timeout after 20"));
+}
+
+TEST(stackless_runner, should_not_allocate_stacks)
+{
+  static constexpr int numberOfRunners = 10000;
+
+  std::ostringstream output;
+  log::OutputScope outputScope(output);
+  int counter = 0;
+  {
+    Context context;
+    const size_t mappedStacks = coro::StackAllocator::getNumberOfMappedStacks();
+    std::vector<std::unique_ptr<Counter>> runners;
+    for (int i = 0; i < numberOfRunners; i++)
+    {
+      runners.push_back(std::make_unique<Counter>(context, counter));
+    }
+    ASSERT_EQ(mappedStacks, coro::StackAllocator::getNumberOfMappedStacks());
+    ASSERT_EQ(0, context.run());
+  }
+  ASSERT_EQ(3 * numberOfRunners, counter);
+}
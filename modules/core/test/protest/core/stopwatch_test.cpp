@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/condition.h"
+#include "protest/core/context.h"
+#include "protest/core/runner_raw.h"
+#include "protest/core/stopwatch.h"
+#include "protest/core/value.h"
+#include "protest/log/logger.h"
+
+#include <sstream>
+#include <string>
+
+using namespace protest::core;
+using namespace protest::time;
+using protest::Value;
+
+namespace
+{
+
+// records the time at which the condition was notified and its value
+class RecordingListener : public Condition::Listener
+{
+public:
+  explicit RecordingListener(RunnerRaw* runner) : mRunner(runner)
+  {
+  }
+
+  void
+  notify() override
+  {
+    mRecord += std::to_string(mRunner->now().milliseconds()) + ":" +
+               (mCondition->isFulfilled() ? "1" : "0") + " ";
+  }
+
+  RunnerRaw* mRunner;
+  Condition* mCondition = nullptr;
+  std::string mRecord;
+};
+
+class StopwatchRunner : public RunnerRaw
+{
+public:
+  explicit StopwatchRunner(Context& context) : RunnerRaw(context, "sw")
+  {
+  }
+
+  void
+  process() override
+  {
+    Stopwatch stopwatch(this);
+    auto window = stopwatch >= Millisecond(10) && stopwatch < Millisecond(30);
+    auto exact = stopwatch == Millisecond(20) || stopwatch > Millisecond(40);
+
+    RecordingListener windowListener(this);
+    RecordingListener exactListener(this);
+    ExprCondition<decltype(window)> windowCondition(this,
+                                                    window,
+                                                    &windowListener);
+    ExprCondition<decltype(exact)> exactCondition(this,
+                                                  exact,
+                                                  &exactListener);
+    windowListener.mCondition = &windowCondition;
+    exactListener.mCondition = &exactCondition;
+    windowCondition.enable();
+    exactCondition.enable();
+
+    waitInternal(Millisecond(25));
+    // the pending deadlines move while the stopwatch is stopped
+    stopwatch.stop();
+    waitInternal(Millisecond(100));
+    stopwatch.start();
+    waitInternal(Millisecond(20));
+
+    exactCondition.disable();
+    windowCondition.disable();
+    mWindow = windowListener.mRecord;
+    mExact = exactListener.mRecord;
+  }
+
+  std::string mWindow;
+  std::string mExact;
+};
+
+class WritingRunner : public RunnerRaw
+{
+public:
+  WritingRunner(Context& context, Value<int>& value) :
+    RunnerRaw(context, "writer"),
+    mValue(value)
+  {
+  }
+
+  void
+  process() override
+  {
+    waitInternal(Millisecond(10));
+    mValue = 1;
+  }
+
+  Value<int>& mValue;
+};
+
+class MixedRunner : public RunnerRaw
+{
+public:
+  MixedRunner(Context& context, Value<int>& value) :
+    RunnerRaw(context, "mixed"),
+    mValue(value)
+  {
+  }
+
+  void
+  process() override
+  {
+    Stopwatch stopwatch(this);
+    auto expr = !(stopwatch < Millisecond(10)) || mValue == 0;
+
+    RecordingListener listener(this);
+    ExprCondition<decltype(expr)> condition(this, expr, &listener);
+    listener.mCondition = &condition;
+    condition.enable();
+    // caches the results like an invariant checked on creation
+    listener.notify();
+
+    waitInternal(Millisecond(20));
+
+    condition.disable();
+    mRecord = listener.mRecord;
+  }
+
+  Value<int>& mValue;
+  std::string mRecord;
+};
+
+} // namespace
+
+TEST(stopwatch, should_notify_all_operators_of_a_stopwatch)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  std::string window;
+  std::string exact;
+  {
+    Context context;
+    StopwatchRunner runner(context);
+    ASSERT_EQ(0, context.run());
+    window = runner.mWindow;
+    exact = runner.mExact;
+  }
+
+  ASSERT_EQ("10:1 130:0 ", window);
+  ASSERT_EQ("20:1 140:1 ", exact);
+}
+
+TEST(stopwatch, should_evaluate_operators_written_before_their_deadline_job)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  auto value = Value(0);
+  std::string record;
+  {
+    Context context;
+    // the writer runs first, so the value changes at 10 ms before the
+    // stopwatch operator is notified
+    WritingRunner writer(context, value);
+    MixedRunner runner(context, value);
+    ASSERT_EQ(0, context.run());
+    record = runner.mRecord;
+  }
+
+  ASSERT_EQ("0:1 10:1 10:1 ", record);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/context.h"
+#include "protest/core/runner_raw.h"
+#include "protest/core/timer.h"
+#include "protest/coro/benchmark.h"
+#include "protest/log/logger.h"
+#include "protest/meta/call_context.h"
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace protest::core;
+using namespace protest::time;
+using protest::benchmark::report;
+
+namespace
+{
+
+constexpr int64_t numberOfTimers = 10000;
+
+using Callback = void (*)();
+
+size_t globalExpirations = 0u;
+
+void
+expired()
+{
+  globalExpirations++;
+}
+
+// arms many retransmission-like timers, cancels most of them and waits for
+// the rest to expire
+class TimerRunner : public RunnerRaw
+{
+public:
+  explicit TimerRunner(Context& context) : RunnerRaw(context, "tmr")
+  {
+  }
+
+  void
+  process() override
+  {
+    std::vector<std::unique_ptr<Timer<Callback>>> timers;
+    timers.reserve(numberOfTimers);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < numberOfTimers; i++)
+    {
+      timers.emplace_back(new Timer<Callback>(
+          this,
+          &expired,
+          Millisecond((i * 7919) % numberOfTimers + 1),
+          protest::meta::CallContext::defaultContext()));
+    }
+    auto end = std::chrono::steady_clock::now();
+    report("arm timers", "timers", numberOfTimers, end - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < numberOfTimers; i++)
+    {
+      if (i % 10 != 0)
+      {
+        timers[i]->stop();
+      }
+      else
+      {
+      }
+    }
+    end = std::chrono::steady_clock::now();
+    report("cancel timers", "timers", numberOfTimers - numberOfTimers / 10,
+           end - start);
+
+    start = std::chrono::steady_clock::now();
+    waitInternal(Millisecond(numberOfTimers + 1));
+    end = std::chrono::steady_clock::now();
+    report("waitInternal with expiring timers", "timers", numberOfTimers / 10,
+           end - start);
+  }
+};
+
+constexpr int64_t numberOfPeriods = 200000;
+
+// 1 kHz control loop, either re-armed in the callback or periodic
+class ControlLoopRunner : public RunnerRaw
+{
+public:
+  explicit ControlLoopRunner(Context& context, bool periodic) :
+    RunnerRaw(context, "loop"),
+    mPeriodic(periodic)
+  {
+  }
+
+  void
+  process() override
+  {
+    auto start = std::chrono::steady_clock::now();
+    if (mPeriodic)
+    {
+      auto step = []()
+      {
+        globalExpirations++;
+      };
+      Timer<decltype(step)> timer(this,
+                                  step,
+                                  Period(Millisecond(1)),
+                                  protest::meta::CallContext::defaultContext());
+      waitInternal(Millisecond(numberOfPeriods) + Microseconds(500));
+      timer.stop();
+    }
+    else
+    {
+      auto step = [](auto& timer)
+      {
+        globalExpirations++;
+        timer.start(Millisecond(1));
+      };
+      Timer<decltype(step)> timer(this,
+                                  step,
+                                  Millisecond(1),
+                                  protest::meta::CallContext::defaultContext());
+      waitInternal(Millisecond(numberOfPeriods) + Microseconds(500));
+      timer.stop();
+    }
+    auto end = std::chrono::steady_clock::now();
+    report(mPeriodic ? "control loop (periodic)" : "control loop (re-armed)",
+           "periods",
+           numberOfPeriods,
+           end - start);
+  }
+
+private:
+  bool mPeriodic;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(core_benchmark, wait_with_10k_timers)
+{
+  globalExpirations = 0u;
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    TimerRunner runner(context);
+    ASSERT_EQ(0, context.run());
+  }
+
+  ASSERT_EQ(static_cast<size_t>(numberOfTimers / 10), globalExpirations);
+}
+
+TEST(core_benchmark, control_loop_at_1_khz)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  for (bool periodic : {false, true})
+  {
+    globalExpirations = 0u;
+    {
+      Context context;
+      ControlLoopRunner runner(context, periodic);
+      ASSERT_EQ(0, context.run());
+    }
+    ASSERT_EQ(static_cast<size_t>(numberOfPeriods), globalExpirations);
+    output.str("");
+  }
+}
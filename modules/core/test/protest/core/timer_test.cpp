@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/context.h"
+#include "protest/core/runner_raw.h"
+#include "protest/core/timer.h"
+#include "protest/log/logger.h"
+#include "protest/meta/call_context.h"
+
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace protest::core;
+using namespace protest::time;
+
+namespace
+{
+
+using Callback = void (*)();
+
+size_t globalExpirations = 0u;
+
+void
+expired()
+{
+  globalExpirations++;
+}
+
+class ManyTimersRunner : public RunnerRaw
+{
+public:
+  explicit ManyTimersRunner(Context& context, int64_t numberOfTimers) :
+    RunnerRaw(context, "tmr"),
+    mNumberOfTimers(numberOfTimers)
+  {
+  }
+
+  void
+  process() override
+  {
+    std::vector<std::unique_ptr<Timer<Callback>>> timers;
+    // armed in reverse order, so every push has to move the job up
+    for (int64_t i = mNumberOfTimers; i > 0; i--)
+    {
+      timers.emplace_back(new Timer<Callback>(
+          this,
+          &expired,
+          Millisecond(i),
+          protest::meta::CallContext::defaultContext()));
+    }
+    // every other timer is cancelled before it expires
+    for (size_t i = 0; i < timers.size(); i += 2)
+    {
+      timers[i]->stop();
+    }
+    waitInternal(Millisecond(mNumberOfTimers + 1));
+  }
+
+private:
+  int64_t mNumberOfTimers;
+};
+
+class PeriodicRunner : public RunnerRaw
+{
+public:
+  explicit PeriodicRunner(Context& context) : RunnerRaw(context, "per")
+  {
+  }
+
+  void
+  process() override
+  {
+    auto count = [this](auto& timer)
+    {
+      mExpiredAt.push_back(now().milliseconds());
+      if (mExpiredAt.size() == 5u)
+      {
+        timer.stop();
+      }
+      else
+      {
+      }
+    };
+    Timer<decltype(count)> timer(this,
+                                 count,
+                                 Period(Millisecond(3)),
+                                 protest::meta::CallContext::defaultContext());
+    waitInternal(Millisecond(1));
+    waitInternal(Millisecond(100));
+
+    // continues with the rest of the period after a stop
+    timer.start();
+    waitInternal(Millisecond(4));
+    timer.stop();
+  }
+
+  std::vector<int64_t> mExpiredAt;
+};
+
+class UnstoppedRunner : public RunnerRaw
+{
+public:
+  using Count = std::function<void()>;
+
+  explicit UnstoppedRunner(Context& context) : RunnerRaw(context, "per")
+  {
+  }
+
+  void
+  process() override
+  {
+    Count count = [this]() { mExpiredAt.push_back(now().milliseconds()); };
+    {
+      Timer<Count> dropped(this,
+                           count,
+                           Period(Millisecond(1)),
+                           protest::meta::CallContext::defaultContext());
+      waitInternal(Millisecond(3));
+    }
+    waitInternal(Millisecond(5));
+
+    // outlives the runner, which cancels it at the end of process
+    auto& context = protest::meta::CallContext::defaultContext();
+    mTimer.reset(
+        new Timer<Count>(this, count, Period(Millisecond(2)), context));
+    waitInternal(Millisecond(4));
+  }
+
+  std::vector<int64_t> mExpiredAt;
+  std::unique_ptr<Timer<Count>> mTimer;
+};
+
+class Expirations : public Job::Listener
+{
+public:
+  void
+  notify(RunnerRaw* /* runner */) override
+  {
+    mNotifications++;
+  }
+
+  size_t mNotifications = 0u;
+};
+
+} // namespace
+
+TEST(timer, should_not_limit_the_number_of_armed_timers)
+{
+  constexpr int64_t numberOfTimers = 1000;
+  globalExpirations = 0u;
+
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  {
+    Context context;
+    ManyTimersRunner runner(context, numberOfTimers);
+    ASSERT_EQ(0, context.run());
+  }
+
+  ASSERT_EQ(static_cast<size_t>(numberOfTimers / 2), globalExpirations);
+
+  // timers expire in the order of their due time
+  std::istringstream lines(output.str());
+  std::string line;
+  int64_t previous = 0;
+  while (std::getline(lines, line))
+  {
+    if (line.find("expired after") != std::string::npos)
+    {
+      std::getline(lines, line);
+      const int64_t milliseconds = std::stoll(line);
+      ASSERT_LT(previous, milliseconds);
+      previous = milliseconds;
+    }
+    else
+    {
+    }
+  }
+  ASSERT_EQ(numberOfTimers - 1, previous);
+}
+
+TEST(timer, should_expire_periodically_at_absolute_deadlines)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  std::vector<int64_t> expiredAt;
+  {
+    Context context;
+    PeriodicRunner runner(context);
+    ASSERT_EQ(0, context.run());
+    expiredAt = runner.mExpiredAt;
+  }
+
+  // stopped at 15 ms, started again at 101 ms
+  ASSERT_EQ((std::vector<int64_t>{3, 6, 9, 12, 15, 104}), expiredAt);
+}
+
+TEST(timer, should_not_expire_forever_without_a_handle)
+{
+  std::ostringstream output;
+  protest::log::OutputScope outputScope(output);
+  std::vector<int64_t> expiredAt;
+  {
+    Context context;
+    UnstoppedRunner runner(context);
+    ASSERT_EQ(0, context.run());
+    expiredAt = runner.mExpiredAt;
+  }
+
+  // the dropped timer stops at 3 ms, the other one is cancelled at 12 ms
+  ASSERT_EQ((std::vector<int64_t>{1, 2, 3, 10, 12}), expiredAt);
+}
+
+TEST(timer, should_count_missed_periods_on_reschedule)
+{
+  Expirations listener;
+  Job job;
+  const TimePoint start = TimePoint::startOfEpoche();
+  job.setDue(start + Millisecond(10), &listener);
+  job.setPeriod(Millisecond(10));
+
+  job.reschedule(start + Millisecond(10));
+  ASSERT_EQ(1u, job.getExpirations());
+  ASSERT_EQ(Millisecond(10), job.timeTilDue(start + Millisecond(10)));
+
+  // late by three and a half periods
+  job.reschedule(start + Millisecond(55));
+  ASSERT_EQ(4u, job.getExpirations());
+  ASSERT_EQ(Millisecond(5), job.timeTilDue(start + Millisecond(55)));
+  ASSERT_TRUE(job.isArmed());
+  ASSERT_EQ(0u, listener.mNotifications);
+  job.notExecuted();
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include "protest/core/condition.h"
+#include "protest/core/value.h"
+
+#include <string>
+#include <type_traits>
+
+using namespace protest::core;
+using protest::Value;
+
+namespace
+{
+
+class CountingListener : public Condition::Listener
+{
+public:
+  void
+  notify() override
+  {
+    mNotifications++;
+  }
+
+  size_t mNotifications = 0u;
+};
+
+class RecordingListener : public Condition::Listener
+{
+public:
+  explicit RecordingListener(std::string& record, char name) :
+    mRecord(record),
+    mName(name)
+  {
+  }
+
+  void
+  notify() override
+  {
+    mRecord += mName;
+  }
+
+  std::string& mRecord;
+  char mName;
+};
+
+// writes the value again when notified
+class ResettingListener : public Condition::Listener
+{
+public:
+  explicit ResettingListener(Value<int>& value) : mValue(value)
+  {
+  }
+
+  void
+  notify() override
+  {
+    mNotifications++;
+    if (mNotifications == 1u)
+    {
+      mValue = 0;
+    }
+    else
+    {
+    }
+  }
+
+  Value<int>& mValue;
+  size_t mNotifications = 0u;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(value, should_index_comparisons_with_constants)
+{
+  auto counter = Value(0);
+  auto ratio = Value(0.5);
+  static_assert(std::is_same_v<decltype(counter == 1000),
+                               Value<int>::ThresholdExpr<Equals>>);
+  static_assert(std::is_same_v<decltype(1000 < counter),
+                               Value<int>::ThresholdExpr<Greater>>);
+  static_assert(
+      std::is_same_v<decltype(ratio < 1.0),
+                     BinaryExpression<Less, Value<double>::ValueExpr,
+                                      Copy<double>>>);
+  static_assert(
+      std::is_same_v<decltype(counter + 1 == 1000),
+                     BinaryExpression<Equals,
+                                      BinaryExpression<Plus,
+                                                       Value<int>::ValueExpr,
+                                                       Copy<int>>,
+                                      Copy<int>>>);
+}
+
+TEST(value, should_compare_like_the_builtin_operators)
+{
+  auto value = Value(0);
+  for (int i = 0; i < 10; i++)
+  {
+    value = i;
+    ASSERT_EQ(i == 5, (value == 5).getValue());
+    ASSERT_EQ(i != 5, (value != 5).getValue());
+    ASSERT_EQ(i < 5, (value < 5).getValue());
+    ASSERT_EQ(i <= 5, (value <= 5).getValue());
+    ASSERT_EQ(i > 5, (value > 5).getValue());
+    ASSERT_EQ(i >= 5, (value >= 5).getValue());
+    ASSERT_EQ(5 == i, (5 == value).getValue());
+    ASSERT_EQ(5 != i, (5 != value).getValue());
+    ASSERT_EQ(5 < i, (5 < value).getValue());
+    ASSERT_EQ(5 <= i, (5 <= value).getValue());
+    ASSERT_EQ(5 > i, (5 > value).getValue());
+    ASSERT_EQ(5 >= i, (5 >= value).getValue());
+  }
+
+  // the constant is converted to the type of the value
+  auto unsignedValue = Value(0u);
+  ASSERT_EQ(0u > -1, (unsignedValue > -1).getValue());
+
+  // like the other expressions they convert to their result
+  value = 5;
+  auto condition = (value == 5);
+  const bool isEqual = condition;
+  const bool isNotEqual = !condition;
+  ASSERT_TRUE(isEqual);
+  ASSERT_FALSE(isNotEqual);
+}
+
+TEST(value, should_notify_only_if_threshold_is_crossed)
+{
+  auto counter = Value(0);
+  CountingListener listener;
+  auto expr = counter == 1000;
+  ExprCondition<decltype(expr)> condition(nullptr, expr, &listener);
+  condition.enable();
+
+  for (int i = 0; i < 2000; i++)
+  {
+    counter += 1;
+    ASSERT_EQ(i + 1 == 1000, condition.isFulfilled());
+  }
+  // 999 -> 1000 and 1000 -> 1001
+  ASSERT_EQ(2u, listener.mNotifications);
+
+  counter = 0;
+  ASSERT_EQ(3u, listener.mNotifications);
+  counter = 0;
+  ASSERT_EQ(3u, listener.mNotifications);
+  condition.disable();
+
+  counter = 1000;
+  ASSERT_EQ(3u, listener.mNotifications);
+}
+
+TEST(value, should_notify_all_thresholds_in_between)
+{
+  auto counter = Value(0);
+  CountingListener low;
+  CountingListener high;
+  CountingListener generic;
+  auto lowExpr = counter >= 3;
+  auto highExpr = 7 <= counter;
+  auto genericExpr = counter * 2 >= 6;
+  ExprCondition<decltype(lowExpr)> lowCondition(nullptr, lowExpr, &low);
+  ExprCondition<decltype(highExpr)> highCondition(nullptr, highExpr, &high);
+  ExprCondition<decltype(genericExpr)> genericCondition(nullptr,
+                                                        genericExpr,
+                                                        &generic);
+  lowCondition.enable();
+  highCondition.enable();
+  genericCondition.enable();
+
+  counter = 5;
+  ASSERT_EQ(1u, low.mNotifications);
+  ASSERT_EQ(0u, high.mNotifications);
+  ASSERT_TRUE(lowCondition.isFulfilled());
+  ASSERT_FALSE(highCondition.isFulfilled());
+
+  counter = 10;
+  ASSERT_EQ(1u, low.mNotifications);
+  ASSERT_EQ(1u, high.mNotifications);
+  ASSERT_TRUE(highCondition.isFulfilled());
+
+  lowCondition.disable();
+  counter = 0;
+  ASSERT_EQ(1u, low.mNotifications);
+  ASSERT_EQ(2u, high.mNotifications);
+  ASSERT_EQ(3u, generic.mNotifications);
+  highCondition.disable();
+  genericCondition.disable();
+}
+
+TEST(value, should_notify_in_reverse_order_of_registration)
+{
+  auto counter = Value(0);
+  std::string record;
+  RecordingListener first(record, 'a');
+  RecordingListener second(record, 'b');
+  RecordingListener third(record, 'c');
+  RecordingListener fourth(record, 'd');
+  auto firstExpr = counter >= 5;
+  auto secondExpr = counter * 2 >= 6;
+  auto thirdExpr = counter >= 2;
+  auto fourthExpr = counter == 5;
+  ExprCondition<decltype(firstExpr)> firstCondition(nullptr, firstExpr, &first);
+  ExprCondition<decltype(secondExpr)> secondCondition(nullptr,
+                                                      secondExpr,
+                                                      &second);
+  ExprCondition<decltype(thirdExpr)> thirdCondition(nullptr, thirdExpr, &third);
+  ExprCondition<decltype(fourthExpr)> fourthCondition(nullptr,
+                                                      fourthExpr,
+                                                      &fourth);
+  firstCondition.enable();
+  secondCondition.enable();
+  thirdCondition.enable();
+  fourthCondition.enable();
+
+  // like the generic listeners, independent of the thresholds
+  counter = 5;
+  ASSERT_EQ("dcba", record);
+
+  // re-enabling registers again
+  firstCondition.disable();
+  firstCondition.enable();
+  record.clear();
+  counter = 0;
+  ASSERT_EQ("adcb", record);
+
+  firstCondition.disable();
+  secondCondition.disable();
+  thirdCondition.disable();
+  fourthCondition.disable();
+}
+
+TEST(value, should_notify_thresholds_of_nested_writes)
+{
+  auto counter = Value(0);
+  CountingListener low;
+  ResettingListener high(counter);
+  auto lowExpr = counter >= 5;
+  auto highExpr = counter >= 10;
+  ExprCondition<decltype(lowExpr)> lowCondition(nullptr, lowExpr, &low);
+  ExprCondition<decltype(highExpr)> highCondition(nullptr, highExpr, &high);
+  lowCondition.enable();
+  highCondition.enable();
+
+  // high resets the counter before low is notified of the first write
+  counter = 10;
+  ASSERT_EQ(0, static_cast<int>(counter));
+  ASSERT_EQ(2u, high.mNotifications);
+  ASSERT_EQ(2u, low.mNotifications);
+  ASSERT_FALSE(lowCondition.isFulfilled());
+  lowCondition.disable();
+  highCondition.disable();
+}
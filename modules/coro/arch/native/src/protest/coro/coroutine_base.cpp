@@ -0,0 +1,247 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/coro/coroutine_base.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cassert>
+
+using namespace protest::coro;
+
+// ---------------------------------------------------------------------------
+// protest_coro_switch(void** from, void* to)
+//
+// pushes all callee-saved registers onto the current stack, stores the stack
+// pointer into *from, switches to the stack 'to' and pops the registers of
+// the other coroutine. The return address on top of the stack of the other
+// coroutine is either the place where it called protest_coro_switch or (the
+// first time) protest_coro_trampoline.
+//
+// protest_coro_trampoline
+//
+// entry point of a new coroutine. Calls entry(argument) where both values are
+// taken from callee-saved registers which are prepared by the constructor.
+// clang-format off
+#if defined(__APPLE__)
+#define PROTEST_CORO_SYMBOL(name) "_" #name
+#define PROTEST_CORO_TYPE(name)
+#define PROTEST_CORO_SIZE(name)
+#else
+#define PROTEST_CORO_SYMBOL(name) #name
+#define PROTEST_CORO_TYPE(name) ".type " #name ", %function\n"
+#define PROTEST_CORO_SIZE(name) ".size " #name ", .-" #name "\n"
+#endif
+
+#if defined(__x86_64__)
+
+// layout (from the stack pointer upwards): x87 control word, mxcsr,
+// r15, r14, r13, r12, rbx, rbp, return address
+static constexpr size_t numberOfSavedSlots = 8;
+static constexpr size_t slotOfFpuControlWord = 0;
+static constexpr size_t slotOfMxcsr = 1;
+static constexpr size_t slotOfEntry = 4;
+static constexpr size_t slotOfArgument = 5;
+
+// NOLINTNEXTLINE
+asm(".text\n"
+    ".globl " PROTEST_CORO_SYMBOL(protest_coro_switch) "\n"
+    PROTEST_CORO_TYPE(protest_coro_switch)
+    ".p2align 4\n"
+    PROTEST_CORO_SYMBOL(protest_coro_switch) ":\n"
+    "  pushq %rbp\n"
+    "  pushq %rbx\n"
+    "  pushq %r12\n"
+    "  pushq %r13\n"
+    "  pushq %r14\n"
+    "  pushq %r15\n"
+    "  subq $16, %rsp\n"
+    "  stmxcsr 8(%rsp)\n"
+    "  fnstcw (%rsp)\n"
+    "  movq %rsp, (%rdi)\n"
+    "  movq %rsi, %rsp\n"
+    "  ldmxcsr 8(%rsp)\n"
+    "  fldcw (%rsp)\n"
+    "  addq $16, %rsp\n"
+    "  popq %r15\n"
+    "  popq %r14\n"
+    "  popq %r13\n"
+    "  popq %r12\n"
+    "  popq %rbx\n"
+    "  popq %rbp\n"
+    "  ret\n"
+    PROTEST_CORO_SIZE(protest_coro_switch)
+    ".globl " PROTEST_CORO_SYMBOL(protest_coro_trampoline) "\n"
+    PROTEST_CORO_TYPE(protest_coro_trampoline)
+    ".p2align 4\n"
+    PROTEST_CORO_SYMBOL(protest_coro_trampoline) ":\n"
+    "  movq %r12, %rdi\n"
+    "  callq *%r13\n"
+    "  ud2\n"
+    PROTEST_CORO_SIZE(protest_coro_trampoline));
+
+#elif defined(__aarch64__)
+
+// layout (from the stack pointer upwards): x19 - x30, d8 - d15
+static constexpr size_t numberOfSavedSlots = 20;
+static constexpr size_t slotOfArgument = 0;
+static constexpr size_t slotOfEntry = 1;
+static constexpr size_t slotOfLinkRegister = 11;
+
+// NOLINTNEXTLINE
+asm(".text\n"
+    ".globl " PROTEST_CORO_SYMBOL(protest_coro_switch) "\n"
+    PROTEST_CORO_TYPE(protest_coro_switch)
+    ".p2align 4\n"
+    PROTEST_CORO_SYMBOL(protest_coro_switch) ":\n"
+    "  sub sp, sp, #160\n"
+    "  stp x19, x20, [sp, #0]\n"
+    "  stp x21, x22, [sp, #16]\n"
+    "  stp x23, x24, [sp, #32]\n"
+    "  stp x25, x26, [sp, #48]\n"
+    "  stp x27, x28, [sp, #64]\n"
+    "  stp x29, x30, [sp, #80]\n"
+    "  stp d8, d9, [sp, #96]\n"
+    "  stp d10, d11, [sp, #112]\n"
+    "  stp d12, d13, [sp, #128]\n"
+    "  stp d14, d15, [sp, #144]\n"
+    "  mov x2, sp\n"
+    "  str x2, [x0]\n"
+    "  mov sp, x1\n"
+    "  ldp x19, x20, [sp, #0]\n"
+    "  ldp x21, x22, [sp, #16]\n"
+    "  ldp x23, x24, [sp, #32]\n"
+    "  ldp x25, x26, [sp, #48]\n"
+    "  ldp x27, x28, [sp, #64]\n"
+    "  ldp x29, x30, [sp, #80]\n"
+    "  ldp d8, d9, [sp, #96]\n"
+    "  ldp d10, d11, [sp, #112]\n"
+    "  ldp d12, d13, [sp, #128]\n"
+    "  ldp d14, d15, [sp, #144]\n"
+    "  add sp, sp, #160\n"
+    "  ret\n"
+    PROTEST_CORO_SIZE(protest_coro_switch)
+    ".globl " PROTEST_CORO_SYMBOL(protest_coro_trampoline) "\n"
+    PROTEST_CORO_TYPE(protest_coro_trampoline)
+    ".p2align 4\n"
+    PROTEST_CORO_SYMBOL(protest_coro_trampoline) ":\n"
+    "  mov x0, x19\n"
+    "  blr x20\n"
+    "  brk #0\n"
+    PROTEST_CORO_SIZE(protest_coro_trampoline));
+
+#else
+#error "native coroutine port supports x86-64 and AArch64 only (use posix)"
+#endif
+// clang-format on
+
+extern "C" void
+protest_coro_switch(void** from, void* to);
+
+extern "C" void
+protest_coro_trampoline();
+
+// ---------------------------------------------------------------------------
+static void
+wrapper(void* argument)
+{
+  auto* thd = reinterpret_cast<CoroutineBase*>(argument);
+  thd->coroRun();
+  // coroRun must never return (there is no parent to return to)
+  abort();
+}
+
+// ---------------------------------------------------------------------------
+void
+CoroutineBase::swapContext(CoroContext* first, CoroContext* second)
+{
+  protest_coro_switch(&first->mStackPointer, second->mStackPointer);
+}
+
+void
+CoroutineBase::initialize(CoroContext* context)
+{
+  // the stack pointer will be stored on the first switch away from this
+  // context
+  context->mStackPointer = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+CoroutineBase::CoroutineBase(CoroContext* /* parent */,
+                             void* stack,
+                             size_t size) :
+  mContext {nullptr}
+{
+  static constexpr uintptr_t stackAlignment = 16U;
+
+  if (stack == nullptr)
+  {
+    // stackless -> resumed by the scheduler instead of switched to
+    return;
+  }
+  else
+  {
+  }
+
+  auto top = reinterpret_cast<uintptr_t>(stack) + size;
+  top = top & ~(stackAlignment - 1);
+
+#if defined(__x86_64__)
+  // the trampoline is entered by 'ret' -> the stack pointer must be aligned
+  // after popping the return address so that the call inside of the
+  // trampoline sees a properly aligned stack.
+  static constexpr uint32_t defaultMxcsr = 0x1F80;
+  static constexpr uint16_t defaultFpuControlWord = 0x037F;
+
+  auto* returnAddress = reinterpret_cast<void**>(top - stackAlignment) - 1;
+  *returnAddress = reinterpret_cast<void*>(&protest_coro_trampoline);
+  auto* slots = returnAddress - numberOfSavedSlots;
+  for (size_t i = 0; i < numberOfSavedSlots; i++)
+  {
+    slots[i] = nullptr;
+  }
+  *reinterpret_cast<uint16_t*>(&slots[slotOfFpuControlWord]) =
+      defaultFpuControlWord;
+  *reinterpret_cast<uint32_t*>(&slots[slotOfMxcsr]) = defaultMxcsr;
+  slots[slotOfArgument] = this;
+  slots[slotOfEntry] = reinterpret_cast<void*>(&wrapper);
+#elif defined(__aarch64__)
+  auto* slots = reinterpret_cast<void**>(top) - numberOfSavedSlots;
+  for (size_t i = 0; i < numberOfSavedSlots; i++)
+  {
+    slots[i] = nullptr;
+  }
+  slots[slotOfArgument] = this;
+  slots[slotOfEntry] = reinterpret_cast<void*>(&wrapper);
+  slots[slotOfLinkRegister] =
+      reinterpret_cast<void*>(&protest_coro_trampoline);
+#endif
+
+  mContext.mStackPointer = slots;
+}
+
+CoroutineBase::~CoroutineBase()
+{
+  mContext.mStackPointer = nullptr;
+}
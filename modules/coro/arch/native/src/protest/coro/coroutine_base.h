@@ -0,0 +1,109 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace protest
+{
+
+namespace coro
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class CoroutineBase
+ * 
+ * Native port of the coroutine base. In contrast to the posix port (which
+ * uses ucontext) a context switch only saves and restores the callee-saved
+ * registers of the calling convention. Since the signal mask is not touched
+ * there is no system call involved when switching between coroutines.
+ * 
+ * Supported are x86-64 (System V ABI) and AArch64.
+ */
+class CoroutineBase
+{
+public:
+  friend class Scheduler;
+  friend class Coroutine;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class CoroContext
+   * 
+   * All registers are pushed onto the stack of the coroutine which is
+   * suspended. Therefore the context only has to remember the stack pointer.
+   */
+  struct CoroContext
+  {
+    void* mStackPointer;
+  };
+
+  static constexpr size_t defaultStackSize = 1024 * 60;
+
+  static void
+  swapContext(CoroContext* first, CoroContext* second);
+
+  static void
+  initialize(CoroContext* context);
+
+// ---------------------------------------------------------------------------
+  /**
+   * @param parent
+   *  context of the scheduler
+   * 
+   * @param stack
+   *  memory of the stack. It is owned by the caller and must outlive the
+   *  coroutine. If it is nullptr no context is prepared, the coroutine is
+   *  stackless and must never be switched to (see Coroutine::isStackless).
+   * 
+   * @param size
+   *  size of the stack in bytes
+   */
+  explicit CoroutineBase(CoroContext* parent, void* stack, size_t size);
+
+  CoroutineBase(const CoroutineBase&) = delete;
+
+  CoroutineBase(CoroutineBase&&) noexcept = delete;
+
+  CoroutineBase&
+  operator=(const CoroutineBase&) = delete;
+
+  CoroutineBase&
+  operator=(CoroutineBase&&) noexcept = delete;
+
+  virtual ~CoroutineBase();
+
+// ---------------------------------------------------------------------------
+  virtual void
+  coroRun() = 0;
+
+protected:
+  CoroContext mContext;
+};
+
+} // namespace coro
+
+} // namespace protest
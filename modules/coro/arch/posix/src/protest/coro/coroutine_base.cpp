@@ -60,15 +60,26 @@ CoroutineBase::initialize(CoroContext* context)
 }
 
 // ---------------------------------------------------------------------------
-CoroutineBase::CoroutineBase(CoroContext* /* parent */) : mContext {0}
+CoroutineBase::CoroutineBase(CoroContext* /* parent */,
+                             void* stack,
+                             size_t size) :
+  mContext {0}
 {
   ::memset(&mContext, 0, sizeof(mContext));
+  if (stack == nullptr)
+  {
+    // stackless -> resumed by the scheduler instead of switched to
+    return;
+  }
+  else
+  {
+  }
+
   getcontext(&mContext);
   mContext.uc_link = nullptr;
-  // NOLINTNEXTLINE
-  mContext.uc_stack.ss_sp = malloc(stackSize);
+  mContext.uc_stack.ss_sp = stack;
   assert(mContext.uc_stack.ss_sp);
-  mContext.uc_stack.ss_size = stackSize;
+  mContext.uc_stack.ss_size = size;
   CoroutineBase* self = this;
   auto* ptr = reinterpret_cast<uint32_t*>(&self);
   makecontext(&this->mContext,
@@ -80,7 +91,5 @@ CoroutineBase::CoroutineBase(CoroContext* /* parent */) : mContext {0}
 
 CoroutineBase::~CoroutineBase()
 {
-  // NOLINTNEXTLINE
-  free(mContext.uc_stack.ss_sp);
   mContext.uc_stack.ss_sp = nullptr;
 }
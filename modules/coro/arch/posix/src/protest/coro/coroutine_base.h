@@ -46,7 +46,7 @@ public:
 // ---------------------------------------------------------------------------
   using CoroContext = ucontext_t;
 
-  static constexpr size_t stackSize = 1024 * 60;
+  static constexpr size_t defaultStackSize = 1024 * 60;
 
   static void
   swapContext(CoroContext* first, CoroContext* second);
@@ -55,7 +55,19 @@ public:
   initialize(CoroContext* context);
 
 // ---------------------------------------------------------------------------
-  explicit CoroutineBase(CoroContext* parent);
+  /**
+   * @param parent
+   *  context of the scheduler
+   * 
+   * @param stack
+   *  memory of the stack. It is owned by the caller and must outlive the
+   *  coroutine. If it is nullptr no context is prepared, the coroutine is
+   *  stackless and must never be switched to (see Coroutine::isStackless).
+   * 
+   * @param size
+   *  size of the stack in bytes
+   */
+  explicit CoroutineBase(CoroContext* parent, void* stack, size_t size);
 
   CoroutineBase(const CoroutineBase&) = delete;
 
@@ -73,7 +85,7 @@ public:
   virtual void
   coroRun() = 0;
 
-private:
+protected:
   CoroContext mContext;
 };
 
@@ -33,17 +33,40 @@ using namespace protest::coro;
 
 // ---------------------------------------------------------------------------
 Coroutine::Coroutine(Scheduler& scheduler) :
-  CoroutineBase(&scheduler.mMain),
+  Coroutine(scheduler, CoroutineBase::defaultStackSize)
+{
+}
+
+Coroutine::Coroutine(Scheduler& scheduler, size_t stackSize) :
+  Coroutine(scheduler, allocateStack(scheduler, stackSize))
+{
+}
+
+Coroutine::Coroutine(Scheduler& scheduler, StackAllocator::Stack stack) :
+  CoroutineBase(&scheduler.mMain, stack.mBase, stack.mSize),
   mScheduler(scheduler),
-  mStack(nullptr),
+  mStack(stack),
   mSleepUntil(time::TimePoint::startOfEpoche()),
   mNext(nullptr),
   mIndex(0),
   mIsWaiting(false),
-  mIsInSleepQueue(false)
+  mIsInSleepQueue(false),
+  mIsStackPainted(stack.mBase != nullptr && scheduler.isStackPainting()),
+  mSleepSequence(0),
+  mNextSleeper(nullptr),
+  mPrevSleeper(nullptr),
+  mIsFirstSleeper(false),
+  mIsDue(false),
+  mStatistics {}
 {
 }
 
+Coroutine::~Coroutine()
+{
+  StackAllocator::release(mStack);
+  mStack = StackAllocator::Stack {nullptr, 0, false};
+}
+
 // ---------------------------------------------------------------------------
 void
 Coroutine::contextSwitch(CoroutineBase::CoroContext* parent)
@@ -54,6 +77,45 @@ Coroutine::contextSwitch(CoroutineBase::CoroContext* parent)
 // ---------------------------------------------------------------------------
 bool
 Coroutine::coroWait(time::Duration duration)
+{
+  PROTEST_ASSERT(!isStackless());
+  prepareWait(duration);
+  mScheduler.sleep(this, duration);
+  return completeWait();
+}
+
+void
+Coroutine::coroYield()
+{
+  PROTEST_ASSERT(!isStackless());
+  mScheduler.yield(this);
+}
+
+void
+Coroutine::coroWakeup()
+{
+  PROTEST_ASSERT(mIsWaiting);
+  mIsWaiting = false;
+  mScheduler.wakeup(this);
+}
+
+void
+Coroutine::coroExit()
+{
+  PROTEST_ASSERT(!isStackless());
+  mScheduler.exit(this);
+}
+
+void
+Coroutine::coroResume()
+{
+  // only stackless coroutines are resumed
+  PROTEST_ASSERT(false);
+}
+
+// ---------------------------------------------------------------------------
+void
+Coroutine::prepareWait(time::Duration duration)
 {
   if (duration == time::Duration::infinity())
   {
@@ -64,11 +126,13 @@ Coroutine::coroWait(time::Duration duration)
     mSleepUntil = mScheduler.now(this) + duration;
     assert(mSleepUntil.nanoseconds() >= mScheduler.now(this).nanoseconds());
   }
-
-  bool timeout = false;
   mIsWaiting = true;
+}
 
-  mScheduler.sleep(this, duration);
+bool
+Coroutine::completeWait()
+{
+  bool timeout = false;
   if (mIsWaiting)
   {
     mIsWaiting = false;
@@ -82,26 +146,6 @@ Coroutine::coroWait(time::Duration duration)
   return timeout;
 }
 
-void
-Coroutine::coroYield()
-{
-  mScheduler.yield(this);
-}
-
-void
-Coroutine::coroWakeup()
-{
-  PROTEST_ASSERT(mIsWaiting);
-  mIsWaiting = false;
-  mScheduler.wakeup(this);
-}
-
-void
-Coroutine::coroExit()
-{
-  mScheduler.exit(this);
-}
-
 // ---------------------------------------------------------------------------
 bool
 Coroutine::isWaiting() const
@@ -115,6 +159,12 @@ Coroutine::now()
   return mScheduler.now(this);
 }
 
+bool
+Coroutine::isStackless() const
+{
+  return mStack.mBase == nullptr;
+}
+
 // ---------------------------------------------------------------------------
 Coroutine*
 Coroutine::getCurrent()
@@ -128,16 +178,70 @@ Coroutine::getScheduler()
   return mScheduler;
 }
 
+size_t
+Coroutine::getStackSize() const
+{
+  return mStack.mSize;
+}
+
+const CoroutineStatistics&
+Coroutine::getStatistics() const
+{
+  return mStatistics;
+}
+
+size_t
+Coroutine::getStackUsage() const
+{
+  return mIsStackPainted ? StackAllocator::getUsage(mStack) : 0;
+}
+
+bool
+Coroutine::isStackPainted() const
+{
+  return mIsStackPainted;
+}
+
 // NOLINTNEXTLINE
 bool
 Coroutine::operator<(const Coroutine& other)
 {
-  return mSleepUntil < other.mSleepUntil;
+  // coroutines sleeping until the same time wake up in the order they went
+  // to sleep
+  return (mSleepUntil < other.mSleepUntil) ||
+         (mSleepUntil == other.mSleepUntil &&
+          mSleepSequence < other.mSleepSequence);
 }
 
 // NOLINTNEXTLINE
 bool
 Coroutine::operator<=(const Coroutine& other)
 {
-  return mSleepUntil <= other.mSleepUntil;
+  return (mSleepUntil < other.mSleepUntil) ||
+         (mSleepUntil == other.mSleepUntil &&
+          mSleepSequence <= other.mSleepSequence);
+}
+
+// ---------------------------------------------------------------------------
+StackAllocator::Stack
+Coroutine::allocateStack(Scheduler& scheduler, size_t stackSize)
+{
+  if (stackSize == stackless)
+  {
+    return StackAllocator::Stack {nullptr, 0, false};
+  }
+  else
+  {
+  }
+
+  auto stack = StackAllocator::allocate(stackSize);
+  if (scheduler.isStackPainting())
+  {
+    // before the first frame is prepared by CoroutineBase
+    StackAllocator::paint(stack);
+  }
+  else
+  {
+  }
+  return stack;
 }
@@ -26,10 +26,12 @@
 
 #include "protest/utils/queue.h"
 #include "protest/utils/list.h"
-#include "protest/utils/heap.h"
+#include "protest/utils/dynamic_heap.h"
 #include "protest/time/duration.h"
 #include "protest/time/time_point.h"
 #include "protest/coro/coroutine_base.h"
+#include "protest/coro/stack_allocator.h"
+#include "protest/coro/statistics.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -54,12 +56,25 @@ class Coroutine : public CoroutineBase
 public:
   friend class Scheduler;
   friend class Queue<Coroutine>;
-  friend class Heap<Coroutine, 100>;// TODO
+  friend class DynamicHeap<Coroutine>;
   friend class List<Coroutine>;
   friend class Condition;
 
+  // stack size of a stackless coroutine (see isStackless)
+  static constexpr size_t stackless = 0;
+
   explicit Coroutine(Scheduler& scheduler);
 
+  /**
+   * @param scheduler
+   *  the scheduler which runs the coroutine
+   * 
+   * @param stackSize
+   *  size of the stack in bytes (see StackAllocator::allocate). With
+   *  `stackless` no stack is allocated (see isStackless).
+   */
+  explicit Coroutine(Scheduler& scheduler, size_t stackSize);
+
   Coroutine(const Coroutine&) = delete;
 
   Coroutine(Coroutine&&) noexcept = delete;
@@ -70,7 +85,7 @@ public:
   Coroutine&
   operator=(Coroutine&&) noexcept = delete;
 
-  virtual ~Coroutine() = default;
+  virtual ~Coroutine();
 
 // ---------------------------------------------------------------------------
   void
@@ -88,10 +103,30 @@ public:
   void
   coroExit();
 
+  /**
+   * @brief coroResume
+   * 
+   * called by the scheduler (on its own stack) instead of switching to the
+   * coroutine if it is stackless. Must return as soon as the coroutine gave
+   * up the control by a call to the scheduler (yield, sleep or exit).
+   */
+  virtual void
+  coroResume();
+
 // ---------------------------------------------------------------------------
   bool
   isWaiting() const;
 
+  /**
+   * @brief isStackless
+   * 
+   * A stackless coroutine cannot block (coroWait, coroYield and coroExit
+   * are not allowed). It calls the scheduler and returns from coroResume
+   * instead, e.g. by suspending a C++20 coroutine (see Task).
+   */
+  bool
+  isStackless() const;
+
   time::TimePoint
   now();
 
@@ -101,6 +136,32 @@ public:
   Scheduler&
   getScheduler();
 
+  size_t
+  getStackSize() const;
+
+  /**
+   * @brief getStackUsage
+   * 
+   * @return
+   *  the peak usage of the stack in bytes so far. Only measured if the
+   *  stack was painted (see Scheduler::setStackPainting), zero otherwise.
+   */
+  size_t
+  getStackUsage() const;
+
+  bool
+  isStackPainted() const;
+
+  /**
+   * @brief getStatistics
+   * 
+   * @return
+   *  the statistics of the coroutine. They are only collected if the
+   *  instrumentation is enabled (see statistics.h).
+   */
+  const CoroutineStatistics&
+  getStatistics() const;
+
 // ---------------------------------------------------------------------------
   bool
   operator<(const Coroutine& other);
@@ -111,14 +172,43 @@ public:
 // ---------------------------------------------------------------------------
   // TODO (jreinking) make private
 protected:
+  /**
+   * @brief prepareWait
+   * 
+   * first half of coroWait. Must be followed by Scheduler::sleep and
+   * completeWait, which returns true on a timeout.
+   */
+  void
+  prepareWait(time::Duration duration);
+
+  bool
+  completeWait();
+
   Scheduler& mScheduler;
-  // TODO move to port
-  char* mStack;
+  StackAllocator::Stack mStack;
   time::TimePoint mSleepUntil;
   Coroutine* mNext;
   size_t mIndex;
   bool mIsWaiting;
   bool mIsInSleepQueue;
+  bool mIsStackPainted;
+
+  // coroutines sleeping until the same time are chained in the order they
+  // went to sleep (circular list). Only the first one is in the heap of the
+  // scheduler (see Scheduler::pushToSleepQueue)
+  uint64_t mSleepSequence;
+  Coroutine* mNextSleeper;
+  Coroutine* mPrevSleeper;
+  bool mIsFirstSleeper;
+  bool mIsDue;
+
+  CoroutineStatistics mStatistics;
+
+private:
+  explicit Coroutine(Scheduler& scheduler, StackAllocator::Stack stack);
+
+  static StackAllocator::Stack
+  allocateStack(Scheduler& scheduler, size_t stackSize);
 };
 
 } // namespace coro
@@ -25,6 +25,8 @@
 #include "protest/rtos/thread.h"
 #include "protest/coro/scheduler.h"
 
+#include <algorithm>
+
 #include <unistd.h>
 
 using namespace protest::coro;
@@ -33,7 +35,15 @@ using namespace protest::coro;
 Scheduler::Scheduler() :
   mMain {0},
   mCurrent(nullptr),
-  mNumberOfSleepingCoroutines(0)
+  mNumberOfSleepingCoroutines(0),
+  mLastSleeper(nullptr),
+  mDue(nullptr),
+  mNumberOfSleeps(0),
+  mDirectSwitching(true),
+  mBatchedWakeup(true),
+  mStackPainting(false),
+  mRunLimit(time::TimePoint::endOfEpoche()),
+  mStatistics {}
 {
   CoroutineBase::initialize(&mMain);
 }
@@ -41,7 +51,7 @@ Scheduler::Scheduler() :
 void
 Scheduler::addThread(Coroutine* thread)
 {
-  mRunQueue.push(*thread);
+  pushToRunQueue(thread);
 }
 
 // ---------------------------------------------------------------------------
@@ -50,7 +60,9 @@ Scheduler::yield(Coroutine* thread)
 {
   // can only be called from thread itself
   PROTEST_ASSERT(getCurrent() == thread);
-  mRunQueue.push(*thread);
+  PROTEST_INSTRUMENT(mStatistics.mNumberOfYields++);
+  PROTEST_INSTRUMENT(thread->mStatistics.mNumberOfYields++);
+  pushToRunQueue(thread);
   executeNext(thread);
 }
 
@@ -59,6 +71,8 @@ Scheduler::sleep(Coroutine* thread, time::Duration duration)
 {
   // can only be called from thread itself
   PROTEST_ASSERT(getCurrent() == thread);
+  PROTEST_INSTRUMENT(mStatistics.mNumberOfSleeps++);
+  PROTEST_INSTRUMENT(thread->mStatistics.mNumberOfSleeps++);
   if (duration != time::Duration::infinity())
   {
     thread->mSleepUntil = now() + duration;
@@ -78,8 +92,9 @@ Scheduler::sleep(Coroutine* thread, time::Duration duration)
 void
 Scheduler::wakeup(Coroutine* thread)
 {
-  // can not be called from thread itself
-  PROTEST_ASSERT(getCurrent() != thread);
+  // can not be called from thread itself (but from the main context, e.g.
+  // between two calls of runUntil)
+  PROTEST_ASSERT(mCurrent != thread);
   if (thread->mIsInSleepQueue)
   {
     removeFromSleepQueue(thread);
@@ -91,7 +106,9 @@ Scheduler::wakeup(Coroutine* thread)
     // just push it into run queue again
   }
   mNumberOfSleepingCoroutines--;
-  mRunQueue.push(*thread);
+  PROTEST_INSTRUMENT(mStatistics.mNumberOfWakeups++);
+  PROTEST_INSTRUMENT(thread->mStatistics.mNumberOfWakeups++);
+  pushToRunQueue(thread);
 }
 
 void
@@ -99,6 +116,16 @@ Scheduler::exit(Coroutine* thread)
 {
   // can only be called from thread itself
   PROTEST_ASSERT(getCurrent() == thread);
+  if (thread->isStackless())
+  {
+    // there is no stack to keep -> just hand over
+    executeNext(thread);
+    return;
+  }
+  else
+  {
+  }
+
   while (true)
   {
     executeNext(thread);
@@ -122,20 +149,47 @@ Scheduler::now()
 void
 Scheduler::run()
 {
-  if (mRunQueue.isAvailable())
-  {
-    Coroutine& next = mRunQueue.pop();
-    mCurrent = &next;
-  }
+  runUntil(time::TimePoint::endOfEpoche());
+  finish();
+}
+
+void
+Scheduler::runUntil(time::TimePoint end)
+{
+  mRunLimit = end;
+  mCurrent = getNext();
 
   while (mCurrent != nullptr)
   {
-    mCurrent->contextSwitch(&mMain);
-    mCurrent = getNext();
+    PROTEST_INSTRUMENT(countSwitch(nullptr));
+    if (mCurrent->isStackless())
+    {
+      mCurrent->coroResume();
+    }
+    else
+    {
+      mCurrent->contextSwitch(&mMain);
+    }
+
+    if (mDirectSwitching)
+    {
+      // the coroutines only return if there is nothing left to execute or
+      // the next one is stackless. In both cases mCurrent is already set
+      // (see executeNext).
+    }
+    else
+    {
+      mCurrent = getNext();
+    }
   }
 
-  PROTEST_ASSERT(!mRunQueue.isAvailable());
-  PROTEST_ASSERT(!mSleepQueue.isAvailable());
+  mRunLimit = time::TimePoint::endOfEpoche();
+}
+
+void
+Scheduler::finish()
+{
+  PROTEST_ASSERT(!hasPendingEvents());
   if (mNumberOfSleepingCoroutines > 0)
   {
     // there are some infinty sleeping coroutines
@@ -147,6 +201,39 @@ Scheduler::run()
   }
 }
 
+bool
+Scheduler::hasPendingEvents()
+{
+  return mRunQueue.isAvailable() || mDue != nullptr ||
+         mSleepQueue.isAvailable();
+}
+
+protest::time::TimePoint
+Scheduler::getNextEventTime()
+{
+  PROTEST_ASSERT(hasPendingEvents());
+  return (mRunQueue.isAvailable() || mDue != nullptr)
+             ? now()
+             : mSleepQueue.peek()->mSleepUntil;
+}
+
+void
+Scheduler::moveForwardTo(time::TimePoint timePoint)
+{
+  PROTEST_ASSERT(!hasPendingEvents() || getNextEventTime() >= timePoint);
+  if (timePoint == time::TimePoint::endOfEpoche())
+  {
+    mClock.moveToEndOfEpoche();
+  }
+  else if (timePoint > now())
+  {
+    mClock.moveForward(timePoint - now());
+  }
+  else
+  {
+  }
+}
+
 Coroutine*
 Scheduler::getCurrent()
 {
@@ -154,11 +241,96 @@ Scheduler::getCurrent()
   return mCurrent;
 }
 
+void
+Scheduler::setDirectSwitching(bool directSwitching)
+{
+  mDirectSwitching = directSwitching;
+}
+
+bool
+Scheduler::isDirectSwitching() const
+{
+  return mDirectSwitching;
+}
+
+void
+Scheduler::setBatchedWakeup(bool batchedWakeup)
+{
+  mBatchedWakeup = batchedWakeup;
+}
+
+bool
+Scheduler::isBatchedWakeup() const
+{
+  return mBatchedWakeup;
+}
+
+void
+Scheduler::setStackPainting(bool stackPainting)
+{
+  mStackPainting = stackPainting;
+}
+
+bool
+Scheduler::isStackPainting() const
+{
+  return mStackPainting;
+}
+
+const SchedulerStatistics&
+Scheduler::getStatistics() const
+{
+  return mStatistics;
+}
+
 // ---------------------------------------------------------------------------
 void
 Scheduler::executeNext(Coroutine* prev)
 {
-  CoroutineBase::swapContext(&prev->mContext, &mMain);
+  if (prev->isStackless())
+  {
+    // prev returns to runUntil on its own after this call
+    PROTEST_INSTRUMENT(countSwitch(prev));
+    if (mDirectSwitching)
+    {
+      mCurrent = getNext();
+    }
+    else
+    {
+      // runUntil selects the next one
+    }
+    return;
+  }
+  else if (!mDirectSwitching)
+  {
+    PROTEST_INSTRUMENT(countSwitch(prev));
+    CoroutineBase::swapContext(&prev->mContext, &mMain);
+    return;
+  }
+  else
+  {
+  }
+
+  Coroutine* next = getNext();
+  if (next == nullptr || next->isStackless())
+  {
+    // nothing left or the next one has to be resumed from the stack of
+    // runUntil -> return to it
+    mCurrent = next;
+    PROTEST_INSTRUMENT(countSwitch(prev));
+    CoroutineBase::swapContext(&prev->mContext, &mMain);
+  }
+  else if (next != prev)
+  {
+    mCurrent = next;
+    PROTEST_INSTRUMENT(countSwitch(prev));
+    CoroutineBase::swapContext(&prev->mContext, &next->mContext);
+  }
+  else
+  {
+    // prev is the next one (e.g. yield of the only runnable coroutine)
+    // -> just continue
+  }
 }
 
 Coroutine*
@@ -168,52 +340,119 @@ Scheduler::getNext()
   if (mRunQueue.isAvailable())
   {
     next = &mRunQueue.pop();
+    PROTEST_INSTRUMENT(mStatistics.mRunQueueDepth--);
   }
-  else
+  else if (mDue != nullptr)
+  {
+    // the next one of the coroutines woken up at the current time
+    next = popDue();
+  }
+  else if (mSleepQueue.isAvailable())
   {
-    if (mSleepQueue.isAvailable())
+    Coroutine* current = mSleepQueue.peek();
+    if (mRunLimit < time::TimePoint::endOfEpoche() &&
+        current->mSleepUntil >= mRunLimit)
+    {
+      // belongs to the next window (see runUntil) -> keep it
+      next = nullptr;
+    }
+    else if (current->mSleepUntil == time::TimePoint::endOfEpoche())
     {
-      Coroutine* current = mSleepQueue.peek();
-      if (current->mSleepUntil == time::TimePoint::endOfEpoche())
+      // will never wake up
+      mClock.moveToEndOfEpoche();
+      wakeDue();
+      while (mDue != nullptr)
       {
-        next = nullptr;
-        mClock.moveToEndOfEpoche();
+        popDue();
       }
-      else
+      next = nullptr;
+    }
+    else
+    {
+      const time::Duration sleepTime = current->mSleepUntil - mClock.now();
+      mClock.moveForward(sleepTime);
+      wakeDue();
+      next = popDue();
+    }
+  }
+  else
+  {
+    // all are done
+    // just return to the current thread
+    next = nullptr;
+  }
+  return next;
+}
+
+void
+Scheduler::wakeDue()
+{
+  PROTEST_ASSERT(mDue == nullptr);
+  const time::TimePoint time = mSleepQueue.peek()->mSleepUntil;
+  if (mLastSleeper != nullptr && mLastSleeper->mSleepUntil == time)
+  {
+    mLastSleeper = nullptr;
+  }
+  else
+  {
+  }
+
+  // usually there is only one chain per time. If there are more (e.g. another
+  // time was used in between) they are merged by the sleep sequence. The
+  // chains are popped ordered by their first coroutine, so the merge of the
+  // next chain can start at the first coroutine of the previous one.
+  Coroutine* previous = nullptr;
+  while (mSleepQueue.isAvailable() && mSleepQueue.peek()->mSleepUntil == time)
+  {
+    Coroutine* chain = mSleepQueue.pop();
+    chain->mIsFirstSleeper = false;
+
+    Coroutine* position = previous;
+    previous = chain;
+    while (chain != nullptr)
+    {
+      Coroutine* thread = chain;
+      unlinkSleeper(chain, thread);
+      thread->mIsDue = true;
+
+      while (position != nullptr &&
+             position->mSleepSequence < thread->mSleepSequence)
       {
-        const time::Duration sleepTime = current->mSleepUntil - mClock.now();
-        // protest::rtos::Thread::sleep(sleepTime);
-        mClock.moveForward(sleepTime);
-        next = current;
+        position = position->mNextSleeper;
+        position = (position == mDue) ? nullptr : position;
       }
 
-      if (current != nullptr)
+      if (mDue == nullptr)
+      {
+        thread->mNextSleeper = thread;
+        thread->mPrevSleeper = thread;
+        mDue = thread;
+      }
+      else if (position == nullptr)
       {
-        Coroutine* tmp = popFromSleepQueue();
-        assert(current == tmp);
+        // append at the end
+        insertSleeper(mDue, thread);
       }
       else
       {
+        insertSleeper(position, thread);
+        mDue = (position == mDue) ? thread : mDue;
       }
     }
-    else
-    {
-      // mCurrent = nullptr;
-      // all are done
-      // just return to the current thread
-      next = nullptr;
-    }
   }
-  return next;
 }
 
 Coroutine*
-Scheduler::popFromSleepQueue()
+Scheduler::popDue()
 {
-  Coroutine* thread = mSleepQueue.pop();
+  PROTEST_ASSERT(mDue != nullptr);
+  Coroutine* thread = mDue;
+  unlinkSleeper(mDue, thread);
   PROTEST_ASSERT(thread->mIsInSleepQueue);
+  thread->mIsDue = false;
   thread->mIsInSleepQueue = false;
   mNumberOfSleepingCoroutines--;
+  PROTEST_INSTRUMENT(mStatistics.mSleepQueueDepth--);
   return thread;
 }
 
@@ -221,8 +460,42 @@ void
 Scheduler::removeFromSleepQueue(Coroutine* thread)
 {
   PROTEST_ASSERT(thread->mIsInSleepQueue);
-  mSleepQueue.remove(thread);
+  if (thread->mIsDue)
+  {
+    unlinkSleeper(mDue, thread);
+    thread->mIsDue = false;
+  }
+  else if (thread->mIsFirstSleeper)
+  {
+    // the next one of the chain takes its place in the heap
+    mSleepQueue.remove(thread);
+    thread->mIsFirstSleeper = false;
+    Coroutine* next = thread;
+    unlinkSleeper(next, thread);
+    if (next != nullptr)
+    {
+      next->mIsFirstSleeper = true;
+      mSleepQueue.push(next);
+    }
+    else
+    {
+    }
+
+    if (mLastSleeper == thread)
+    {
+      mLastSleeper = next;
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    Coroutine* first = thread;
+    unlinkSleeper(first, thread);
+  }
   thread->mIsInSleepQueue = false;
+  PROTEST_INSTRUMENT(mStatistics.mSleepQueueDepth--);
 }
 
 void
@@ -231,6 +504,86 @@ Scheduler::pushToSleepQueue(Coroutine* thread)
   PROTEST_ASSERT(thread->mIsInSleepQueue == false);
   PROTEST_ASSERT(thread->mSleepUntil >= now());
   mNumberOfSleepingCoroutines++;
-  mSleepQueue.push(thread);
+  thread->mSleepSequence = mNumberOfSleeps++;
   thread->mIsInSleepQueue = true;
+  PROTEST_INSTRUMENT(mStatistics.mSleepQueueDepth++);
+  PROTEST_INSTRUMENT(mStatistics.mMaxSleepQueueDepth =
+                         std::max(mStatistics.mMaxSleepQueueDepth,
+                                  mStatistics.mSleepQueueDepth));
+
+  if (mBatchedWakeup && mLastSleeper != nullptr &&
+      mLastSleeper->mSleepUntil == thread->mSleepUntil)
+  {
+    // usually the coroutines sleeping until the same time go to sleep one
+    // after another -> append it to the chain without touching the heap
+    insertSleeper(mLastSleeper, thread);
+  }
+  else
+  {
+    thread->mNextSleeper = thread;
+    thread->mPrevSleeper = thread;
+    thread->mIsFirstSleeper = true;
+    mSleepQueue.push(thread);
+    mLastSleeper = thread;
+  }
+}
+
+void
+Scheduler::pushToRunQueue(Coroutine* thread)
+{
+  mRunQueue.push(*thread);
+  PROTEST_INSTRUMENT(mStatistics.mRunQueueDepth++);
+  PROTEST_INSTRUMENT(mStatistics.mMaxRunQueueDepth =
+                         std::max(mStatistics.mMaxRunQueueDepth,
+                                  mStatistics.mRunQueueDepth));
+}
+
+void
+Scheduler::countSwitch(Coroutine* from)
+{
+  // the time between two switches is spent in the coroutine switched out
+  const auto now = std::chrono::steady_clock::now();
+  if (from != nullptr)
+  {
+    from->mStatistics.mNumberOfSwitches++;
+    from->mStatistics.mWallTime += now - mSwitchedAt;
+  }
+  else
+  {
+    // switch from the main context
+  }
+  mStatistics.mNumberOfSwitches++;
+  mSwitchedAt = now;
+}
+
+void
+Scheduler::unlinkSleeper(Coroutine*& first, Coroutine* thread)
+{
+  if (thread->mNextSleeper == thread)
+  {
+    first = nullptr;
+  }
+  else
+  {
+    thread->mPrevSleeper->mNextSleeper = thread->mNextSleeper;
+    thread->mNextSleeper->mPrevSleeper = thread->mPrevSleeper;
+    if (first == thread)
+    {
+      first = thread->mNextSleeper;
+    }
+    else
+    {
+    }
+  }
+  thread->mNextSleeper = nullptr;
+  thread->mPrevSleeper = nullptr;
+}
+
+void
+Scheduler::insertSleeper(Coroutine* position, Coroutine* thread)
+{
+  thread->mNextSleeper = position;
+  thread->mPrevSleeper = position->mPrevSleeper;
+  position->mPrevSleeper->mNextSleeper = thread;
+  position->mPrevSleeper = thread;
 }
@@ -26,9 +26,11 @@
 
 #include "protest/coro/coroutine.h"
 #include "protest/coro/logical_clock.h"
-#include "protest/utils/heap.h"
+#include "protest/coro/statistics.h"
+#include "protest/utils/dynamic_heap.h"
 #include "protest/utils/queue.h"
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 
@@ -41,12 +43,29 @@ namespace coro
 // ---------------------------------------------------------------------------
 /**
  * @class Scheduler
+ * 
+ * By default the scheduler switches directly from one coroutine to the next
+ * one (yield, sleep and exit select the next coroutine themselves). Only
+ * when the run queue and the sleep queue are empty the control returns to
+ * the main context. With `setDirectSwitching(false)` every hand-off goes
+ * through the main context, which costs two context switches. The order in
+ * which the coroutines are executed is the same in both modes.
+ * 
+ * Coroutines sleeping until the same time are woken up in the order they
+ * went to sleep. They are kept in one chain per time, so all of them are
+ * taken from the sleep queue at once when the clock reaches that time (see
+ * wakeDue). This is the common case for periodic runners. With
+ * `setBatchedWakeup(false)` every coroutine is kept in the sleep queue on
+ * its own, the order is the same.
+ * 
+ * Stackless coroutines (see Coroutine::isStackless) are resumed from the
+ * stack of runUntil. A switch from or to one of them always goes through
+ * runUntil, the order of execution is not affected.
  */
 class Scheduler
 {
 public:
   static constexpr bool sleepOnWaiting = true;
-  static constexpr size_t maxNumberOfThreads = 100u;
 
   explicit Scheduler();
 
@@ -89,6 +108,83 @@ public:
   void
   run();
 
+  /**
+   * @brief runUntil
+   * 
+   * executes all coroutines which are runnable before `end`. Coroutines
+   * sleeping until `end` or later are kept in the sleep queue, so the
+   * execution can be continued with another call. This is used to execute
+   * several schedulers window by window (see core::RunnerGroup).
+   */
+  void
+  runUntil(time::TimePoint end);
+
+  /**
+   * @brief finish
+   * 
+   * must be called after the last call to runUntil. Moves the clock to the
+   * end of the epoche if there are coroutines sleeping for ever.
+   */
+  void
+  finish();
+
+  bool
+  hasPendingEvents();
+
+  /**
+   * @brief getNextEventTime
+   * 
+   * @return
+   *  the time at which the next coroutine becomes runnable (now if the run
+   *  queue is not empty). Only valid if hasPendingEvents() is true.
+   */
+  time::TimePoint
+  getNextEventTime();
+
+  /**
+   * @brief moveForwardTo
+   * 
+   * moves the clock forward to `timePoint` without executing anything. There
+   * must not be any event before `timePoint`.
+   */
+  void
+  moveForwardTo(time::TimePoint timePoint);
+
+  void
+  setDirectSwitching(bool directSwitching);
+
+  bool
+  isDirectSwitching() const;
+
+  void
+  setBatchedWakeup(bool batchedWakeup);
+
+  bool
+  isBatchedWakeup() const;
+
+  /**
+   * @brief setStackPainting
+   * 
+   * the stacks of coroutines created afterwards are painted, so their
+   * usage can be measured (see Coroutine::getStackUsage). Off by default
+   * since painting touches every page of the stacks.
+   */
+  void
+  setStackPainting(bool stackPainting);
+
+  bool
+  isStackPainting() const;
+
+  /**
+   * @brief getStatistics
+   * 
+   * @return
+   *  the statistics of the scheduler. They are only collected if the
+   *  instrumentation is enabled (see statistics.h).
+   */
+  const SchedulerStatistics&
+  getStatistics() const;
+
   Coroutine*
   getCurrent();
 
@@ -102,8 +198,17 @@ protected:
   Coroutine*
   getNext();
 
+  /**
+   * @brief wakeDue
+   * 
+   * moves all coroutines sleeping until the earliest time of the sleep queue
+   * into the due list, ordered by the time they went to sleep.
+   */
+  void
+  wakeDue();
+
   Coroutine*
-  popFromSleepQueue();
+  popDue();
 
   void
   removeFromSleepQueue(Coroutine* thread);
@@ -111,11 +216,35 @@ protected:
   void
   pushToSleepQueue(Coroutine* thread);
 
+  void
+  pushToRunQueue(Coroutine* thread);
+
+  void
+  countSwitch(Coroutine* from);
+
+  static void
+  unlinkSleeper(Coroutine*& first, Coroutine* thread);
+
+  static void
+  insertSleeper(Coroutine* position, Coroutine* thread);
+
   LogicalClock mClock;
-  uint16_t mNumberOfSleepingCoroutines;
-  Heap<Coroutine, maxNumberOfThreads> mSleepQueue;
+  size_t mNumberOfSleepingCoroutines;
+  // only contains the first coroutine of every sleeping time
+  DynamicHeap<Coroutine> mSleepQueue;
+  // the first coroutine of the time the last coroutine went to sleep
+  Coroutine* mLastSleeper;
+  // coroutines whose time is reached, executed when the run queue is empty
+  Coroutine* mDue;
+  uint64_t mNumberOfSleeps;
   Queue<Coroutine> mRunQueue;
   Coroutine* mCurrent;
+  bool mDirectSwitching;
+  bool mBatchedWakeup;
+  bool mStackPainting;
+  time::TimePoint mRunLimit;
+  SchedulerStatistics mStatistics;
+  std::chrono::steady_clock::time_point mSwitchedAt;
 
 public:
   CoroutineBase::CoroContext mMain;
@@ -0,0 +1,268 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/coro/stack_allocator.h"
+#include "protest/utils/debug.h"
+
+#include <cstdlib>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace protest::coro;
+
+std::mutex StackAllocator::globalMutex;
+StackAllocator::FreeStack* StackAllocator::globalFreeStacks = nullptr;
+size_t StackAllocator::globalNumberOfCachedBytes = 0;
+size_t StackAllocator::globalNumberOfCachedStacks = 0;
+size_t StackAllocator::globalNumberOfMappedStacks = 0;
+
+// ---------------------------------------------------------------------------
+StackAllocator::Stack
+StackAllocator::allocate(size_t stackSize)
+{
+  const size_t size = roundUp(stackSize);
+  std::lock_guard<std::mutex> lock(globalMutex);
+
+  FreeStack** link = &globalFreeStacks;
+  while (*link != nullptr)
+  {
+    FreeStack* head = *link;
+    if (head->mSize == size)
+    {
+      if (head->mNext != nullptr)
+      {
+        head->mNext->mNextSize = head->mNextSize;
+        *link = head->mNext;
+      }
+      else
+      {
+        *link = head->mNextSize;
+      }
+      globalNumberOfCachedBytes -= size;
+      globalNumberOfCachedStacks--;
+      return Stack {toBase(head), size, true};
+    }
+    else
+    {
+    }
+    link = &head->mNextSize;
+  }
+
+  if (globalNumberOfMappedStacks >= maxNumberOfMappedStacks)
+  {
+    // NOLINTNEXTLINE
+    void* memory = malloc(size);
+    PROTEST_ASSERT(memory != nullptr);
+    return Stack {memory, size, false};
+  }
+  else
+  {
+  }
+
+  const size_t pageSize = getPageSize();
+  void* mapping = ::mmap(nullptr,
+                         size + pageSize,
+                         PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                         -1,
+                         0);
+  PROTEST_ASSERT(mapping != MAP_FAILED);
+
+  // the stack grows downwards -> the guard page is at the lowest address
+  int result = ::mprotect(mapping, pageSize, PROT_NONE);
+  PROTEST_ASSERT(result == 0);
+  globalNumberOfMappedStacks++;
+
+  return Stack {static_cast<char*>(mapping) + pageSize, size, true};
+}
+
+void
+StackAllocator::release(Stack stack)
+{
+  if (stack.mBase == nullptr)
+  {
+    return;
+  }
+  else if (!stack.mIsMapped)
+  {
+    // NOLINTNEXTLINE
+    free(stack.mBase);
+    return;
+  }
+  else
+  {
+  }
+
+  std::lock_guard<std::mutex> lock(globalMutex);
+  if (globalNumberOfCachedBytes + stack.mSize > maxNumberOfCachedBytes)
+  {
+    unmap(stack);
+    return;
+  }
+  else
+  {
+  }
+
+  auto* freeStack = toFreeStack(stack);
+  freeStack->mSize = stack.mSize;
+  freeStack->mNext = nullptr;
+  freeStack->mNextSize = nullptr;
+
+  FreeStack** link = &globalFreeStacks;
+  while (*link != nullptr && (*link)->mSize != stack.mSize)
+  {
+    link = &(*link)->mNextSize;
+  }
+
+  if (*link != nullptr)
+  {
+    // new head of this size
+    freeStack->mNext = *link;
+    freeStack->mNextSize = (*link)->mNextSize;
+  }
+  else
+  {
+  }
+  *link = freeStack;
+
+  globalNumberOfCachedBytes += stack.mSize;
+  globalNumberOfCachedStacks++;
+}
+
+void
+StackAllocator::trim()
+{
+  std::lock_guard<std::mutex> lock(globalMutex);
+  FreeStack* head = globalFreeStacks;
+  while (head != nullptr)
+  {
+    FreeStack* nextSize = head->mNextSize;
+    while (head != nullptr)
+    {
+      FreeStack* next = head->mNext;
+      unmap(Stack {toBase(head), head->mSize, true});
+      head = next;
+    }
+    head = nextSize;
+  }
+  globalFreeStacks = nullptr;
+  globalNumberOfCachedBytes = 0;
+  globalNumberOfCachedStacks = 0;
+}
+
+void
+StackAllocator::paint(Stack stack)
+{
+  auto* word = static_cast<uint64_t*>(stack.mBase);
+  const size_t numberOfWords = stack.mSize / sizeof(uint64_t);
+  for (size_t i = 0; i < numberOfWords; i++)
+  {
+    word[i] = paintPattern;
+  }
+}
+
+size_t
+StackAllocator::getUsage(Stack stack)
+{
+  // the stack grows downwards -> the untouched part starts at the base
+  const auto* word = static_cast<const uint64_t*>(stack.mBase);
+  const size_t numberOfWords = stack.mSize / sizeof(uint64_t);
+  size_t untouched = 0;
+  while (untouched < numberOfWords && word[untouched] == paintPattern)
+  {
+    untouched++;
+  }
+  return stack.mSize - untouched * sizeof(uint64_t);
+}
+
+// ---------------------------------------------------------------------------
+size_t
+StackAllocator::getPageSize()
+{
+  static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  return pageSize;
+}
+
+size_t
+StackAllocator::getNumberOfCachedStacks()
+{
+  std::lock_guard<std::mutex> lock(globalMutex);
+  return globalNumberOfCachedStacks;
+}
+
+size_t
+StackAllocator::getNumberOfMappedStacks()
+{
+  std::lock_guard<std::mutex> lock(globalMutex);
+  return globalNumberOfMappedStacks;
+}
+
+bool
+StackAllocator::hasGuardPages()
+{
+  std::lock_guard<std::mutex> lock(globalMutex);
+  return globalNumberOfMappedStacks < maxNumberOfMappedStacks;
+}
+
+// ---------------------------------------------------------------------------
+size_t
+StackAllocator::roundUp(size_t stackSize)
+{
+  const size_t pageSize = getPageSize();
+  if (stackSize < minimumStackSize)
+  {
+    stackSize = minimumStackSize;
+  }
+  else
+  {
+  }
+  return (stackSize + pageSize - 1) / pageSize * pageSize;
+}
+
+void
+StackAllocator::unmap(Stack stack)
+{
+  const size_t pageSize = getPageSize();
+  int result = ::munmap(static_cast<char*>(stack.mBase) - pageSize,
+                        stack.mSize + pageSize);
+  PROTEST_ASSERT(result == 0);
+  globalNumberOfMappedStacks--;
+}
+
+StackAllocator::FreeStack*
+StackAllocator::toFreeStack(Stack stack)
+{
+  // the top of the stack is touched by every coroutine anyway -> storing
+  // the header there does not fault in an additional page
+  return reinterpret_cast<FreeStack*>(static_cast<char*>(stack.mBase) +
+                                      stack.mSize - sizeof(FreeStack));
+}
+
+void*
+StackAllocator::toBase(FreeStack* freeStack)
+{
+  return reinterpret_cast<char*>(freeStack) + sizeof(FreeStack) -
+         freeStack->mSize;
+}
@@ -0,0 +1,186 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace protest
+{
+
+namespace coro
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class StackAllocator
+ * 
+ * Hands out the stacks of the coroutines. Every stack is mapped with mmap
+ * and is preceded by a PROT_NONE guard page, so a stack overflow results in
+ * a segmentation fault instead of silently corrupting the heap.
+ * 
+ * Each guarded stack needs two mappings and the number of mappings of a
+ * process is limited (vm.max_map_count, 65530 by default). Beyond
+ * `maxNumberOfMappedStacks` the stacks are therefore taken from the heap
+ * without guard page.
+ * 
+ * Released stacks are kept in a free list (one per stack size) and are
+ * handed out again by the next allocation of the same size. This avoids the
+ * mmap/munmap calls and the page faults of touching fresh pages when test
+ * scripts create and destroy a lot of threads.
+ * 
+ * To measure how much of a stack is used it can be painted with a pattern
+ * before the coroutine starts. The part which still holds the pattern was
+ * never touched (see getUsage).
+ */
+class StackAllocator
+{
+public:
+  static constexpr size_t minimumStackSize = 1024 * 16;
+
+  static constexpr size_t maxNumberOfCachedBytes = 1024 * 1024 * 64;
+
+  static constexpr size_t maxNumberOfMappedStacks = 1024 * 16;
+
+  static constexpr uint64_t paintPattern = 0xA5A5A5A5A5A5A5A5U;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class Stack
+   * 
+   * Usable memory of a stack (without the guard page). The stack grows
+   * towards `mBase`.
+   */
+  struct Stack
+  {
+    void* mBase;
+    size_t mSize;
+    bool mIsMapped;
+  };
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief allocate
+   * 
+   * @param stackSize
+   *  requested size in bytes. It is rounded up to a multiple of the page
+   *  size and to at least `minimumStackSize`.
+   * 
+   * @return
+   *  the stack, either taken from the free list, freshly mapped or (if
+   *  there are too many mapped stacks) allocated on the heap
+   */
+  static Stack
+  allocate(size_t stackSize);
+
+  static void
+  release(Stack stack);
+
+  /**
+   * @brief trim
+   * 
+   * Unmaps all stacks which are currently in the free list.
+   */
+  static void
+  trim();
+
+  /**
+   * @brief paint
+   * 
+   * fills the whole stack with `paintPattern`. Touches all pages of the
+   * stack, so it should only be used to measure the usage.
+   */
+  static void
+  paint(Stack stack);
+
+  /**
+   * @brief getUsage
+   * 
+   * @return
+   *  the peak usage of a painted stack in bytes, i.e. the distance from the
+   *  top to the deepest word which does not hold the pattern anymore. If it
+   *  is the size of the stack, the stack was exhausted.
+   */
+  static size_t
+  getUsage(Stack stack);
+
+// ---------------------------------------------------------------------------
+  static size_t
+  getPageSize();
+
+  static size_t
+  getNumberOfCachedStacks();
+
+  static size_t
+  getNumberOfMappedStacks();
+
+  /**
+   * @brief hasGuardPages
+   * 
+   * @return
+   *  false if the next stack may be taken from the heap without guard page
+   *  (see maxNumberOfMappedStacks)
+   */
+  static bool
+  hasGuardPages();
+
+private:
+  /**
+   * @class FreeStack
+   * 
+   * Placed at the top of a released stack. All free stacks of one size are
+   * chained with `mNext`, the first stack of each size is additionally
+   * chained with `mNextSize`.
+   */
+  struct FreeStack
+  {
+    FreeStack* mNext;
+    FreeStack* mNextSize;
+    size_t mSize;
+  };
+
+  static size_t
+  roundUp(size_t stackSize);
+
+  static void
+  unmap(Stack stack);
+
+  static FreeStack*
+  toFreeStack(Stack stack);
+
+  static void*
+  toBase(FreeStack* freeStack);
+
+  static std::mutex globalMutex;
+  static FreeStack* globalFreeStacks;
+  static size_t globalNumberOfCachedBytes;
+  static size_t globalNumberOfCachedStacks;
+  static size_t globalNumberOfMappedStacks;
+};
+
+} // namespace coro
+
+} // namespace protest
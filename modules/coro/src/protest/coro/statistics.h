@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The instrumentation is enabled with the CMake option
+ * PROTEST_INSTRUMENTATION. If it is disabled all statements wrapped in
+ * PROTEST_INSTRUMENT are compiled out and the statistics stay zero.
+ */
+#if defined(PROTEST_INSTRUMENTATION)
+#define PROTEST_INSTRUMENT(statement) statement
+#else
+#define PROTEST_INSTRUMENT(statement)
+#endif
+
+namespace protest
+{
+
+namespace coro
+{
+
+#if defined(PROTEST_INSTRUMENTATION)
+static constexpr bool isInstrumentationEnabled = true;
+#else
+static constexpr bool isInstrumentationEnabled = false;
+#endif
+
+// ---------------------------------------------------------------------------
+/**
+ * @class CoroutineStatistics
+ */
+struct CoroutineStatistics
+{
+  // number of times the coroutine was switched out
+  uint64_t mNumberOfSwitches;
+  uint64_t mNumberOfYields;
+  uint64_t mNumberOfSleeps;
+  uint64_t mNumberOfWakeups;
+  // wall clock time spent inside the coroutine between two switches
+  std::chrono::nanoseconds mWallTime;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class SchedulerStatistics
+ */
+struct SchedulerStatistics
+{
+  uint64_t mNumberOfSwitches;
+  uint64_t mNumberOfYields;
+  uint64_t mNumberOfSleeps;
+  uint64_t mNumberOfWakeups;
+  size_t mRunQueueDepth;
+  size_t mMaxRunQueueDepth;
+  size_t mSleepQueueDepth;
+  size_t mMaxSleepQueueDepth;
+};
+
+} // namespace coro
+
+} // namespace protest
@@ -0,0 +1,424 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "protest/coro/task.h requires C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace protest
+{
+
+namespace coro
+{
+
+template <typename T>
+class Task;
+
+// ---------------------------------------------------------------------------
+/**
+ * @class TaskPromiseBase
+ */
+class TaskPromiseBase
+{
+public:
+// ---------------------------------------------------------------------------
+  /**
+   * @class FinalAwaiter
+   * 
+   * continues the awaiting task directly (symmetric transfer). A task
+   * without one (e.g. the outermost task of a stackless runner) returns to
+   * the caller of resume.
+   */
+  struct FinalAwaiter
+  {
+    bool
+    await_ready() noexcept;
+
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+
+    void
+    await_resume() noexcept;
+  };
+
+// ---------------------------------------------------------------------------
+  std::suspend_always
+  initial_suspend() noexcept;
+
+  FinalAwaiter
+  final_suspend() noexcept;
+
+  void
+  unhandled_exception() noexcept;
+
+  void
+  setContinuation(std::coroutine_handle<> continuation);
+
+protected:
+  void
+  rethrow();
+
+private:
+  std::coroutine_handle<> mContinuation;
+  std::exception_ptr mException;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class TaskPromise
+ */
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+  Task<T>
+  get_return_object();
+
+  template <typename U>
+  void
+  return_value(U&& value);
+
+  T
+  getResult();
+
+private:
+  std::optional<T> mValue;
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+  Task<void>
+  get_return_object();
+
+  void
+  return_void();
+
+  void
+  getResult();
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class Task
+ * 
+ * Lazily started C++20 coroutine. It is executed when it is awaited by
+ * another task (or resumed explicitly) and continues the awaiting one when
+ * it is done. The frame is owned by the task object.
+ * 
+ * Tasks do not know about the scheduler. They are suspended by awaitables
+ * which hand over the control to the scheduler (see core::StacklessRunner).
+ */
+template <typename T = void>
+class Task
+{
+public:
+  using promise_type = TaskPromise<T>;
+  using Handle = std::coroutine_handle<promise_type>;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @class Awaiter
+   */
+  class Awaiter
+  {
+  public:
+    explicit Awaiter(Handle handle);
+
+    bool
+    await_ready() noexcept;
+
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> awaiting) noexcept;
+
+    T
+    await_resume();
+
+  private:
+    Handle mHandle;
+  };
+
+// ---------------------------------------------------------------------------
+  explicit Task();
+
+  explicit Task(Handle handle);
+
+  Task(const Task&) = delete;
+
+  Task(Task&& other) noexcept;
+
+  Task&
+  operator=(const Task&) = delete;
+
+  Task&
+  operator=(Task&& other) noexcept;
+
+  ~Task();
+
+// ---------------------------------------------------------------------------
+  Awaiter
+  operator co_await() && noexcept;
+
+  Handle
+  getHandle() const;
+
+  bool
+  isDone() const;
+
+  /**
+   * @brief getResult
+   * 
+   * @return
+   *  the result of a finished task. Rethrows the exception if the task was
+   *  left by one.
+   */
+  T
+  getResult();
+
+private:
+  void
+  destroy();
+
+  Handle mHandle;
+};
+
+// ---------------------------------------------------------------------------
+inline bool
+TaskPromiseBase::FinalAwaiter::await_ready() noexcept
+{
+  return false;
+}
+
+template <typename Promise>
+std::coroutine_handle<>
+TaskPromiseBase::FinalAwaiter::await_suspend(
+    std::coroutine_handle<Promise> handle) noexcept
+{
+  auto continuation = handle.promise().mContinuation;
+  return continuation ? continuation : std::noop_coroutine();
+}
+
+inline void
+TaskPromiseBase::FinalAwaiter::await_resume() noexcept
+{
+}
+
+inline std::suspend_always
+TaskPromiseBase::initial_suspend() noexcept
+{
+  return {};
+}
+
+inline TaskPromiseBase::FinalAwaiter
+TaskPromiseBase::final_suspend() noexcept
+{
+  return {};
+}
+
+inline void
+TaskPromiseBase::unhandled_exception() noexcept
+{
+  mException = std::current_exception();
+}
+
+inline void
+TaskPromiseBase::setContinuation(std::coroutine_handle<> continuation)
+{
+  mContinuation = continuation;
+}
+
+inline void
+TaskPromiseBase::rethrow()
+{
+  if (mException)
+  {
+    std::rethrow_exception(mException);
+  }
+  else
+  {
+  }
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Task<T>
+TaskPromise<T>::get_return_object()
+{
+  return Task<T>(Task<T>::Handle::from_promise(*this));
+}
+
+template <typename T>
+template <typename U>
+void
+TaskPromise<T>::return_value(U&& value)
+{
+  mValue.emplace(std::forward<U>(value));
+}
+
+template <typename T>
+T
+TaskPromise<T>::getResult()
+{
+  rethrow();
+  return std::move(*mValue);
+}
+
+inline Task<void>
+TaskPromise<void>::get_return_object()
+{
+  return Task<void>(Task<void>::Handle::from_promise(*this));
+}
+
+inline void
+TaskPromise<void>::return_void()
+{
+}
+
+inline void
+TaskPromise<void>::getResult()
+{
+  rethrow();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Task<T>::Awaiter::Awaiter(Handle handle) : mHandle(handle)
+{
+}
+
+template <typename T>
+bool
+Task<T>::Awaiter::await_ready() noexcept
+{
+  return !mHandle || mHandle.done();
+}
+
+template <typename T>
+std::coroutine_handle<>
+Task<T>::Awaiter::await_suspend(std::coroutine_handle<> awaiting) noexcept
+{
+  mHandle.promise().setContinuation(awaiting);
+  return mHandle;
+}
+
+template <typename T>
+T
+Task<T>::Awaiter::await_resume()
+{
+  return mHandle.promise().getResult();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+Task<T>::Task() : mHandle(nullptr)
+{
+}
+
+template <typename T>
+Task<T>::Task(Handle handle) : mHandle(handle)
+{
+}
+
+template <typename T>
+Task<T>::Task(Task&& other) noexcept :
+  mHandle(std::exchange(other.mHandle, nullptr))
+{
+}
+
+template <typename T>
+Task<T>&
+Task<T>::operator=(Task&& other) noexcept
+{
+  if (this != &other)
+  {
+    destroy();
+    mHandle = std::exchange(other.mHandle, nullptr);
+  }
+  else
+  {
+  }
+  return *this;
+}
+
+template <typename T>
+Task<T>::~Task()
+{
+  destroy();
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+typename Task<T>::Awaiter
+Task<T>::operator co_await() && noexcept
+{
+  return Awaiter(mHandle);
+}
+
+template <typename T>
+typename Task<T>::Handle
+Task<T>::getHandle() const
+{
+  return mHandle;
+}
+
+template <typename T>
+bool
+Task<T>::isDone() const
+{
+  return mHandle && mHandle.done();
+}
+
+template <typename T>
+T
+Task<T>::getResult()
+{
+  return mHandle.promise().getResult();
+}
+
+template <typename T>
+void
+Task<T>::destroy()
+{
+  if (mHandle)
+  {
+    mHandle.destroy();
+    mHandle = nullptr;
+  }
+  else
+  {
+  }
+}
+
+} // namespace coro
+
+} // namespace protest
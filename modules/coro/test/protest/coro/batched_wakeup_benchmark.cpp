@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "protest/coro/scheduler.h"
+#include "protest/coro/stack_allocator.h"
+#include "protest/coro/benchmark.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace protest::coro;
+using protest::benchmark::report;
+
+namespace
+{
+
+// every run does about the same number of wake ups
+constexpr size_t numberOfWakeups = 1000000u;
+
+// ---------------------------------------------------------------------------
+class PeriodicTask : public Coroutine
+{
+public:
+  explicit PeriodicTask(Scheduler& scheduler, size_t numberOfRounds) :
+    Coroutine(scheduler, StackAllocator::minimumStackSize),
+    mNumberOfRounds(numberOfRounds)
+  {
+  }
+
+  void
+  coroRun() override
+  {
+    // all tasks are due at the same time
+    for (size_t i = 0; i < mNumberOfRounds; i++)
+    {
+      coroWait(protest::time::Millisecond(10));
+    }
+    coroExit();
+  }
+
+private:
+  size_t mNumberOfRounds;
+};
+
+void
+runPeriodicTasks(size_t numberOfTasks, bool batchedWakeup)
+{
+  const size_t numberOfRounds = numberOfWakeups / numberOfTasks;
+
+  Scheduler scheduler;
+  scheduler.setBatchedWakeup(batchedWakeup);
+  std::vector<std::unique_ptr<PeriodicTask>> tasks;
+  tasks.reserve(numberOfTasks);
+  for (size_t i = 0; i < numberOfTasks; i++)
+  {
+    tasks.emplace_back(new PeriodicTask(scheduler, numberOfRounds));
+    scheduler.addThread(tasks.back().get());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  scheduler.run();
+  auto end = std::chrono::steady_clock::now();
+
+  const std::string name = std::string("periodic wake up (") +
+                           std::to_string(numberOfTasks) + " tasks, " +
+                           (batchedWakeup ? "batched" : "single") + ")";
+  report(name.c_str(), "wakeups", numberOfRounds * numberOfTasks,
+         end - start);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(coro_benchmark, periodic_wakeup_100_tasks)
+{
+  runPeriodicTasks(100, false);
+  runPeriodicTasks(100, true);
+}
+
+TEST(coro_benchmark, periodic_wakeup_1k_tasks)
+{
+  runPeriodicTasks(1000, false);
+  runPeriodicTasks(1000, true);
+}
+
+TEST(coro_benchmark, periodic_wakeup_10k_tasks)
+{
+  runPeriodicTasks(10000, false);
+  runPeriodicTasks(10000, true);
+}
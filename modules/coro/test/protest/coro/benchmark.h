@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace protest
+{
+
+namespace benchmark
+{
+
+// ---------------------------------------------------------------------------
+inline void
+report(const char* name,
+       const char* unit,
+       size_t count,
+       std::chrono::nanoseconds elapsed)
+{
+  const double seconds = static_cast<double>(elapsed.count()) / 1e9;
+  std::cout << "[ BENCH    ] " << name << ": " << count << " " << unit
+            << " in " << seconds << " s ("
+            << static_cast<uint64_t>(static_cast<double>(count) / seconds)
+            << " " << unit << "/s)" << std::endl;
+}
+
+} // namespace benchmark
+
+} // namespace protest
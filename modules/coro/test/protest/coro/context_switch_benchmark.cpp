@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include "protest/coro/scheduler.h"
+#include "protest/coro/stack_allocator.h"
+#include "protest/coro/benchmark.h"
+
+#include <chrono>
+#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+
+#include <ucontext.h>
+
+using namespace protest::coro;
+using protest::benchmark::report;
+
+static constexpr size_t numberOfSwitches = 2000000u;
+
+// ---------------------------------------------------------------------------
+// ping-pong between main and one coroutine using plain ucontext. This is the
+// reference for the posix port.
+static ucontext_t ucontextMain;
+static ucontext_t ucontextCoro;
+
+static void
+ucontextEntry()
+{
+  while (true)
+  {
+    swapcontext(&ucontextCoro, &ucontextMain);
+  }
+}
+
+TEST(coro_benchmark, ucontext_switches_per_second)
+{
+  getcontext(&ucontextCoro);
+  // NOLINTNEXTLINE
+  void* stack = malloc(CoroutineBase::defaultStackSize);
+  ucontextCoro.uc_link = nullptr;
+  ucontextCoro.uc_stack.ss_sp = stack;
+  ucontextCoro.uc_stack.ss_size = CoroutineBase::defaultStackSize;
+  makecontext(&ucontextCoro, ucontextEntry, 0);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < numberOfSwitches / 2; i++)
+  {
+    swapcontext(&ucontextMain, &ucontextCoro);
+  }
+  auto end = std::chrono::steady_clock::now();
+  report("ucontext", "switches", numberOfSwitches, end - start);
+
+  // NOLINTNEXTLINE
+  free(stack);
+}
+
+// ---------------------------------------------------------------------------
+// ping-pong between main and one coroutine using the configured port
+// (PROTEST_CORO_ARCH)
+TEST(coro_benchmark, port_switches_per_second)
+{
+  class PingPong : public CoroutineBase
+  {
+  public:
+    explicit PingPong(CoroContext* main, StackAllocator::Stack stack) :
+      CoroutineBase(main, stack.mBase, stack.mSize),
+      mMain(main)
+    {
+    }
+
+    void
+    coroRun() override
+    {
+      while (true)
+      {
+        swapContext(&mContext, mMain);
+      }
+    }
+
+    void
+    resume()
+    {
+      swapContext(mMain, &mContext);
+    }
+
+    CoroContext* mMain;
+  };
+
+  CoroutineBase::CoroContext main;
+  CoroutineBase::initialize(&main);
+  auto stack = StackAllocator::allocate(CoroutineBase::defaultStackSize);
+  PingPong coro(&main, stack);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < numberOfSwitches / 2; i++)
+  {
+    coro.resume();
+  }
+  auto end = std::chrono::steady_clock::now();
+  report("port", "switches", numberOfSwitches, end - start);
+
+  StackAllocator::release(stack);
+}
+
+// ---------------------------------------------------------------------------
+// two coroutines yielding to each other via the scheduler
+static void
+runYields(const char* name, bool directSwitching)
+{
+  class MyCoroutine : public Coroutine
+  {
+  public:
+    explicit MyCoroutine(Scheduler& scheduler) : Coroutine(scheduler)
+    {
+    }
+
+    void
+    coroRun() override
+    {
+      for (size_t i = 0; i < numberOfSwitches / 2; i++)
+      {
+        coroYield();
+      }
+      coroExit();
+    }
+  };
+
+  Scheduler scheduler;
+  scheduler.setDirectSwitching(directSwitching);
+  MyCoroutine coro1(scheduler);
+  MyCoroutine coro2(scheduler);
+  scheduler.addThread(&coro1);
+  scheduler.addThread(&coro2);
+
+  auto start = std::chrono::steady_clock::now();
+  scheduler.run();
+  auto end = std::chrono::steady_clock::now();
+  report(name, "yields", numberOfSwitches, end - start);
+}
+
+TEST(coro_benchmark, scheduler_yields_per_second)
+{
+  runYields("scheduler (via main)", false);
+}
+
+TEST(coro_benchmark, scheduler_direct_yields_per_second)
+{
+  runYields("scheduler (direct)", true);
+}
@@ -3,6 +3,8 @@
 #include "protest/coro/scheduler.h"
 #include "protest/time/time_point.h"
 
+#include <string>
+
 using namespace protest::coro;
 
 TEST(scheduler, should_run_without_coroutines)
@@ -135,3 +137,273 @@ TEST(scheduler, should_wait_0ms)
   ASSERT_TRUE(coro1.mReached);
   ASSERT_TRUE(endOfTime.milliseconds() == 0);
 }
+
+static std::string
+recordExecutionOrder(bool directSwitching)
+{
+  class MyCoroutine : public Coroutine
+  {
+  public:
+    MyCoroutine(Scheduler& scheduler, char name, std::string& trace) :
+      Coroutine(scheduler),
+      mName(name),
+      mTrace(trace)
+    {
+    }
+
+    void
+    coroRun()
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        mTrace += mName;
+        coroYield();
+        mTrace += mName;
+        coroWait(protest::time::Millisecond((mName - 'a' + 1) * 10));
+      }
+      coroExit();
+    }
+
+    char mName;
+    std::string& mTrace;
+  };
+
+  std::string trace;
+  Scheduler scheduler;
+  scheduler.setDirectSwitching(directSwitching);
+  MyCoroutine coro1(scheduler, 'a', trace);
+  MyCoroutine coro2(scheduler, 'b', trace);
+  MyCoroutine coro3(scheduler, 'c', trace);
+  scheduler.addThread(&coro1);
+  scheduler.addThread(&coro2);
+  scheduler.addThread(&coro3);
+  scheduler.run();
+  EXPECT_EQ(90, scheduler.now().milliseconds());
+  return trace;
+}
+
+TEST(scheduler, should_execute_in_same_order_with_and_without_direct_switch)
+{
+  const std::string direct = recordExecutionOrder(true);
+  const std::string indirect = recordExecutionOrder(false);
+  ASSERT_EQ(std::string("abcabcaabbaaccbbcc"), indirect);
+  ASSERT_EQ(indirect, direct);
+}
+
+static std::string
+recordWakeupOrder(bool batchedWakeup)
+{
+  class MyCoroutine : public Coroutine
+  {
+  public:
+    MyCoroutine(Scheduler& scheduler,
+                char name,
+                int64_t milliseconds,
+                std::string& trace) :
+      Coroutine(scheduler),
+      mName(name),
+      mMilliseconds(milliseconds),
+      mTrace(trace),
+      mOther(nullptr)
+    {
+    }
+
+    void
+    coroRun()
+    {
+      if (mMilliseconds > 0)
+      {
+        coroWait(protest::time::Millisecond(mMilliseconds));
+      }
+      else
+      {
+      }
+      mTrace += mName;
+      if (mOther != nullptr && mOther->isWaiting())
+      {
+        mOther->coroWakeup();
+      }
+      else
+      {
+      }
+      coroExit();
+    }
+
+    char mName;
+    int64_t mMilliseconds;
+    std::string& mTrace;
+    Coroutine* mOther;
+  };
+
+  std::string trace;
+  Scheduler scheduler;
+  scheduler.setBatchedWakeup(batchedWakeup);
+  // a, c, e, g and h sleep until 50 ms, b, d and f until 60 ms
+  MyCoroutine a(scheduler, 'a', 50, trace);
+  MyCoroutine b(scheduler, 'b', 60, trace);
+  MyCoroutine c(scheduler, 'c', 50, trace);
+  MyCoroutine d(scheduler, 'd', 60, trace);
+  MyCoroutine e(scheduler, 'e', 50, trace);
+  MyCoroutine f(scheduler, 'f', 60, trace);
+  MyCoroutine g(scheduler, 'g', 50, trace);
+  MyCoroutine h(scheduler, 'h', 50, trace);
+  MyCoroutine y(scheduler, 'y', 0, trace);
+  // y wakes up g before it is due, a wakes up e which is due at the same
+  // time, c wakes up f which sleeps longer
+  y.mOther = &g;
+  a.mOther = &e;
+  c.mOther = &f;
+  for (auto* coroutine : {&a, &b, &c, &d, &e, &f, &g, &h, &y})
+  {
+    scheduler.addThread(coroutine);
+  }
+  scheduler.run();
+  EXPECT_EQ(60, scheduler.now().milliseconds());
+  return trace;
+}
+
+TEST(scheduler, should_wake_up_in_the_order_of_going_to_sleep)
+{
+  const std::string batched = recordWakeupOrder(true);
+  const std::string single = recordWakeupOrder(false);
+  ASSERT_EQ(std::string("ygaecfhbd"), batched);
+  ASSERT_EQ(batched, single);
+}
+
+static std::string
+recordMixedExecutionOrder(bool directSwitching)
+{
+  class Stackful : public Coroutine
+  {
+  public:
+    Stackful(Scheduler& scheduler, std::string& trace) :
+      Coroutine(scheduler),
+      mTrace(trace)
+    {
+    }
+
+    void
+    coroRun()
+    {
+      mTrace += "a";
+      coroYield();
+      mTrace += "a";
+      coroWait(protest::time::Millisecond(10));
+      mTrace += "a";
+      coroExit();
+    }
+
+    std::string& mTrace;
+  };
+
+  // a hand-written state machine instead of a C++20 coroutine
+  class Stackless : public Coroutine
+  {
+  public:
+    Stackless(Scheduler& scheduler, char name, std::string& trace) :
+      Coroutine(scheduler, stackless),
+      mName(name),
+      mTrace(trace),
+      mState(0)
+    {
+    }
+
+    void
+    coroRun()
+    {
+    }
+
+    void
+    coroResume() override
+    {
+      mTrace += mName;
+      switch (mState++)
+      {
+        case 0:
+          mScheduler.yield(this);
+          break;
+        case 1:
+          prepareWait(protest::time::Millisecond(10));
+          mScheduler.sleep(this, protest::time::Millisecond(10));
+          break;
+        default:
+          completeWait();
+          mScheduler.exit(this);
+          break;
+      }
+    }
+
+    char mName;
+    std::string& mTrace;
+    int mState;
+  };
+
+  std::string trace;
+  Scheduler scheduler;
+  scheduler.setDirectSwitching(directSwitching);
+  Stackful a(scheduler, trace);
+  Stackless b(scheduler, 'b', trace);
+  Stackless c(scheduler, 'c', trace);
+  EXPECT_TRUE(b.isStackless());
+  EXPECT_FALSE(a.isStackless());
+  scheduler.addThread(&a);
+  scheduler.addThread(&b);
+  scheduler.addThread(&c);
+  scheduler.run();
+  EXPECT_EQ(10, scheduler.now().milliseconds());
+  return trace;
+}
+
+TEST(scheduler, should_resume_stackless_coroutines)
+{
+  const std::string direct = recordMixedExecutionOrder(true);
+  const std::string indirect = recordMixedExecutionOrder(false);
+  ASSERT_EQ(std::string("abcabcabc"), indirect);
+  ASSERT_EQ(indirect, direct);
+}
+
+TEST(scheduler, should_count_switches_if_instrumented)
+{
+  class MyCoroutine : public Coroutine
+  {
+  public:
+    MyCoroutine(Scheduler& scheduler) : Coroutine(scheduler)
+    {
+    }
+
+    void
+    coroRun()
+    {
+      coroYield();
+      coroWait(protest::time::Millisecond(10));
+      coroExit();
+    }
+  };
+
+  Scheduler scheduler;
+  MyCoroutine coro1(scheduler);
+  MyCoroutine coro2(scheduler);
+  scheduler.addThread(&coro1);
+  scheduler.addThread(&coro2);
+  scheduler.run();
+
+  const auto& statistics = scheduler.getStatistics();
+  if (isInstrumentationEnabled)
+  {
+    ASSERT_EQ(2u, statistics.mNumberOfYields);
+    ASSERT_EQ(2u, statistics.mNumberOfSleeps);
+    ASSERT_EQ(0u, statistics.mNumberOfWakeups);
+    ASSERT_EQ(2u, statistics.mMaxRunQueueDepth);
+    ASSERT_EQ(2u, statistics.mMaxSleepQueueDepth);
+    ASSERT_EQ(0u, statistics.mRunQueueDepth);
+    ASSERT_EQ(0u, statistics.mSleepQueueDepth);
+    ASSERT_EQ(1u, coro1.getStatistics().mNumberOfYields);
+    ASSERT_GT(coro1.getStatistics().mNumberOfSwitches, 0u);
+    ASSERT_GT(statistics.mNumberOfSwitches, 0u);
+  }
+  else
+  {
+    ASSERT_EQ(0u, statistics.mNumberOfSwitches);
+    ASSERT_EQ(0u, coro1.getStatistics().mNumberOfSwitches);
+  }
+}
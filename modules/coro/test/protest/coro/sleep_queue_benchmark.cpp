@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "protest/coro/scheduler.h"
+#include "protest/coro/stack_allocator.h"
+#include "protest/coro/benchmark.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace protest::coro;
+using protest::benchmark::report;
+
+// every run does about the same number of sleeps, so the time per sleep
+// shows how the sleep queue scales with the number of sleeping coroutines
+static constexpr size_t numberOfSleeps = 1000000u;
+
+// ---------------------------------------------------------------------------
+class Sleeper : public Coroutine
+{
+public:
+  explicit Sleeper(Scheduler& scheduler, size_t id, size_t numberOfRounds) :
+    Coroutine(scheduler, StackAllocator::minimumStackSize),
+    mId(id),
+    mNumberOfRounds(numberOfRounds)
+  {
+  }
+
+  void
+  coroRun() override
+  {
+    for (size_t i = 0; i < mNumberOfRounds; i++)
+    {
+      // pseudo random but deterministic sleep times between 1 and 1000 us
+      const int64_t us = static_cast<int64_t>(((mId + i) * 7919u) % 1000u) + 1;
+      coroWait(protest::time::Microseconds(us));
+    }
+    coroExit();
+  }
+
+private:
+  size_t mId;
+  size_t mNumberOfRounds;
+};
+
+static void
+runSleepers(size_t numberOfCoroutines)
+{
+  const size_t numberOfRounds = numberOfSleeps / numberOfCoroutines;
+
+  Scheduler scheduler;
+  std::vector<std::unique_ptr<Sleeper>> sleepers;
+  sleepers.reserve(numberOfCoroutines);
+  for (size_t i = 0; i < numberOfCoroutines; i++)
+  {
+    sleepers.emplace_back(new Sleeper(scheduler, i, numberOfRounds));
+    scheduler.addThread(sleepers.back().get());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  scheduler.run();
+  auto end = std::chrono::steady_clock::now();
+
+  const std::string name =
+      "sleep queue (" + std::to_string(numberOfCoroutines) + " coroutines)";
+  report(name.c_str(), "sleeps", numberOfRounds * numberOfCoroutines,
+         end - start);
+}
+
+// ---------------------------------------------------------------------------
+TEST(coro_benchmark, sleep_queue_10_coroutines)
+{
+  runSleepers(10);
+}
+
+TEST(coro_benchmark, sleep_queue_1k_coroutines)
+{
+  runSleepers(1000);
+}
+
+TEST(coro_benchmark, sleep_queue_100k_coroutines)
+{
+  runSleepers(100000);
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include "protest/coro/scheduler.h"
+#include "protest/coro/stack_allocator.h"
+
+#include <cstdint>
+
+using namespace protest::coro;
+
+TEST(stack_allocator, should_round_up_to_pages)
+{
+  StackAllocator::trim();
+  const size_t pageSize = StackAllocator::getPageSize();
+
+  auto stack = StackAllocator::allocate(StackAllocator::minimumStackSize + 1);
+  ASSERT_NE(nullptr, stack.mBase);
+  ASSERT_EQ(0u, stack.mSize % pageSize);
+  ASSERT_EQ(StackAllocator::minimumStackSize + pageSize, stack.mSize);
+  ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(stack.mBase) % pageSize);
+
+  auto small = StackAllocator::allocate(1);
+  ASSERT_EQ(StackAllocator::minimumStackSize, small.mSize);
+
+  StackAllocator::release(stack);
+  StackAllocator::release(small);
+  StackAllocator::trim();
+}
+
+TEST(stack_allocator, should_reuse_released_stacks_of_same_size)
+{
+  StackAllocator::trim();
+  auto stack1 = StackAllocator::allocate(1024 * 32);
+  auto stack2 = StackAllocator::allocate(1024 * 64);
+  StackAllocator::release(stack1);
+  StackAllocator::release(stack2);
+  ASSERT_EQ(2u, StackAllocator::getNumberOfCachedStacks());
+
+  auto stack3 = StackAllocator::allocate(1024 * 64);
+  ASSERT_EQ(stack2.mBase, stack3.mBase);
+  auto stack4 = StackAllocator::allocate(1024 * 48);
+  ASSERT_NE(stack1.mBase, stack4.mBase);
+  auto stack5 = StackAllocator::allocate(1024 * 32);
+  ASSERT_EQ(stack1.mBase, stack5.mBase);
+  ASSERT_EQ(0u, StackAllocator::getNumberOfCachedStacks());
+
+  StackAllocator::release(stack3);
+  StackAllocator::release(stack4);
+  StackAllocator::release(stack5);
+  StackAllocator::trim();
+  ASSERT_EQ(0u, StackAllocator::getNumberOfCachedStacks());
+}
+
+TEST(stack_allocator, should_hand_out_stacks_in_lifo_order)
+{
+  StackAllocator::trim();
+  auto stack1 = StackAllocator::allocate(1024 * 32);
+  auto stack2 = StackAllocator::allocate(1024 * 32);
+  StackAllocator::release(stack1);
+  StackAllocator::release(stack2);
+
+  ASSERT_EQ(stack2.mBase, StackAllocator::allocate(1024 * 32).mBase);
+  ASSERT_EQ(stack1.mBase, StackAllocator::allocate(1024 * 32).mBase);
+
+  StackAllocator::release(stack1);
+  StackAllocator::release(stack2);
+  StackAllocator::trim();
+}
+
+TEST(stack_allocator, should_fault_on_guard_page)
+{
+  auto stack = StackAllocator::allocate(StackAllocator::minimumStackSize);
+  auto* guard = static_cast<volatile char*>(stack.mBase) - 1;
+  ASSERT_DEATH({ *guard = 0; }, "");
+  StackAllocator::release(stack);
+}
+
+TEST(stack_allocator, should_run_coroutine_with_custom_stack_size)
+{
+  class MyCoroutine : public Coroutine
+  {
+  public:
+    MyCoroutine(Scheduler& scheduler) :
+      Coroutine(scheduler, 1024 * 256),
+      mReached(false)
+    {
+    }
+
+    void
+    coroRun() override
+    {
+      // use more than the default stack size
+      volatile char buffer[1024 * 128];
+      buffer[0] = 1;
+      buffer[sizeof(buffer) - 1] = 1;
+      mReached = (buffer[0] == buffer[sizeof(buffer) - 1]);
+      coroExit();
+    }
+
+    bool mReached;
+  };
+
+  Scheduler scheduler;
+  MyCoroutine coro(scheduler);
+  ASSERT_EQ(1024u * 256u, coro.getStackSize());
+  scheduler.addThread(&coro);
+  scheduler.run();
+  ASSERT_TRUE(coro.mReached);
+}
+
+TEST(stack_allocator, should_measure_usage_of_painted_stack)
+{
+  auto stack = StackAllocator::allocate(StackAllocator::minimumStackSize);
+  StackAllocator::paint(stack);
+  ASSERT_EQ(0u, StackAllocator::getUsage(stack));
+
+  // the stack grows downwards -> touch the topmost 1000 bytes
+  auto* top = static_cast<char*>(stack.mBase) + stack.mSize;
+  for (size_t i = 1; i <= 1000; i++)
+  {
+    *(top - i) = 0;
+  }
+  ASSERT_EQ(1000u, StackAllocator::getUsage(stack));
+
+  *static_cast<char*>(stack.mBase) = 0;
+  ASSERT_EQ(stack.mSize, StackAllocator::getUsage(stack));
+  StackAllocator::release(stack);
+}
+
+template <size_t N>
+class BufferCoroutine : public Coroutine
+{
+public:
+  BufferCoroutine(Scheduler& scheduler) : Coroutine(scheduler)
+  {
+  }
+
+  void
+  coroRun() override
+  {
+    char buffer[N];
+    // written through a volatile pointer, so the stores are not removed
+    volatile char* sink = buffer;
+    for (size_t i = 0; i < N; i++)
+    {
+      sink[i] = 1;
+    }
+    coroExit();
+  }
+};
+
+TEST(stack_allocator, should_report_peak_stack_usage_of_coroutine)
+{
+  Scheduler scheduler;
+  BufferCoroutine<1024> unpainted(scheduler);
+  scheduler.setStackPainting(true);
+  BufferCoroutine<1024> small(scheduler);
+  BufferCoroutine<1024 * 20> large(scheduler);
+  ASSERT_FALSE(unpainted.isStackPainted());
+  ASSERT_TRUE(large.isStackPainted());
+  scheduler.addThread(&unpainted);
+  scheduler.addThread(&small);
+  scheduler.addThread(&large);
+  scheduler.run();
+
+  ASSERT_EQ(0u, unpainted.getStackUsage());
+  ASSERT_GT(small.getStackUsage(), 1024u);
+  ASSERT_GT(large.getStackUsage(), 1024u * 20u);
+  ASSERT_LT(large.getStackUsage(), large.getStackSize());
+  ASSERT_LT(small.getStackUsage(), large.getStackUsage());
+}
@@ -328,6 +328,51 @@ DocManager::printPostamble()
   {
   }
 
+  const auto stackUsage = mContext.getStackUsage();
+  if (!stackUsage.empty())
+  {
+    auto stream = mLogger.startLog("    ", "    ");
+    printSeperator();
+    stream.operator std::ostream&()
+        << "* STACK USAGE (PEAK / SIZE IN BYTES):\n";
+
+    for (const auto& usage : stackUsage)
+    {
+      std::stringstream strstream;
+      strstream << "* " << std::left << std::setw(maxLengthOfKeyHeader)
+                << usage.mName << std::right << std::setw(maxLengthOfKey)
+                << usage.mPeak << " / " << std::setw(maxLengthOfKey)
+                << usage.mSize
+                << (usage.mPeak >= usage.mSize ? "  EXHAUSTED" : "") << "\n";
+      stream.operator std::ostream&() << strstream.str();
+    }
+  }
+  else
+  {
+  }
+
+  const auto queueOverflows = mContext.getQueueOverflows();
+  if (!queueOverflows.empty())
+  {
+    auto stream = mLogger.startLog("    ", "    ");
+    printSeperator();
+    stream.operator std::ostream&()
+        << "* QUEUE OVERFLOWS (DROPPED / BLOCKED VALUES):\n";
+
+    for (const auto& overflow : queueOverflows)
+    {
+      std::stringstream strstream;
+      strstream << "* " << std::left << std::setw(maxLengthOfKeyHeader)
+                << overflow.mName << std::right << std::setw(maxLengthOfKey)
+                << overflow.mDropped << " / " << std::setw(maxLengthOfKey)
+                << overflow.mBlocked << "\n";
+      stream.operator std::ostream&() << strstream.str();
+    }
+  }
+  else
+  {
+  }
+
   const bool notTested = (mTestManager.getNumberOfPassedAssertions() == 0 &&
                           mTestManager.getNumberOfFailedAssertions() == 0) &&
                          (mTestManager.getNumberOfPassedInvariants() == 0 &&
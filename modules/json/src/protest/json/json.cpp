@@ -187,3 +187,11 @@ JsonParser::getValue()
   auto* json = reinterpret_cast<nlohmann::json*>(mHandle);
   return Value(mHandle);
 }
+
+// ---------------------------------------------------------------------------
+std::string
+protest::json::quote(const std::string& string)
+{
+  return nlohmann::json(string).dump(
+      -1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
@@ -207,6 +207,17 @@ private:
   void* mHandle;
 };
 
+// ---------------------------------------------------------------------------
+/**
+ * @brief quote
+ * 
+ * @return
+ *  the string as JSON string literal: in quotes, with escaped special
+ *  characters. Invalid UTF-8 sequences are replaced.
+ */
+std::string
+quote(const std::string& string);
+
 } // namespace json
 
 } // namespace protest
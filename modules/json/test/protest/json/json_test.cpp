@@ -94,3 +94,9 @@ TEST(json, should_return_array)
   ASSERT_EQ(array.numberOfElements(), 4);
   ASSERT_TRUE(first.isInteger());
 }
+
+TEST(json, should_quote_strings)
+{
+  ASSERT_EQ("\"name\"", protest::json::quote("name"));
+  ASSERT_EQ("\"a\\\"b\\\\c\\n\"", protest::json::quote("a\"b\\c\n"));
+}
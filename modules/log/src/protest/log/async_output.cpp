@@ -0,0 +1,159 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/log/async_output.h"
+
+#include <cassert>
+
+using namespace protest::log;
+
+// ---------------------------------------------------------------------------
+AsyncOutput::AsyncOutput(std::ostream& target,
+                         size_t chunkSize,
+                         size_t maxPendingChunks) :
+  mTarget(target),
+  mChunkSize(chunkSize),
+  mMaxPendingChunks(maxPendingChunks),
+  mChunk(chunkSize),
+  mIsWriting(false),
+  mIsDone(false),
+  mStream(this),
+  mWriter([this]() { write(); })
+{
+  assert(chunkSize > 0);
+  assert(maxPendingChunks > 0);
+  setp(mChunk.data(), mChunk.data() + mChunk.size());
+}
+
+AsyncOutput::~AsyncOutput()
+{
+  handOver();
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mIsDone = true;
+  }
+  mHasChunks.notify_one();
+  mWriter.join();
+}
+
+// ---------------------------------------------------------------------------
+std::ostream&
+AsyncOutput::getStream()
+{
+  return mStream;
+}
+
+void
+AsyncOutput::waitUntilWritten()
+{
+  handOver();
+  std::unique_lock<std::mutex> lock(mMutex);
+  mHasWritten.wait(lock,
+                   [&]() { return mPendingChunks.empty() && !mIsWriting; });
+}
+
+// ---------------------------------------------------------------------------
+std::streambuf::int_type
+AsyncOutput::overflow(std::streambuf::int_type character)
+{
+  handOver();
+  if (character != traits_type::eof())
+  {
+    *pptr() = static_cast<char>(character);
+    pbump(1);
+  }
+  else
+  {
+  }
+  return traits_type::not_eof(character);
+}
+
+int
+AsyncOutput::sync()
+{
+  handOver();
+  return 0;
+}
+
+void
+AsyncOutput::handOver()
+{
+  const auto size = static_cast<size_t>(pptr() - pbase());
+  if (size > 0)
+  {
+    mChunk.resize(size);
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mHasWritten.wait(
+          lock, [&]() { return mPendingChunks.size() < mMaxPendingChunks; });
+      mPendingChunks.push_back(std::move(mChunk));
+      if (!mFreeChunks.empty())
+      {
+        mChunk = std::move(mFreeChunks.back());
+        mFreeChunks.pop_back();
+      }
+      else
+      {
+        mChunk = std::vector<char>();
+      }
+    }
+    mHasChunks.notify_one();
+
+    mChunk.resize(mChunkSize);
+    setp(mChunk.data(), mChunk.data() + mChunk.size());
+  }
+  else
+  {
+  }
+}
+
+void
+AsyncOutput::write()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true)
+  {
+    mHasChunks.wait(lock,
+                    [&]() { return mIsDone || !mPendingChunks.empty(); });
+    if (mPendingChunks.empty())
+    {
+      // done and everything is written
+      break;
+    }
+    else
+    {
+    }
+
+    std::vector<char> chunk = std::move(mPendingChunks.front());
+    mPendingChunks.pop_front();
+    mIsWriting = true;
+    lock.unlock();
+    mTarget.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    mTarget.flush();
+    lock.lock();
+    mIsWriting = false;
+    mFreeChunks.push_back(std::move(chunk));
+    mHasWritten.notify_all();
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace protest
+{
+
+namespace log
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class AsyncOutput
+ * 
+ * An output stream which is written to its target by a background thread.
+ * The written characters are collected in chunks. A filled chunk is handed
+ * over to the writer thread, so the writing thread does not wait for the
+ * terminal, a pipe or a file. It only waits if the writer falls behind by
+ * more than maxPendingChunks chunks. The chunks are written in the order
+ * they were filled, so the output is the same as if it was written to the
+ * target directly.
+ * 
+ * Usage: Logger::setOutput(asyncOutput.getStream())
+ * 
+ * The stream must only be written by one thread at a time.
+ */
+class AsyncOutput : public std::streambuf
+{
+public:
+  static constexpr size_t defaultChunkSize = 64U * 1024U;
+  static constexpr size_t defaultMaxPendingChunks = 256U;
+
+  explicit AsyncOutput(std::ostream& target,
+                       size_t chunkSize = defaultChunkSize,
+                       size_t maxPendingChunks = defaultMaxPendingChunks);
+
+  AsyncOutput(const AsyncOutput& other) = delete;
+
+  AsyncOutput(AsyncOutput&& other) = delete;
+
+  AsyncOutput&
+  operator=(const AsyncOutput& other) = delete;
+
+  AsyncOutput&
+  operator=(AsyncOutput&& other) = delete;
+
+  /**
+   * @brief ~AsyncOutput
+   * 
+   * writes the remaining output and stops the writer thread.
+   */
+  ~AsyncOutput() override;
+
+// ---------------------------------------------------------------------------
+  std::ostream&
+  getStream();
+
+  /**
+   * @brief waitUntilWritten
+   * 
+   * blocks until everything written so far has been written to the target.
+   * Flushing the stream only hands over the current chunk.
+   */
+  void
+  waitUntilWritten();
+
+private:
+  int_type
+  overflow(int_type character) override;
+
+  int
+  sync() override;
+
+  void
+  handOver();
+
+  void
+  write();
+
+  std::ostream& mTarget;
+  size_t mChunkSize;
+  size_t mMaxPendingChunks;
+  std::vector<char> mChunk;
+  std::mutex mMutex;
+  std::condition_variable mHasChunks;
+  std::condition_variable mHasWritten;
+  std::deque<std::vector<char>> mPendingChunks;
+  // written chunks are reused to avoid allocations
+  std::vector<std::vector<char>> mFreeChunks;
+  bool mIsWriting;
+  bool mIsDone;
+  std::ostream mStream;
+  std::thread mWriter;
+};
+
+} // namespace log
+
+} // namespace protest
@@ -23,16 +23,41 @@
  */
 
 #include "protest/log/logger.h"
+#include "protest/log/trace_writer.h"
+
+#include <array>
+#include <iostream>
 
 #include <cstring>
 
 using namespace protest::log;
 using namespace protest::time;
 
+namespace
+{
+
+// continuation lines are aligned with the text following the log header
+constexpr auto globalIndentation = []()
+{
+  std::array<char, Logger::totalOffsetSize + 1> indentation{};
+  indentation.fill(' ');
+  return indentation;
+}();
+
+} // namespace
+
 // ---------------------------------------------------------------------------
-// TODO (jreinking) should not be global
 // NOLINTNEXTLINE
-bool Logger::globalLastIsNewline = true;
+std::atomic<uint64_t> Logger::globalNumberOfLoggers(0);
+
+// NOLINTNEXTLINE
+thread_local bool Logger::globalLastIsNewline = true;
+
+// NOLINTNEXTLINE
+thread_local std::ostream* Logger::globalOutput = &std::cout;
+
+// NOLINTNEXTLINE
+thread_local TraceWriter* Logger::globalTrace = nullptr;
 
 // ---------------------------------------------------------------------------
 StreamWrapper::StreamWrapper(std::ostream& stream) : mStream(stream)
@@ -56,12 +81,69 @@ Logger::Logger() :
   mStream(this),
   mUserStream(mStream),
   mNullStream(mNullStreamImpl),
-  mLastIsNewline(true)
+  mLastIsNewline(true),
+  mId(globalNumberOfLoggers++)
 {
   ::memset(&mBuffer[0], 0, bufferSize);
   setp(&mBuffer[0], &mBuffer[sizeof(mBuffer) - 1]);
 }
 
+// ---------------------------------------------------------------------------
+void
+Logger::setOutput(std::ostream& output)
+{
+  globalOutput = &output;
+}
+
+std::ostream&
+Logger::getOutput()
+{
+  return *globalOutput;
+}
+
+void
+Logger::finishLine()
+{
+  if (globalTrace != nullptr)
+  {
+    globalTrace->finishLine();
+  }
+  else if (!globalLastIsNewline)
+  {
+    *globalOutput << "\n";
+    globalLastIsNewline = true;
+  }
+  else
+  {
+  }
+}
+
+void
+Logger::setTrace(TraceWriter* trace)
+{
+  finishLine();
+  globalTrace = trace;
+}
+
+TraceWriter*
+Logger::getTrace()
+{
+  return globalTrace;
+}
+
+void
+Logger::writeText(const std::string& text)
+{
+  if (globalTrace != nullptr)
+  {
+    globalTrace->writeText(text.data(), text.size());
+  }
+  else
+  {
+    *globalOutput << text;
+  }
+}
+
 // ---------------------------------------------------------------------------
 StreamWrapper
 Logger::startLog(const char* tag,
@@ -71,17 +153,24 @@ Logger::startLog(const char* tag,
                  protest::time::TimePoint now)
 {
   flush();
-  if (!globalLastIsNewline)
+  if (globalTrace != nullptr)
   {
-    mStream << "\n";
+    globalTrace->start(mId, tag, name, file, line, now);
+  }
+  else
+  {
+    if (!globalLastIsNewline)
+    {
+      mStream << "\n";
+    }
+    flush();
+    // assert(mLastIsNewline);
+    mStatus = Status::normal;
+    mStream << tag << " " << std::setw(timestampSize) << std::setfill('0')
+            << now.milliseconds() << " "
+            << " " << std::setw(nameSize) << std::setfill(' ') << name << " "
+            << file << ":" << line << std::endl;
   }
-  flush();
-  // assert(mLastIsNewline);
-  mStatus = Status::normal;
-  mStream << tag << " " << std::setw(timestampSize) << std::setfill('0')
-          << now.milliseconds() << " "
-          << " " << std::setw(nameSize) << std::setfill(' ') << name << " "
-          << file << ":" << line << std::endl;
   return StreamWrapper(mStream);
 }
 
@@ -91,16 +180,23 @@ Logger::startLog(const char* tag,
                  protest::time::TimePoint now)
 {
   flush();
-  if (!globalLastIsNewline)
+  if (globalTrace != nullptr)
   {
-    mStream << "\n";
+    globalTrace->start(mId, tag, name, now);
+  }
+  else
+  {
+    if (!globalLastIsNewline)
+    {
+      mStream << "\n";
+    }
+    flush();
+    // assert(mLastIsNewline);
+    mStatus = Status::normal;
+    mStream << tag << " " << std::setw(timestampSize) << std::setfill('0')
+            << now.milliseconds() << " "
+            << " " << std::setw(nameSize) << std::setfill(' ') << name << " ";
   }
-  flush();
-  // assert(mLastIsNewline);
-  mStatus = Status::normal;
-  mStream << tag << " " << std::setw(timestampSize) << std::setfill('0')
-          << now.milliseconds() << " "
-          << " " << std::setw(nameSize) << std::setfill(' ') << name << " ";
   return StreamWrapper(mStream);
 }
 
@@ -108,16 +204,24 @@ StreamWrapper
 Logger::startLog(const char* tag, const char* name)
 {
   flush();
-  if (!globalLastIsNewline)
+  if (globalTrace != nullptr)
   {
-    mStream << "\n";
+    globalTrace->start(mId, tag, name);
+  }
+  else
+  {
+    if (!globalLastIsNewline)
+    {
+      mStream << "\n";
+    }
+    flush();
+    // assert(mLastIsNewline);
+    mStatus = Status::normal;
+    mStream << tag << " " << std::setw(timestampSize) << std::setfill(' ')
+            << " "
+            << " "
+            << " " << std::setw(nameSize) << std::setfill(' ') << name << " ";
   }
-  flush();
-  // assert(mLastIsNewline);
-  mStatus = Status::normal;
-  mStream << tag << " " << std::setw(timestampSize) << std::setfill(' ') << " "
-          << " "
-          << " " << std::setw(nameSize) << std::setfill(' ') << name << " ";
   return StreamWrapper(mStream);
 }
 
@@ -133,6 +237,13 @@ Logger::getNullStream()
   return mNullStream;
 }
 
+void
+Logger::write(const char* data, size_t size)
+{
+  mStream.write(data, static_cast<std::streamsize>(size));
+  flush();
+}
+
 void
 Logger::flush()
 {
@@ -177,39 +288,57 @@ Logger::sync()
 void
 Logger::writeToCOut()
 {
-  static bool newline = false;
-  auto* iter = pbase();
-  while (iter != pptr())
+  std::ostream& output = *globalOutput;
+  const char* iter = pbase();
+  const char* end = pptr();
+  if (globalTrace != nullptr && iter != end)
+  {
+    globalTrace->write(mId, iter, static_cast<size_t>(end - iter));
+    iter = end;
+  }
+  else
+  {
+  }
+  while (iter != end)
   {
     if (mLastIsNewline && mStatus == Status::indent)
     {
-      for (int i = 0; i <= totalOffsetSize; i++)
-      {
-        std::cout << " ";
-      }
+      output.write(globalIndentation.data(), globalIndentation.size());
     }
     else
     {
     }
 
-    if (*iter == '\n')
+    // write everything up to and including the next newline at once
+    const auto* newline = static_cast<const char*>(
+        ::memchr(iter, '\n', static_cast<size_t>(end - iter)));
+    const char* last = (newline != nullptr) ? newline + 1 : end;
+    output.write(iter, last - iter);
+    if (newline != nullptr)
     {
       mStatus = Status::indent;
       mLastIsNewline = true;
       globalLastIsNewline = true;
-      // assert(!newline);
-      newline = true;
     }
     else
     {
       globalLastIsNewline = false;
       mLastIsNewline = false;
-      newline = false;
     }
-
-    std::cout.write(iter, 1);
-    iter++;
+    iter = last;
   }
   // NOLINTNEXTLINE
   pbump(pbase() - pptr());
 }
+
+// ---------------------------------------------------------------------------
+OutputScope::OutputScope(std::ostream& output) :
+  mPrevious(Logger::getOutput())
+{
+  Logger::setOutput(output);
+}
+
+OutputScope::~OutputScope()
+{
+  Logger::setOutput(mPrevious);
+}
@@ -27,8 +27,11 @@
 #include "protest/time/time_point.h"
 #include "protest/log/operator.h"
 
+#include <atomic>
 #include <iomanip>
+#include <string>
 
+#include <cstdint>
 #include <cstdio>
 #include <cassert>
 
@@ -39,6 +42,7 @@ namespace log
 {
 
 class Logger;
+class TraceWriter;
 
 // ---------------------------------------------------------------------------
 /**
@@ -104,6 +108,11 @@ operator<<(StreamWrapper&& wrapper, const T&& value)
 // ---------------------------------------------------------------------------
 /**
  * @class Logger
+ * 
+ * All loggers of a thread write to the same output (std::cout by default).
+ * The output and the state of the last written line are stored per thread,
+ * so contexts running on different threads do not interfere. Instead of
+ * the text output a binary trace can be written (see setTrace).
  */
 class Logger : public std::streambuf
 {
@@ -128,6 +137,55 @@ public:
 
   ~Logger() = default;
 
+// ---------------------------------------------------------------------------
+  /**
+   * @brief setOutput
+   * 
+   * Sets the output of all loggers of the calling thread.
+   * 
+   * @param output
+   *  the stream to write to. It must outlive the loggers writing to it.
+   */
+  static void
+  setOutput(std::ostream& output);
+
+  static std::ostream&
+  getOutput();
+
+  /**
+   * @brief finishLine
+   * 
+   * terminates the current line of the output of the calling thread, so the
+   * output can be appended to the output of another thread.
+   */
+  static void
+  finishLine();
+
+  /**
+   * @brief setTrace
+   * 
+   * the loggers of the calling thread write their entries to the trace
+   * instead of the output until the trace is reset with nullptr. The
+   * current line of the output is terminated before.
+   * 
+   * @param trace
+   *  the trace to write to. It must outlive the loggers writing to it.
+   */
+  static void
+  setTrace(TraceWriter* trace);
+
+  static TraceWriter*
+  getTrace();
+
+  /**
+   * @brief writeText
+   * 
+   * writes text without header and indentation to the output of the
+   * calling thread, or to its trace.
+   */
+  static void
+  writeText(const std::string& text);
+
 // ---------------------------------------------------------------------------
   StreamWrapper
   startLog(const char* tag,
@@ -148,6 +206,15 @@ public:
   UniversalStream&
   getNullStream();
 
+  /**
+   * @brief write
+   * 
+   * appends characters to the current entry. Continuation lines are
+   * indented like the ones streamed to getStream.
+   */
+  void
+  write(const char* data, size_t size);
+
   void
   flush();
 
@@ -213,7 +280,41 @@ public:// TODO
   UniversalStream mNullStream;
   NullOStream mNullStreamImpl;
   bool mLastIsNewline;
-  static bool globalLastIsNewline;
+  // identifies the logger in a trace
+  uint64_t mId;
+  static std::atomic<uint64_t> globalNumberOfLoggers;
+  static thread_local bool globalLastIsNewline;
+  static thread_local std::ostream* globalOutput;
+  static thread_local TraceWriter* globalTrace;
+};
+
+// ---------------------------------------------------------------------------
+/**
+ * @class OutputScope
+ * 
+ * Sets the output of the loggers of the calling thread (see
+ * Logger::setOutput) and restores the previous one when the scope is left,
+ * also by an exception or a failed test assertion.
+ */
+class OutputScope
+{
+public:
+  explicit OutputScope(std::ostream& output);
+
+  OutputScope(const OutputScope& other) = delete;
+
+  OutputScope(OutputScope&& other) = delete;
+
+  OutputScope&
+  operator=(const OutputScope& other) = delete;
+
+  OutputScope&
+  operator=(OutputScope&& other) = delete;
+
+  ~OutputScope();
+
+private:
+  std::ostream& mPrevious;
 };
 
 } // namespace log
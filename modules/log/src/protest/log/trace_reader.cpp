@@ -0,0 +1,227 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/log/trace_reader.h"
+#include "protest/log/trace_writer.h"
+#include "protest/time/duration.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace protest::log;
+using namespace protest::time;
+
+// ---------------------------------------------------------------------------
+TraceReader::TraceReader(std::istream& input) : mInput(input)
+{
+}
+
+// ---------------------------------------------------------------------------
+bool
+TraceReader::render(std::ostream& output)
+{
+  assert(Logger::getTrace() == nullptr);
+  Logger::finishLine();
+  std::ostream& previous = Logger::getOutput();
+  Logger::setOutput(output);
+
+  bool isValid = readHeader();
+  while (isValid && mInput.peek() != std::istream::traits_type::eof())
+  {
+    isValid = readEvent(output);
+  }
+
+  Logger::setOutput(previous);
+  return isValid;
+}
+
+// ---------------------------------------------------------------------------
+bool
+TraceReader::readHeader()
+{
+  uint64_t version = 0;
+  const bool isValid = readBytes(mBytes, TraceWriter::magicSize) &&
+                       mBytes == TraceWriter::magic && readNumber(version);
+  return isValid && version == TraceWriter::version;
+}
+
+bool
+TraceReader::readEvent(std::ostream& output)
+{
+  using Event = TraceWriter::Event;
+
+  const auto event = static_cast<Event>(mInput.get());
+  uint64_t logger = 0;
+  uint64_t number = 0;
+  const char* tag = nullptr;
+  const char* name = nullptr;
+  bool isValid = true;
+  if (event == Event::string)
+  {
+    isValid = readNumber(number) && number == mStrings.size() &&
+              readNumber(number) && readBytes(mBytes, number);
+    mStrings.push_back(mBytes);
+  }
+  else if (event == Event::start)
+  {
+    isValid = readNumber(logger) && readString(tag) && readString(name);
+    if (isValid)
+    {
+      getLogger(logger).startLog(tag, name);
+    }
+    else
+    {
+    }
+  }
+  else if (event == Event::startAt)
+  {
+    isValid = readNumber(logger) && readString(tag) && readString(name) &&
+              readNumber(number);
+    if (isValid)
+    {
+      getLogger(logger).startLog(
+          tag, name, TimePoint() + Nanoseconds(static_cast<int64_t>(number)));
+    }
+    else
+    {
+    }
+  }
+  else if (event == Event::startIn)
+  {
+    const char* file = nullptr;
+    uint64_t line = 0;
+    isValid = readNumber(logger) && readString(tag) && readString(name) &&
+              readString(file) && readNumber(line) && readNumber(number);
+    if (isValid)
+    {
+      getLogger(logger).startLog(
+          tag,
+          name,
+          file,
+          line,
+          TimePoint() + Nanoseconds(static_cast<int64_t>(number)));
+    }
+    else
+    {
+    }
+  }
+  else if (event == Event::payload)
+  {
+    isValid = readNumber(logger) && readNumber(number) &&
+              readBytes(mBytes, number);
+    if (isValid)
+    {
+      getLogger(logger).write(mBytes.data(), mBytes.size());
+    }
+    else
+    {
+    }
+  }
+  else if (event == Event::finish)
+  {
+    Logger::finishLine();
+  }
+  else if (event == Event::text)
+  {
+    isValid = readNumber(number) && readBytes(mBytes, number);
+    if (isValid)
+    {
+      output << mBytes;
+    }
+    else
+    {
+    }
+  }
+  else
+  {
+    isValid = false;
+  }
+  return isValid;
+}
+
+// ---------------------------------------------------------------------------
+bool
+TraceReader::readNumber(uint64_t& number)
+{
+  static constexpr uint64_t lowBits = 0x7F;
+  static constexpr uint64_t moreBit = 0x80;
+  static constexpr unsigned maxShift = 63;
+  number = 0;
+  unsigned shift = 0;
+  auto byte = static_cast<uint64_t>(moreBit);
+  while ((byte & moreBit) != 0 && shift <= maxShift && mInput.good())
+  {
+    byte = static_cast<uint64_t>(mInput.get());
+    number |= (byte & lowBits) << shift;
+    shift += 7;
+  }
+  return mInput.good() && (byte & moreBit) == 0;
+}
+
+bool
+TraceReader::readBytes(std::string& bytes, uint64_t size)
+{
+  // the size of a corrupt trace could be anything, so the bytes are read
+  // in chunks until the end of the input instead of allocated up front
+  static constexpr uint64_t chunkSize = 64U * 1024U;
+  bytes.clear();
+  while (bytes.size() < size && mInput.good())
+  {
+    const size_t offset = bytes.size();
+    bytes.resize(offset + std::min(chunkSize, size - offset));
+    mInput.read(&bytes[offset], static_cast<std::streamsize>(bytes.size() -
+                                                              offset));
+    bytes.resize(offset + static_cast<size_t>(mInput.gcount()));
+  }
+  return bytes.size() == size;
+}
+
+bool
+TraceReader::readString(const char*& string)
+{
+  uint64_t id = 0;
+  const bool isValid = readNumber(id) && id < mStrings.size();
+  if (isValid)
+  {
+    string = mStrings[id].c_str();
+  }
+  else
+  {
+  }
+  return isValid;
+}
+
+Logger&
+TraceReader::getLogger(uint64_t id)
+{
+  auto& logger = mLoggers[id];
+  if (logger == nullptr)
+  {
+    logger = std::make_unique<Logger>();
+  }
+  else
+  {
+  }
+  return *logger;
+}
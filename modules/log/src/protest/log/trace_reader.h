@@ -0,0 +1,109 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/log/logger.h"
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace protest
+{
+
+namespace log
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class TraceReader
+ * 
+ * Renders a trace written by TraceWriter to text. Every event is replayed
+ * with a logger of its own per traced logger, so the text is exactly the
+ * one the loggers would have written without the trace.
+ */
+class TraceReader
+{
+public:
+  explicit TraceReader(std::istream& input);
+
+  TraceReader(const TraceReader& other) = delete;
+
+  TraceReader(TraceReader&& other) = delete;
+
+  TraceReader&
+  operator=(const TraceReader& other) = delete;
+
+  TraceReader&
+  operator=(TraceReader&& other) = delete;
+
+  ~TraceReader() = default;
+
+// ---------------------------------------------------------------------------
+  /**
+   * @brief render
+   * 
+   * writes the text of the trace to output. Must not be called while the
+   * calling thread writes a trace (see Logger::setTrace).
+   * 
+   * @return
+   *  false if the input is not a complete trace. The text of the events
+   *  read so far is written anyway.
+   */
+  bool
+  render(std::ostream& output);
+
+private:
+  bool
+  readHeader();
+
+  bool
+  readEvent(std::ostream& output);
+
+  bool
+  readNumber(uint64_t& number);
+
+  bool
+  readBytes(std::string& bytes, uint64_t size);
+
+  bool
+  readString(const char*& string);
+
+  Logger&
+  getLogger(uint64_t id);
+
+  std::istream& mInput;
+  std::vector<std::string> mStrings;
+  std::map<uint64_t, std::unique_ptr<Logger>> mLoggers;
+  std::string mBytes;
+};
+
+} // namespace log
+
+} // namespace protest
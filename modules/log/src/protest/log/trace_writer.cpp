@@ -0,0 +1,197 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/log/trace_writer.h"
+
+#include <string_view>
+
+using namespace protest::log;
+
+// ---------------------------------------------------------------------------
+TraceWriter::TraceWriter(std::ostream& output) :
+  mOutput(output),
+  mPayloadLogger(0)
+{
+  mBuffer.reserve(bufferSize);
+  writeBytes(magic, magicSize);
+  writeNumber(version);
+}
+
+TraceWriter::~TraceWriter()
+{
+  flush();
+}
+
+// ---------------------------------------------------------------------------
+void
+TraceWriter::start(uint64_t logger, const char* tag, const char* name)
+{
+  const uint64_t tagId = intern(tag);
+  const uint64_t nameId = intern(name);
+  writeEvent(Event::start);
+  writeNumber(logger);
+  writeNumber(tagId);
+  writeNumber(nameId);
+}
+
+void
+TraceWriter::start(uint64_t logger,
+                   const char* tag,
+                   const char* name,
+                   time::TimePoint now)
+{
+  const uint64_t tagId = intern(tag);
+  const uint64_t nameId = intern(name);
+  writeEvent(Event::startAt);
+  writeNumber(logger);
+  writeNumber(tagId);
+  writeNumber(nameId);
+  writeNumber(now.nanoseconds());
+}
+
+void
+TraceWriter::start(uint64_t logger,
+                   const char* tag,
+                   const char* name,
+                   const char* file,
+                   size_t line,
+                   time::TimePoint now)
+{
+  const uint64_t tagId = intern(tag);
+  const uint64_t nameId = intern(name);
+  const uint64_t fileId = intern(file);
+  writeEvent(Event::startIn);
+  writeNumber(logger);
+  writeNumber(tagId);
+  writeNumber(nameId);
+  writeNumber(fileId);
+  writeNumber(line);
+  writeNumber(now.nanoseconds());
+}
+
+void
+TraceWriter::write(uint64_t logger, const char* data, size_t size)
+{
+  if (logger != mPayloadLogger)
+  {
+    writePayload();
+    mPayloadLogger = logger;
+  }
+  else
+  {
+  }
+  mPayload.append(data, size);
+}
+
+void
+TraceWriter::finishLine()
+{
+  writeEvent(Event::finish);
+}
+
+void
+TraceWriter::writeText(const char* data, size_t size)
+{
+  writeEvent(Event::text);
+  writeNumber(size);
+  writeBytes(data, size);
+}
+
+void
+TraceWriter::flush()
+{
+  writePayload();
+  mOutput.write(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+  mOutput.flush();
+  mBuffer.clear();
+}
+
+// ---------------------------------------------------------------------------
+uint64_t
+TraceWriter::intern(const char* string)
+{
+  const std::string_view value(string);
+  auto iter = mStrings.find(value);
+  if (iter == mStrings.end())
+  {
+    iter = mStrings.emplace(std::string(value), mStrings.size()).first;
+    writeEvent(Event::string);
+    writeNumber(iter->second);
+    writeNumber(value.size());
+    writeBytes(value.data(), value.size());
+  }
+  else
+  {
+  }
+  return iter->second;
+}
+
+void
+TraceWriter::writePayload()
+{
+  if (!mPayload.empty())
+  {
+    mBuffer.push_back(static_cast<char>(Event::payload));
+    writeNumber(mPayloadLogger);
+    writeNumber(mPayload.size());
+    writeBytes(mPayload.data(), mPayload.size());
+    mPayload.clear();
+  }
+  else
+  {
+  }
+}
+
+void
+TraceWriter::writeEvent(Event event)
+{
+  writePayload();
+  if (mBuffer.size() >= bufferSize)
+  {
+    flush();
+  }
+  else
+  {
+  }
+  mBuffer.push_back(static_cast<char>(event));
+}
+
+void
+TraceWriter::writeNumber(uint64_t number)
+{
+  static constexpr uint64_t lowBits = 0x7F;
+  static constexpr uint64_t moreBit = 0x80;
+  while (number > lowBits)
+  {
+    mBuffer.push_back(static_cast<char>((number & lowBits) | moreBit));
+    number >>= 7U;
+  }
+  mBuffer.push_back(static_cast<char>(number));
+}
+
+void
+TraceWriter::writeBytes(const char* data, size_t size)
+{
+  mBuffer.insert(mBuffer.end(), data, data + size);
+}
@@ -0,0 +1,157 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/time/time_point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace protest
+{
+
+namespace log
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class TraceWriter
+ * 
+ * Writes the log of the calling thread as a compact binary trace instead of
+ * text (see Logger::setTrace). A trace is a sequence of events, every
+ * number is stored as LEB128 varint:
+ * 
+ * - string:   id, length, characters. Tags, runner names and file names
+ *             are written once and referenced by their id afterwards.
+ * - start:    logger, tag, name (startLog without time)
+ * - startAt:  logger, tag, name, time in nanoseconds
+ * - startIn:  logger, tag, name, file, line, time in nanoseconds
+ * - payload:  logger, length, characters written to a log entry
+ * - finish:   Logger::finishLine was called
+ * - text:     length, characters written to the output as they are
+ * 
+ * The trace starts with the characters of magic followed by version.
+ * TraceReader renders a trace to the text the loggers would have written.
+ */
+class TraceWriter
+{
+public:
+  static constexpr const char* magic = "PTRC";
+  static constexpr size_t magicSize = 4;
+  static constexpr uint8_t version = 1;
+  static constexpr size_t bufferSize = 64U * 1024U;
+
+  enum class Event : uint8_t
+  {
+    string = 1,
+    start,
+    startAt,
+    startIn,
+    payload,
+    finish,
+    text
+  };
+
+  explicit TraceWriter(std::ostream& output);
+
+  TraceWriter(const TraceWriter& other) = delete;
+
+  TraceWriter(TraceWriter&& other) = delete;
+
+  TraceWriter&
+  operator=(const TraceWriter& other) = delete;
+
+  TraceWriter&
+  operator=(TraceWriter&& other) = delete;
+
+  ~TraceWriter();
+
+// ---------------------------------------------------------------------------
+  void
+  start(uint64_t logger, const char* tag, const char* name);
+
+  void
+  start(uint64_t logger,
+        const char* tag,
+        const char* name,
+        time::TimePoint now);
+
+  void
+  start(uint64_t logger,
+        const char* tag,
+        const char* name,
+        const char* file,
+        size_t line,
+        time::TimePoint now);
+
+  void
+  write(uint64_t logger, const char* data, size_t size);
+
+  void
+  finishLine();
+
+  void
+  writeText(const char* data, size_t size);
+
+  /**
+   * @brief flush
+   * 
+   * writes the buffered events to the output.
+   */
+  void
+  flush();
+
+private:
+  uint64_t
+  intern(const char* string);
+
+  void
+  writePayload();
+
+  void
+  writeEvent(Event event);
+
+  void
+  writeNumber(uint64_t number);
+
+  void
+  writeBytes(const char* data, size_t size);
+
+  std::ostream& mOutput;
+  std::vector<char> mBuffer;
+  std::map<std::string, uint64_t, std::less<>> mStrings;
+  // consecutive writes of a logger are merged into one payload event
+  uint64_t mPayloadLogger;
+  std::string mPayload;
+};
+
+} // namespace log
+
+} // namespace protest
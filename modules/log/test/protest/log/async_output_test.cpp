@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "protest/log/async_output.h"
+#include "protest/log/logger.h"
+
+#include <sstream>
+#include <string>
+
+using namespace protest::log;
+
+TEST(async_output, should_write_chunks_in_order)
+{
+  std::ostringstream target;
+  std::string expected;
+  {
+    // small chunks and a short queue -> the writer falls behind
+    AsyncOutput output(target, 7, 1);
+    for (int i = 0; i < 1000; i++)
+    {
+      output.getStream() << "line " << i << "\n";
+      expected += "line " + std::to_string(i) + "\n";
+    }
+    output.getStream() << "end";
+    output.getStream().flush();
+  }
+  ASSERT_EQ(expected + "end", target.str());
+}
+
+TEST(async_output, should_write_everything_until_waited_for)
+{
+  std::ostringstream target;
+  AsyncOutput output(target);
+  output.getStream() << "first";
+  output.waitUntilWritten();
+  ASSERT_EQ("first", target.str());
+
+  output.getStream() << " second";
+  output.waitUntilWritten();
+  ASSERT_EQ("first second", target.str());
+}
+
+TEST(async_output, should_keep_the_format_of_the_logger)
+{
+  auto writeLog = [](std::ostream& output) {
+    OutputScope outputScope(output);
+    Logger logger;
+    logger.startLog("INFO", "log") << "first\nsecond";
+    logger.startLog("INFO", "log") << "third";
+    Logger::finishLine();
+  };
+
+  std::ostringstream direct;
+  writeLog(direct);
+  std::ostringstream target;
+  {
+    AsyncOutput output(target, 16);
+    writeLog(output.getStream());
+  }
+  ASSERT_EQ(direct.str(), target.str());
+}
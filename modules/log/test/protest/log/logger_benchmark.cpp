@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include "protest/coro/benchmark.h"
+#include "protest/log/async_output.h"
+#include "protest/log/logger.h"
+#include "protest/log/trace_writer.h"
+#include "protest/time/duration.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace protest::log;
+using namespace protest::time;
+using protest::benchmark::report;
+
+namespace
+{
+
+constexpr size_t numberOfRecords = 100000u;
+
+// similar to the output of a mock call: a header followed by a multi-line
+// payload which is indented by the logger
+void
+writeRecord(Logger& logger, size_t index)
+{
+  const auto now = TimePoint() + Millisecond(static_cast<int64_t>(index));
+  logger.startLog("CALL", "run", "mock_test.cpp", 42, now)
+      << "call of 'send' with\n"
+      << "  address: " << index << "\n"
+      << "  payload: 'abcdefghijklmnopqrstuvwxyz'\n"
+      << "matched by expectation at mock_test.cpp:17";
+  Logger::finishLine();
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+TEST(log_benchmark, should_indent_continuation_lines)
+{
+  std::ostringstream output;
+  OutputScope outputScope(output);
+  Logger logger;
+  writeRecord(logger, 7);
+  logger.startLog("TEST", "run", TimePoint() + Millisecond(8)) << "a\n\nb";
+  Logger::finishLine();
+
+  const std::string indentation(Logger::totalOffsetSize + 1, ' ');
+  ASSERT_EQ("CALL 0000000007   run mock_test.cpp:42\n" + indentation +
+                "call of 'send' with\n" + indentation + "  address: 7\n" +
+                indentation + "  payload: 'abcdefghijklmnopqrstuvwxyz'\n" +
+                indentation + "matched by expectation at mock_test.cpp:17\n" +
+                "TEST 0000000008   run a\n" + indentation + "\n" +
+                indentation + "b\n",
+            output.str());
+}
+
+TEST(log_benchmark, write_100k_records)
+{
+  std::ostringstream output;
+  OutputScope outputScope(output);
+  Logger logger;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < numberOfRecords; i++)
+  {
+    writeRecord(logger, i);
+  }
+  auto end = std::chrono::steady_clock::now();
+  report("write log records", "records", numberOfRecords, end - start);
+  report("write log bytes", "bytes", output.str().size(), end - start);
+}
+
+TEST(log_benchmark, write_100k_records_async)
+{
+  std::ostringstream target;
+  std::chrono::nanoseconds elapsed(0);
+  {
+    AsyncOutput output(target);
+    OutputScope outputScope(output.getStream());
+    Logger logger;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < numberOfRecords; i++)
+    {
+      writeRecord(logger, i);
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  report("write log records (async)", "records", numberOfRecords, elapsed);
+  // the header and four lines of payload per record
+  const std::string text = target.str();
+  ASSERT_EQ(5 * numberOfRecords,
+            static_cast<size_t>(std::count(text.begin(), text.end(), '\n')));
+}
+
+TEST(log_benchmark, write_100k_records_as_trace)
+{
+  std::ostringstream target;
+  std::chrono::nanoseconds elapsed(0);
+  {
+    TraceWriter trace(target);
+    Logger::setTrace(&trace);
+    Logger logger;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < numberOfRecords; i++)
+    {
+      writeRecord(logger, i);
+    }
+    trace.flush();
+    elapsed = std::chrono::steady_clock::now() - start;
+    Logger::setTrace(nullptr);
+  }
+  report("write log records (trace)", "records", numberOfRecords, elapsed);
+  report("write trace bytes", "bytes", target.str().size(), elapsed);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "protest/log/logger.h"
+#include "protest/log/trace_reader.h"
+#include "protest/log/trace_writer.h"
+#include "protest/time/duration.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace protest::log;
+using namespace protest::time;
+
+namespace
+{
+
+// two loggers with interleaved and unterminated entries
+void
+writeLog()
+{
+  Logger first;
+  Logger second;
+  first.startLog("INFO", "frst", "test.cpp", 12, TimePoint() + Millisecond(3))
+      << "first\nsecond\n";
+  second.startLog("WAIT", "scnd", TimePoint() + Millisecond(1234)) << "x";
+  first.startLog("INFO", "frst") << 42 << "\n\nafter empty line";
+  second.write(" continued", 10);
+  Logger::writeText("raw text\n");
+  Logger::finishLine();
+  Logger::finishLine();
+  second.startLog("EXIT", "scnd", TimePoint() + Millisecond(1235))
+      << "bye\n";
+}
+
+} // namespace
+
+TEST(trace, should_render_the_text_of_the_loggers)
+{
+  std::ostringstream direct;
+  OutputScope outputScope(direct);
+  writeLog();
+  Logger::finishLine();
+
+  std::stringstream trace;
+  {
+    TraceWriter writer(trace);
+    Logger::setTrace(&writer);
+    writeLog();
+    Logger::setTrace(nullptr);
+  }
+
+  std::ostringstream rendered;
+  TraceReader reader(trace);
+  ASSERT_TRUE(reader.render(rendered));
+
+  ASSERT_NE(std::string::npos, direct.str().find("after empty line"));
+  ASSERT_EQ(direct.str(), rendered.str());
+}
+
+TEST(trace, should_intern_strings)
+{
+  std::ostringstream direct;
+  std::stringstream trace;
+  OutputScope outputScope(direct);
+  {
+    TraceWriter writer(trace);
+    Logger::setTrace(&writer);
+    Logger logger;
+    for (int i = 0; i < 100; i++)
+    {
+      logger.startLog("INFO", "name", "file.cpp", 1, TimePoint()) << "text";
+    }
+    Logger::setTrace(nullptr);
+  }
+
+  // every string is written once
+  ASSERT_EQ(std::string::npos, trace.str().find("file.cpp", 100));
+  ASSERT_EQ("", direct.str());
+}
+
+TEST(trace, should_reject_invalid_traces)
+{
+  std::ostringstream direct;
+  OutputScope outputScope(direct);
+  Logger().startLog("INFO", "name");
+  Logger::finishLine();
+
+  std::ostringstream rendered;
+  std::istringstream text("INFO 0000000000  name file.cpp:1\n");
+  ASSERT_FALSE(TraceReader(text).render(rendered));
+  ASSERT_EQ("", rendered.str());
+
+  std::stringstream trace;
+  {
+    TraceWriter writer(trace);
+    writer.start(0, "INFO", "name");
+    writer.write(0, "text", 4);
+  }
+  // the events read so far are rendered, the truncated payload is dropped
+  std::istringstream truncated(trace.str().substr(0, trace.str().size() - 2));
+  ASSERT_FALSE(TraceReader(truncated).render(rendered));
+  {
+    OutputScope renderedScope(rendered);
+    Logger::finishLine();
+  }
+  ASSERT_EQ(direct.str(), rendered.str());
+}
+
+TEST(trace, should_reject_corrupt_sizes)
+{
+  std::string header(TraceWriter::magic, TraceWriter::magicSize);
+  header += static_cast<char>(TraceWriter::version);
+  // a size of almost 2^63 bytes, followed by a few bytes only
+  const std::string hugeSize = "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F";
+  const std::vector<TraceWriter::Event> events = {
+      TraceWriter::Event::text, TraceWriter::Event::payload};
+  for (auto event : events)
+  {
+    std::string trace = header + static_cast<char>(event);
+    if (event == TraceWriter::Event::payload)
+    {
+      // the logger
+      trace += '\0';
+    }
+    else
+    {
+    }
+    std::istringstream corrupt(trace + hugeSize + "text");
+    std::ostringstream rendered;
+    ASSERT_FALSE(TraceReader(corrupt).render(rendered));
+    ASSERT_EQ("", rendered.str());
+  }
+}
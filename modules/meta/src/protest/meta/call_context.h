@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <vector>
 #include <string>
@@ -143,8 +144,8 @@ public:
   getCondition();
 
 private:
-  uint32_t mNumberOfFailes;
-  bool mExecuted;
+  std::atomic<uint32_t> mNumberOfFailes;
+  std::atomic<bool> mExecuted;
 };
 
 // ---------------------------------------------------------------------------
@@ -195,8 +196,8 @@ public:
   getCondition();
 
 private:
-  uint32_t mNumberOfFailes;
-  bool mExecuted;
+  std::atomic<uint32_t> mNumberOfFailes;
+  std::atomic<bool> mExecuted;
 };
 
 // ---------------------------------------------------------------------------
@@ -255,10 +256,10 @@ public:
   incrementNumberOfMissingCalls();
 
 private:
-  size_t mNumberOfUnexpectedCalls;
-  size_t mNumberOfUnmetPrerequisites;
-  size_t mNumberOfMissingCalls;
-  bool mWasExecuted;
+  std::atomic<size_t> mNumberOfUnexpectedCalls;
+  std::atomic<size_t> mNumberOfUnmetPrerequisites;
+  std::atomic<size_t> mNumberOfMissingCalls;
+  std::atomic<bool> mWasExecuted;
 };
 
 // ---------------------------------------------------------------------------
@@ -304,8 +305,8 @@ public:
   markAsNotHold();
 
 private:
-  bool mWasCreated;
-  bool mHold;
+  std::atomic<bool> mWasCreated;
+  std::atomic<bool> mHold;
 };
 
 // ---------------------------------------------------------------------------
@@ -352,8 +353,8 @@ public:
   incrementNumberOfUnexpectedCalls();
 
 private:
-  size_t mNumberOfUnexpectedCalls;
-  size_t mNumberOfCreations;
+  std::atomic<size_t> mNumberOfUnexpectedCalls;
+  std::atomic<size_t> mNumberOfCreations;
 };
 
 // ---------------------------------------------------------------------------
@@ -30,6 +30,7 @@
 #include "protest/core/runner_raw.h"
 #include "protest/meta/call_context.h"
 
+#include <cstring>
 #include <memory>
 #include <tuple>
 #include <vector>
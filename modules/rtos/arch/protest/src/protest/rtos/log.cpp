@@ -51,7 +51,7 @@ protest::rtos::_info(const char* file, size_t line, const char* format, ...)
                                              file,
                                              line,
                                              runner->now());
-  static char buf[bufferSize];// TODO (jreinking) no static
+  char buf[bufferSize];
   const int ret = vsnprintf(&buf[0], bufferSize, format, &argp[0]);
   assert(ret >= 0 && ret < bufferSize);
   stream.operator std::ostream&() << &buf[0];
@@ -70,7 +70,7 @@ protest::rtos::_warn(const char* file, size_t line, const char* format, ...)
                                              file,
                                              line,
                                              runner->now());
-  static char buf[bufferSize];// TODO (jreinking) no static
+  char buf[bufferSize];
   const int ret = vsnprintf(&buf[0], bufferSize, format, &argp[0]);
   assert(ret >= 0 && ret < bufferSize);
   stream.operator std::ostream&() << &buf[0];
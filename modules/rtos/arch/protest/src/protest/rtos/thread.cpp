@@ -28,6 +28,9 @@
 
 using namespace protest::rtos;
 
+static constexpr size_t defaultStackSize =
+    protest::coro::CoroutineBase::defaultStackSize;
+
 // ---------------------------------------------------------------------------
 /**
  * @class ThreadRunner
@@ -35,8 +38,13 @@ using namespace protest::rtos;
 class ThreadRunner : public protest::core::RunnerRaw
 {
 public:
+  // the stack size is selected by the context (see Context::getStackSize)
   explicit ThreadRunner(const char* name, protest::rtos::Thread* thread);
 
+  explicit ThreadRunner(size_t stackSize,
+                        const char* name,
+                        protest::rtos::Thread* thread);
+
   ThreadRunner(const ThreadRunner& other) = delete;
 
   ThreadRunner(ThreadRunner&& other) = delete;
@@ -64,6 +72,14 @@ ThreadRunner::ThreadRunner(const char* name, protest::rtos::Thread* thread) :
 {
 }
 
+ThreadRunner::ThreadRunner(size_t stackSize,
+                           const char* name,
+                           protest::rtos::Thread* thread) :
+  protest::core::RunnerRaw(stackSize, name),
+  mThread(thread)
+{
+}
+
 void
 ThreadRunner::process()
 {
@@ -93,13 +109,20 @@ Thread::Thread(uint8_t /* priority */, const char* name) : mUserdata(nullptr)
   mUserdata = new ThreadRunner(name, this);
 }
 
-Thread::Thread(uint8_t /* priority */,
-               size_t /* stackSize */,
-               const char* name) :
+Thread::Thread(uint8_t /* priority */, size_t stackSize, const char* name) :
   mUserdata(nullptr)
 {
+  // the stack size of the target does not account for the host (iostreams,
+  // logging, ...) -> it can only enlarge the default stack
+  if (stackSize < defaultStackSize)
+  {
+    stackSize = defaultStackSize;
+  }
+  else
+  {
+  }
   // NOLINTNEXTLINE
-  mUserdata = new ThreadRunner(name, this);
+  mUserdata = new ThreadRunner(stackSize, name, this);
 }
 
 Thread::~Thread()
@@ -0,0 +1,394 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/utils/debug.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace protest
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class DynamicHeap
+ * 
+ * Indexed min-heap like Heap<T, N> but without an upper bound of elements.
+ * The buffer doubles its capacity when it is full, therefore push is
+ * O(log n) amortized and pop/remove are O(log n).
+ * 
+ * The elements are ordered exactly like in Heap<T, N> (same sift operations)
+ * so elements with equal keys are popped in the same order.
+ * 
+ * T needs a member `mIndex` (position inside of the heap) and `operator<`.
+ */
+template <typename T>
+class DynamicHeap
+{
+public:
+  static constexpr size_t initialCapacity = 16u;
+
+  explicit DynamicHeap();
+
+  ~DynamicHeap();
+
+  DynamicHeap(const DynamicHeap&) = delete;
+
+  DynamicHeap(const DynamicHeap&&) = delete;
+
+  DynamicHeap&
+  operator=(const DynamicHeap&) = delete;
+
+  DynamicHeap&
+  operator=(const DynamicHeap&&) = delete;
+
+  void
+  push(T* value);
+
+  T*
+  peek();
+
+  T*
+  pop();
+
+  void
+  remove(T* value);
+
+  /**
+   * Restores the order after the key of value was increased. The value
+   * stays in the heap and is moved down in place, which is cheaper than
+   * removing and pushing it again.
+   */
+  void
+  update(T* value);
+
+  void
+  reserve(size_t capacity);
+
+  bool
+  isAvailable();
+
+  bool
+  isEmpty();
+
+  size_t
+  numberOfElements();
+
+  size_t
+  capacity();
+
+private:
+  void
+  heapify(size_t index);
+
+  void
+  siftDown(size_t n);
+
+  size_t
+  parent(size_t n);
+
+  size_t
+  left(size_t n);
+
+  size_t
+  right(size_t n);
+
+  void
+  swap(size_t n, size_t m);
+
+  T** mBuffer;
+  size_t mNumberOfElements;
+  size_t mCapacity;
+};
+
+// ---------------------------------------------------------------------------
+template <typename T>
+DynamicHeap<T>::DynamicHeap() :
+  mBuffer(nullptr),
+  mNumberOfElements(0u),
+  mCapacity(0u)
+{
+}
+
+template <typename T>
+DynamicHeap<T>::~DynamicHeap()
+{
+  // NOLINTNEXTLINE
+  free(mBuffer);
+  mBuffer = nullptr;
+}
+
+template <typename T>
+void
+DynamicHeap<T>::push(T* value)
+{
+  if (mNumberOfElements == mCapacity)
+  {
+    reserve(mCapacity == 0 ? initialCapacity : mCapacity * 2);
+  }
+  else
+  {
+  }
+
+  mBuffer[mNumberOfElements] = value;
+  mBuffer[mNumberOfElements]->mIndex = mNumberOfElements;
+  size_t n = mNumberOfElements;
+  size_t p = 0;
+
+  while (n > 0)
+  {
+    p = parent(n);
+
+    if ((*mBuffer[n]) < (*mBuffer[p]))
+    {
+      // need to order
+      swap(n, p);
+    }
+    else
+    {
+      // is fine
+    }
+    n = p;
+  }
+
+  mNumberOfElements++;
+}
+
+template <typename T>
+T*
+DynamicHeap<T>::peek()
+{
+  PROTEST_ASSERT(isAvailable());
+  return mBuffer[0];
+}
+
+template <typename T>
+T*
+DynamicHeap<T>::pop()
+{
+  PROTEST_ASSERT(isAvailable());
+  T* value = mBuffer[0];
+  heapify(0);
+  return value;
+}
+
+template <typename T>
+void
+DynamicHeap<T>::remove(T* value)
+{
+  PROTEST_ASSERT(value->mIndex < mNumberOfElements);
+  PROTEST_ASSERT(mBuffer[value->mIndex] == value);
+  if (value->mIndex != 0)
+  {
+    // move the value to the top and pop it
+    size_t current = value->mIndex;
+    size_t top = parent(current);
+    while (current != 0)
+    {
+      mBuffer[current] = mBuffer[top];
+      mBuffer[top]->mIndex = current;
+      current = top;
+      if (current != 0)
+      {
+        top = parent(current);
+      }
+    }
+    mBuffer[0] = value;
+    value->mIndex = 0;
+  }
+  pop();
+}
+
+template <typename T>
+void
+DynamicHeap<T>::update(T* value)
+{
+  PROTEST_ASSERT(value->mIndex < mNumberOfElements);
+  PROTEST_ASSERT(mBuffer[value->mIndex] == value);
+  siftDown(value->mIndex);
+}
+
+template <typename T>
+void
+DynamicHeap<T>::reserve(size_t capacity)
+{
+  if (capacity <= mCapacity)
+  {
+    return;
+  }
+  else
+  {
+  }
+
+  // NOLINTNEXTLINE
+  auto** buffer = static_cast<T**>(realloc(mBuffer, capacity * sizeof(T*)));
+  PROTEST_ASSERT(buffer != nullptr);
+  for (size_t i = mCapacity; i < capacity; i++)
+  {
+    buffer[i] = nullptr;
+  }
+  mBuffer = buffer;
+  mCapacity = capacity;
+}
+
+template <typename T>
+bool
+DynamicHeap<T>::isAvailable()
+{
+  return mNumberOfElements > 0;
+}
+
+template <typename T>
+bool
+DynamicHeap<T>::isEmpty()
+{
+  return mNumberOfElements == 0;
+}
+
+template <typename T>
+size_t
+DynamicHeap<T>::numberOfElements()
+{
+  return mNumberOfElements;
+}
+
+template <typename T>
+size_t
+DynamicHeap<T>::capacity()
+{
+  return mCapacity;
+}
+
+// ---------------------------------------------------------------------------
+template <typename T>
+void
+DynamicHeap<T>::heapify(size_t index)
+{
+  PROTEST_ASSERT(index < mNumberOfElements);
+  mBuffer[index] = mBuffer[mNumberOfElements - 1];
+  mBuffer[index]->mIndex = index;
+  mNumberOfElements--;
+  mBuffer[mNumberOfElements] = nullptr;
+  siftDown(index);
+}
+
+template <typename T>
+void
+DynamicHeap<T>::siftDown(size_t n)
+{
+  bool done = false;
+  while (!done)
+  {
+    size_t l = left(n);
+    size_t r = right(n);
+
+    bool hasLeft = (l < mNumberOfElements);
+    bool hasRight = (r < mNumberOfElements);
+
+    if (hasLeft && hasRight)
+    {
+      if ((*mBuffer[l]) < (*mBuffer[r]))
+      {
+        if ((*mBuffer[l]) < (*mBuffer[n]))
+        {
+          swap(l, n);
+          n = l;
+        }
+        else
+        {
+          done = true;
+        }
+      }
+      else
+      {
+        if ((*mBuffer[r]) < (*mBuffer[n]))
+        {
+          swap(r, n);
+          n = r;
+        }
+        else
+        {
+          done = true;
+        }
+      }
+    }
+    else if (hasLeft)
+    {
+      if ((*mBuffer[l]) < (*mBuffer[n]))
+      {
+        swap(l, n);
+        n = l;
+      }
+      else
+      {
+        done = true;
+      }
+    }
+    else
+    {
+      // a right child without a left child cannot exist since the heap is
+      // filled from the left
+      done = true;
+    }
+  }
+}
+
+template <typename T>
+size_t
+DynamicHeap<T>::parent(size_t n)
+{
+  PROTEST_ASSERT(n > 0);
+  return (n - 1) / 2;
+}
+
+template <typename T>
+size_t
+DynamicHeap<T>::left(size_t n)
+{
+  return (2 * n) + 1;
+}
+
+template <typename T>
+size_t
+DynamicHeap<T>::right(size_t n)
+{
+  return (2 * n) + 2;
+}
+
+template <typename T>
+void
+DynamicHeap<T>::swap(size_t n, size_t m)
+{
+  T* tmp = mBuffer[n];
+  mBuffer[n] = mBuffer[m];
+  mBuffer[m] = tmp;
+
+  mBuffer[m]->mIndex = m;
+  mBuffer[n]->mIndex = n;
+}
+
+} // namespace protest
@@ -0,0 +1,227 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "protest/utils/debug.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace protest
+{
+
+// ---------------------------------------------------------------------------
+/**
+ * @class DynamicRingBuffer
+ * 
+ * FIFO like RingBuffer<T, N> but with a capacity given at runtime. A
+ * capacity of `unbounded` lets the buffer double its storage whenever it is
+ * full, such a buffer is never full.
+ */
+template <typename T>
+class DynamicRingBuffer
+{
+public:
+  static constexpr size_t unbounded = 0u;
+
+  static constexpr size_t initialCapacity = 16u;
+
+  explicit DynamicRingBuffer(size_t capacity);
+
+  ~DynamicRingBuffer();
+
+  DynamicRingBuffer(const DynamicRingBuffer&) = delete;
+
+  DynamicRingBuffer(DynamicRingBuffer&&) noexcept = delete;
+
+  DynamicRingBuffer&
+  operator=(const DynamicRingBuffer&) = delete;
+
+  DynamicRingBuffer&
+  operator=(DynamicRingBuffer&&) noexcept = delete;
+
+  void
+  push(T value);
+
+  T
+  pop();
+
+  T
+  peek();
+
+  bool
+  isEmpty();
+
+  bool
+  isFull();
+
+  bool
+  isAvailable();
+
+  size_t
+  numberOfElements();
+
+  size_t
+  capacity();
+
+  void
+  clear();
+
+private:
+  void
+  grow();
+
+  T* mBuffer;
+  size_t mSize;
+  size_t mCapacity;
+  size_t mNumberOfElements;
+  size_t mFirst;
+};
+
+template <typename T>
+DynamicRingBuffer<T>::DynamicRingBuffer(size_t capacity) :
+  mBuffer(nullptr),
+  mSize(capacity == unbounded ? initialCapacity : capacity),
+  mCapacity(capacity),
+  mNumberOfElements(0u),
+  mFirst(0u)
+{
+  mBuffer = new T[mSize]();
+}
+
+template <typename T>
+DynamicRingBuffer<T>::~DynamicRingBuffer()
+{
+  delete[] mBuffer;
+}
+
+template <typename T>
+void
+DynamicRingBuffer<T>::push(T value)
+{
+  PROTEST_ASSERT(!isFull());
+  if (mNumberOfElements == mSize)
+  {
+    grow();
+  }
+  else
+  {
+  }
+  mBuffer[(mFirst + mNumberOfElements) % mSize] = std::move(value);
+  mNumberOfElements++;
+}
+
+template <typename T>
+T
+DynamicRingBuffer<T>::pop()
+{
+  PROTEST_ASSERT(mNumberOfElements > 0);
+  T value = std::move(mBuffer[mFirst]);
+  if constexpr (!std::is_trivially_copyable_v<T>)
+  {
+    // release resources (e.g. a shared payload) held by the popped slot
+    mBuffer[mFirst] = T();
+  }
+  else
+  {
+  }
+  mFirst = (mFirst + 1) % mSize;
+  mNumberOfElements--;
+  return value;
+}
+
+template <typename T>
+T
+DynamicRingBuffer<T>::peek()
+{
+  PROTEST_ASSERT(mNumberOfElements > 0);
+  T value = mBuffer[mFirst];
+  return value;
+}
+
+template <typename T>
+bool
+DynamicRingBuffer<T>::isEmpty()
+{
+  return mNumberOfElements == 0;
+}
+
+template <typename T>
+bool
+DynamicRingBuffer<T>::isFull()
+{
+  return mCapacity != unbounded && mNumberOfElements == mCapacity;
+}
+
+template <typename T>
+bool
+DynamicRingBuffer<T>::isAvailable()
+{
+  return mNumberOfElements > 0;
+}
+
+template <typename T>
+size_t
+DynamicRingBuffer<T>::numberOfElements()
+{
+  return mNumberOfElements;
+}
+
+template <typename T>
+size_t
+DynamicRingBuffer<T>::capacity()
+{
+  return mCapacity;
+}
+
+template <typename T>
+void
+DynamicRingBuffer<T>::clear()
+{
+  while (numberOfElements())
+  {
+    pop();
+  }
+}
+
+template <typename T>
+void
+DynamicRingBuffer<T>::grow()
+{
+  // unwrap the elements into the new storage, the oldest one goes first
+  const size_t size = 2u * mSize;
+  T* buffer = new T[size]();
+  for (size_t i = 0u; i < mNumberOfElements; i++)
+  {
+    buffer[i] = std::move(mBuffer[(mFirst + i) % mSize]);
+  }
+  delete[] mBuffer;
+  mBuffer = buffer;
+  mSize = size;
+  mFirst = 0u;
+}
+
+} // namespace protest
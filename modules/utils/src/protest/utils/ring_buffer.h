@@ -28,6 +28,8 @@
 
 #include <cstddef>
 #include <cstring>
+#include <type_traits>
+#include <utility>
 
 namespace protest
 {
@@ -83,7 +85,14 @@ private:
 template <typename T, size_t N>
 RingBuffer<T, N>::RingBuffer() : mNumberOfElements(0u), mCurrentIndex(0u)
 {
-  memset(mBuffer, 0u, sizeof(T) * N);
+  if constexpr (std::is_trivially_copyable_v<T>)
+  {
+    memset(mBuffer, 0u, sizeof(T) * N);
+  }
+  else
+  {
+    // default constructed by the array
+  }
 }
 
 template <typename T, size_t N>
@@ -113,7 +122,16 @@ RingBuffer<T, N>::pop()
   // than zero. Would be O.K but static code analysation could complane.
   // + N is not a problem because of % N
   PROTEST_ASSERT((((mCurrentIndex + N) - mNumberOfElements) % N) < N);
-  T value = mBuffer[((mCurrentIndex + N) - mNumberOfElements) % N];
+  const size_t index = ((mCurrentIndex + N) - mNumberOfElements) % N;
+  T value = std::move(mBuffer[index]);
+  if constexpr (!std::is_trivially_copyable_v<T>)
+  {
+    // release resources (e.g. a shared payload) held by the popped slot
+    mBuffer[index] = T();
+  }
+  else
+  {
+  }
   mNumberOfElements--;
   return value;
 }
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include "protest/utils/dynamic_heap.h"
+#include "protest/utils/heap.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace protest;
+
+namespace
+{
+
+class HeapElement
+{
+public:
+  HeapElement(int value) : mIndex(0), mValue(value)
+  {
+  }
+
+  bool
+  operator<(HeapElement& other)
+  {
+    return mValue < other.mValue;
+  }
+
+  size_t mIndex;
+  int mValue;
+};
+
+} // namespace
+
+TEST(dynamic_heap, __empty__should_be_empty)
+{
+  DynamicHeap<HeapElement> heap;
+
+  ASSERT_TRUE(heap.isEmpty());
+  ASSERT_FALSE(heap.isAvailable());
+  ASSERT_EQ(0u, heap.capacity());
+}
+
+TEST(dynamic_heap, __empty__should_throw_assert_exception_on_peek)
+{
+  DynamicHeap<HeapElement> heap;
+
+  EXPECT_ANY_THROW(heap.peek());
+}
+
+TEST(dynamic_heap, __empty__should_throw_assert_exception_on_remove)
+{
+  DynamicHeap<HeapElement> heap;
+  HeapElement element(0);
+
+  EXPECT_ANY_THROW(heap.remove(&element));
+}
+
+TEST(dynamic_heap, __available__should_remove_value)
+{
+  DynamicHeap<HeapElement> heap;
+  HeapElement element(0);
+  heap.push(&element);
+
+  heap.remove(&element);
+
+  ASSERT_FALSE(heap.isAvailable());
+}
+
+TEST(dynamic_heap, should_grow_beyond_initial_capacity)
+{
+  static constexpr int numberOfElements = 10000;
+  DynamicHeap<HeapElement> heap;
+  std::vector<HeapElement> elements;
+  elements.reserve(numberOfElements);
+  for (int i = numberOfElements - 1; i >= 0; i--)
+  {
+    elements.emplace_back(i);
+    heap.push(&elements.back());
+  }
+
+  ASSERT_EQ(static_cast<size_t>(numberOfElements), heap.numberOfElements());
+  ASSERT_GE(heap.capacity(), heap.numberOfElements());
+
+  int n = 0;
+  while (heap.isAvailable())
+  {
+    ASSERT_EQ(n, heap.pop()->mValue);
+    n++;
+  }
+  ASSERT_EQ(numberOfElements, n);
+}
+
+TEST(dynamic_heap, should_remove_values_from_the_middle)
+{
+  DynamicHeap<HeapElement> heap;
+  std::vector<HeapElement> elements;
+  elements.reserve(100);
+  for (int i = 0; i < 100; i++)
+  {
+    elements.emplace_back((i * 37) % 100);
+    heap.push(&elements.back());
+  }
+  for (int i = 0; i < 100; i += 3)
+  {
+    heap.remove(&elements[i]);
+  }
+
+  int last = -1;
+  size_t n = 0;
+  while (heap.isAvailable())
+  {
+    HeapElement* value = heap.pop();
+    ASSERT_LT(last, value->mValue);
+    ASSERT_NE(0, (value - elements.data()) % 3);
+    last = value->mValue;
+    n++;
+  }
+  ASSERT_EQ(66u, n);
+}
+
+TEST(dynamic_heap, should_update_increased_values_in_place)
+{
+  DynamicHeap<HeapElement> heap;
+  std::vector<HeapElement> elements;
+  elements.reserve(100);
+  for (int i = 0; i < 100; i++)
+  {
+    elements.emplace_back(i);
+    heap.push(&elements.back());
+  }
+  // move the smallest values behind all others like a periodic job
+  for (int i = 0; i < 10; i++)
+  {
+    HeapElement* value = heap.peek();
+    ASSERT_EQ(i, value->mValue);
+    value->mValue += 100;
+    heap.update(value);
+  }
+  heap.update(&elements[50]);
+
+  int last = 9;
+  while (heap.isAvailable())
+  {
+    HeapElement* value = heap.pop();
+    ASSERT_LT(last, value->mValue);
+    last = value->mValue;
+  }
+  ASSERT_EQ(109, last);
+}
+
+TEST(dynamic_heap, should_pop_equal_values_in_the_same_order_as_heap)
+{
+  static constexpr size_t numberOfElements = 100;
+  Heap<HeapElement, numberOfElements> heap;
+  DynamicHeap<HeapElement> dynamicHeap;
+  std::vector<HeapElement> elements1;
+  std::vector<HeapElement> elements2;
+  elements1.reserve(numberOfElements);
+  elements2.reserve(numberOfElements);
+
+  srand(42);
+  for (size_t i = 0; i < numberOfElements; i++)
+  {
+    const int value = rand() % 10;
+    elements1.emplace_back(value);
+    elements2.emplace_back(value);
+    heap.push(&elements1.back());
+    dynamicHeap.push(&elements2.back());
+  }
+  for (size_t i = 0; i < numberOfElements; i += 7)
+  {
+    heap.remove(&elements1[i]);
+    dynamicHeap.remove(&elements2[i]);
+  }
+
+  while (heap.isAvailable())
+  {
+    ASSERT_TRUE(dynamicHeap.isAvailable());
+    HeapElement* value1 = heap.pop();
+    HeapElement* value2 = dynamicHeap.pop();
+    ASSERT_EQ(value1 - elements1.data(), value2 - elements2.data());
+  }
+  ASSERT_FALSE(dynamicHeap.isAvailable());
+}
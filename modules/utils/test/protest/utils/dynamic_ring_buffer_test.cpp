@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "protest/utils/dynamic_ring_buffer.h"
+
+#include <memory>
+
+using namespace protest;
+
+static constexpr auto capacity = 4u;
+static constexpr int anyValue = 42;
+
+TEST(dynamic_ring_buffer, __bounded__should_keep_sequence)
+{
+  DynamicRingBuffer<int> ringBuffer(capacity);
+
+  ringBuffer.push(1);
+  ringBuffer.push(2);
+  ringBuffer.push(3);
+
+  ASSERT_EQ(ringBuffer.peek(), 1);
+  ASSERT_EQ(ringBuffer.pop(), 1);
+  ASSERT_EQ(ringBuffer.pop(), 2);
+  ASSERT_EQ(ringBuffer.pop(), 3);
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(dynamic_ring_buffer, __full__should_throw_assert_exeception_on_push)
+{
+  DynamicRingBuffer<int> ringBuffer(capacity);
+  for (size_t i = 0; i < capacity; i++)
+  {
+    ringBuffer.push(anyValue);
+  }
+
+  ASSERT_TRUE(ringBuffer.isFull());
+  EXPECT_ANY_THROW(ringBuffer.push(anyValue));
+}
+
+TEST(dynamic_ring_buffer, __full__should_pop_and_push_value)
+{
+  DynamicRingBuffer<int> ringBuffer(capacity);
+  for (size_t i = 0; i < 10 * capacity; i++)
+  {
+    if (ringBuffer.isFull())
+    {
+      ASSERT_EQ(ringBuffer.pop(), static_cast<int>(i - capacity));
+    }
+    else
+    {
+    }
+    ringBuffer.push(static_cast<int>(i));
+  }
+
+  ASSERT_EQ(ringBuffer.numberOfElements(), capacity);
+}
+
+TEST(dynamic_ring_buffer, __empty__should_throw_assert_exeception_on_pop)
+{
+  DynamicRingBuffer<int> ringBuffer(capacity);
+
+  EXPECT_ANY_THROW(ringBuffer.pop());
+  EXPECT_ANY_THROW(ringBuffer.peek());
+}
+
+TEST(dynamic_ring_buffer, __unbounded__should_grow_and_keep_sequence)
+{
+  DynamicRingBuffer<int> ringBuffer(DynamicRingBuffer<int>::unbounded);
+
+  // wrap around before the first growth
+  ringBuffer.push(-1);
+  ASSERT_EQ(ringBuffer.pop(), -1);
+  for (int i = 0; i < 1000; i++)
+  {
+    ringBuffer.push(i);
+  }
+
+  ASSERT_FALSE(ringBuffer.isFull());
+  ASSERT_EQ(ringBuffer.numberOfElements(), 1000u);
+  for (int i = 0; i < 1000; i++)
+  {
+    ASSERT_EQ(ringBuffer.pop(), i);
+  }
+  ASSERT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST(dynamic_ring_buffer, should_release_popped_values)
+{
+  DynamicRingBuffer<std::shared_ptr<int>> ringBuffer(capacity);
+  auto value = std::make_shared<int>(anyValue);
+
+  ringBuffer.push(value);
+  ASSERT_EQ(value.use_count(), 2);
+  ringBuffer.clear();
+
+  ASSERT_EQ(value.use_count(), 1);
+}
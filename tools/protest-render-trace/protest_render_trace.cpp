@@ -0,0 +1,77 @@
+/*
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2022 Janosch Reinking
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to 
+ * deal in the Software without restriction, including without limitation the 
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "protest/log/trace_reader.h"
+
+#include <fstream>
+#include <iostream>
+
+// ---------------------------------------------------------------------------
+/**
+ * Renders a binary trace (see Context::setTrace) to the text log.
+ * 
+ * usage: protest-render-trace <trace> [<log>]
+ * 
+ * The text is written to stdout if no log file is given.
+ */
+int
+main(int argc, char** argv)
+{
+  int exitValue = 0;
+  if (argc != 2 && argc != 3)
+  {
+    std::cerr << "usage: " << argv[0] << " <trace> [<log>]" << std::endl;
+    exitValue = 2;
+  }
+  else
+  {
+    std::ifstream trace(argv[1], std::ios::binary);
+    std::ofstream file;
+    if (argc == 3)
+    {
+      file.open(argv[2]);
+    }
+    else
+    {
+    }
+    std::ostream& output = (argc == 3) ? file : std::cout;
+
+    protest::log::TraceReader reader(trace);
+    if (!trace.is_open() || !output.good())
+    {
+      std::cerr << "cannot open " << argv[trace.is_open() ? 2 : 1]
+                << std::endl;
+      exitValue = 1;
+    }
+    else if (!reader.render(output))
+    {
+      std::cerr << "invalid or truncated trace " << argv[1] << std::endl;
+      exitValue = 1;
+    }
+    else
+    {
+    }
+  }
+  return exitValue;
+}